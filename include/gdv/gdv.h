@@ -14,6 +14,11 @@
 #include <gdv/tools/ft.h>
 #include <gdv/tools/type_list.h>
 #include <gdv/tools/online.h>
+#include <gdv/tools/online_concurrent.h>
+#include <gdv/tools/online_window.h>
+#include <gdv/tools/online_histogram.h>
+#include <gdv/tools/online_sketch.h>
+#include <gdv/tools/parallel.h>
 
 #include <gdv/math/gdv_math.h>
 
@@ -0,0 +1,329 @@
+/**
+* @file affine3.h
+* @brief 3x4のアフィン変換を表現するクラスを定義したファイルです
+**/
+#ifndef GDV_AFFINE3_H_
+#define GDV_AFFINE3_H_
+
+#include <type_traits>
+#include <gdv/math/vector3.h>
+#include <gdv/math/vector4.h>
+#include <gdv/math/matrix3x3.h>
+#include <gdv/math/matrix4x4.h>
+#include <gdv/math/quaternion.h>
+#include <gdv/math/simd.h>
+
+namespace gdv {
+
+/**
+* @class affine3
+* @tparam Ty スカラ型のみ受付ます
+* @brief 最下行が(0, 0, 0, 1)の4x4行列を3x4で保持するアフィン変換です
+* @details 要素は列ベクトル形式 (column_major の matrix4x4 の上3行) で格納します
+*          row_major では同じ値を転置して扱うため、どちらの名前空間でも同じ変換を表します
+*          matrix4x4より16バイト小さく、合成は64回ではなく36回の乗算で済みます
+**/
+template <class Ty>
+class alignas(simd_alignment<Ty>) affine3 {
+    static_assert(std::is_integral<Ty>::value || std::is_floating_point<Ty>::value, "invalid template parameter.");
+
+public:
+
+    constexpr affine3() noexcept :
+        m{}{}
+
+
+    constexpr affine3(Ty m11, Ty m12, Ty m13, Ty m14,
+                      Ty m21, Ty m22, Ty m23, Ty m24,
+                      Ty m31, Ty m32, Ty m33, Ty m34) noexcept :
+                      m { m11, m12, m13, m14,
+                          m21, m22, m23, m24,
+                          m31, m32, m33, m34}{}
+
+
+    /**
+    * @brief 線形部分と移動量から作成します
+    * @param[in] l 線形部分 (列ベクトル形式)
+    * @param[in] t 移動量
+    * @return none
+    * @exception none
+    **/
+    constexpr affine3(const matrix3x3<Ty> &l, const vector3<Ty> &t) noexcept :
+        m { l.m[0], l.m[1], l.m[2], t.x,
+            l.m[3], l.m[4], l.m[5], t.y,
+            l.m[6], l.m[7], l.m[8], t.z}{}
+
+
+    constexpr affine3(const affine3<Ty> &a) noexcept = default;
+
+
+    affine3<Ty>& operator = (const affine3<Ty> &a) noexcept = default;
+
+
+public:
+    Ty m[12];
+};
+
+
+
+
+namespace detail {
+
+// 列ベクトル形式の積 a * b (bを先に適用) を求めます
+template <class Ty>
+affine3<Ty> compose(const affine3<Ty> &a, const affine3<Ty> &b) noexcept {
+    return {
+        a.m[0] * b.m[0] + a.m[1] * b.m[4] + a.m[ 2] * b.m[ 8],
+        a.m[0] * b.m[1] + a.m[1] * b.m[5] + a.m[ 2] * b.m[ 9],
+        a.m[0] * b.m[2] + a.m[1] * b.m[6] + a.m[ 2] * b.m[10],
+        a.m[0] * b.m[3] + a.m[1] * b.m[7] + a.m[ 2] * b.m[11] + a.m[ 3],
+
+        a.m[4] * b.m[0] + a.m[5] * b.m[4] + a.m[ 6] * b.m[ 8],
+        a.m[4] * b.m[1] + a.m[5] * b.m[5] + a.m[ 6] * b.m[ 9],
+        a.m[4] * b.m[2] + a.m[5] * b.m[6] + a.m[ 6] * b.m[10],
+        a.m[4] * b.m[3] + a.m[5] * b.m[7] + a.m[ 6] * b.m[11] + a.m[ 7],
+
+        a.m[8] * b.m[0] + a.m[9] * b.m[4] + a.m[10] * b.m[ 8],
+        a.m[8] * b.m[1] + a.m[9] * b.m[5] + a.m[10] * b.m[ 9],
+        a.m[8] * b.m[2] + a.m[9] * b.m[6] + a.m[10] * b.m[10],
+        a.m[8] * b.m[3] + a.m[9] * b.m[7] + a.m[10] * b.m[11] + a.m[11],
+    };
+}
+
+
+inline affine3<float> compose(const affine3<float> &a, const affine3<float> &b) noexcept {
+    const simd::float4 r0 = simd::load(&b.m[0]);
+    const simd::float4 r1 = simd::load(&b.m[4]);
+    const simd::float4 r2 = simd::load(&b.m[8]);
+    const simd::float4 r3 = simd::set(0.0f, 0.0f, 0.0f, 1.0f);
+    affine3<float> c;
+    for (int i = 0; i < 12; i += 4) {
+        simd::store(&c.m[i], simd::combine(simd::load(&a.m[i]), r0, r1, r2, r3));
+    }
+    return c;
+}
+
+} // namespace detail
+
+
+
+
+/**
+* @brief 恒等変換を作成します
+* @tparam Ty スカラ型のみ受付ます
+* @return affine3<Ty>
+* @exception none
+**/
+template <class Ty>
+affine3<Ty> unit_affine() noexcept {
+    constexpr Ty _0 = static_cast<Ty>(0);
+    constexpr Ty _1 = static_cast<Ty>(1);
+    return {
+        _1, _0, _0, _0,
+        _0, _1, _0, _0,
+        _0, _0, _1, _0,
+    };
+}
+
+
+
+/**
+* @brief 逆変換を求めます
+* @tparam Ty 浮動小数点型のみ受付ます
+* @param[in] a 対象の変換
+* @return affine3<Ty>
+* @exception none
+* @details 線形部分が特異な場合、結果の要素は有限値になりません
+**/
+template <class Ty>
+affine3<Ty> inverse(const affine3<Ty> &a) noexcept {
+    static_assert(std::is_floating_point<Ty>::value, "Template parameters require floating point type.");
+    const Ty c0 = a.m[5] * a.m[10] - a.m[6] * a.m[9];
+    const Ty c1 = a.m[6] * a.m[ 8] - a.m[4] * a.m[10];
+    const Ty c2 = a.m[4] * a.m[ 9] - a.m[5] * a.m[8];
+    const Ty r = static_cast<Ty>(1) / (a.m[0] * c0 + a.m[1] * c1 + a.m[2] * c2);
+    const Ty l[9] = {
+        c0 * r, (a.m[2] * a.m[9] - a.m[1] * a.m[10]) * r, (a.m[1] * a.m[6] - a.m[2] * a.m[5]) * r,
+        c1 * r, (a.m[0] * a.m[10] - a.m[2] * a.m[8]) * r, (a.m[2] * a.m[4] - a.m[0] * a.m[6]) * r,
+        c2 * r, (a.m[1] * a.m[8] - a.m[0] * a.m[9]) * r, (a.m[0] * a.m[5] - a.m[1] * a.m[4]) * r
+    };
+    const Ty x = a.m[3], y = a.m[7], z = a.m[11];
+    return {
+        l[0], l[1], l[2], -(l[0] * x + l[1] * y + l[2] * z),
+        l[3], l[4], l[5], -(l[3] * x + l[4] * y + l[5] * z),
+        l[6], l[7], l[8], -(l[6] * x + l[7] * y + l[8] * z),
+    };
+}
+
+
+
+
+namespace column_major {
+
+/**
+* @brief 4x4行列に変換します
+* @tparam Ty スカラ型のみ受付ます
+* @param[in] a 対象の変換
+* @return matrix4x4<Ty>
+* @exception none
+**/
+template <class Ty>
+matrix4x4<Ty> to_matrix(const affine3<Ty> &a) noexcept {
+    constexpr Ty _0 = static_cast<Ty>(0);
+    constexpr Ty _1 = static_cast<Ty>(1);
+    return {
+        a.m[0], a.m[1], a.m[ 2], a.m[ 3],
+        a.m[4], a.m[5], a.m[ 6], a.m[ 7],
+        a.m[8], a.m[9], a.m[10], a.m[11],
+            _0,     _0,      _0,      _1
+    };
+}
+
+
+
+/**
+* @brief 4x4行列からアフィン変換を取り出します
+* @tparam Ty スカラ型のみ受付ます
+* @param[in] m 最下行が(0, 0, 0, 1)の行列 (translation、scaling、rotate等の結果)
+* @return affine3<Ty>
+* @exception none
+* @details 最下行は無視されます
+**/
+template <class Ty>
+affine3<Ty> to_affine(const matrix4x4<Ty> &m) noexcept {
+    return {
+        m.m[0], m.m[1], m.m[ 2], m.m[ 3],
+        m.m[4], m.m[5], m.m[ 6], m.m[ 7],
+        m.m[8], m.m[9], m.m[10], m.m[11]
+    };
+}
+
+
+
+/**
+* @brief 変換を合成します (a * b はbを適用した後にaを適用します)
+**/
+template <class Ty>
+affine3<Ty> operator * (const affine3<Ty> &a, const affine3<Ty> &b) noexcept {
+    return detail::compose(a, b);
+}
+
+template <class Ty>
+affine3<Ty>& operator *= (affine3<Ty> &a, const affine3<Ty> &b) noexcept {
+    return a = detail::compose(a, b);
+}
+
+
+
+/**
+* @brief 点を変換します
+**/
+template <class Ty>
+vector3<Ty> operator * (const affine3<Ty> &a, const vector3<Ty> &v) noexcept {
+    return {
+        a.m[0] * v.x + a.m[1] * v.y + a.m[ 2] * v.z + a.m[ 3],
+        a.m[4] * v.x + a.m[5] * v.y + a.m[ 6] * v.z + a.m[ 7],
+        a.m[8] * v.x + a.m[9] * v.y + a.m[10] * v.z + a.m[11]
+    };
+}
+
+
+namespace right_hand {
+
+template <class Ty>
+affine3<Ty> to_affine(quaternion<Ty> q) noexcept {
+    return column_major::to_affine(to_matrix(q));
+}
+
+} // namespace right_hand
+
+
+namespace left_hand {
+
+template <class Ty>
+affine3<Ty> to_affine(quaternion<Ty> q) noexcept {
+    return column_major::to_affine(to_matrix(q));
+}
+
+} // namespace left_hand
+} // namespace column_major
+
+
+
+
+namespace row_major {
+
+template <class Ty>
+matrix4x4<Ty> to_matrix(const affine3<Ty> &a) noexcept {
+    constexpr Ty _0 = static_cast<Ty>(0);
+    constexpr Ty _1 = static_cast<Ty>(1);
+    return {
+        a.m[0], a.m[4], a.m[ 8], _0,
+        a.m[1], a.m[5], a.m[ 9], _0,
+        a.m[2], a.m[6], a.m[10], _0,
+        a.m[3], a.m[7], a.m[11], _1
+    };
+}
+
+
+template <class Ty>
+affine3<Ty> to_affine(const matrix4x4<Ty> &m) noexcept {
+    return {
+        m.m[0], m.m[4], m.m[ 8], m.m[12],
+        m.m[1], m.m[5], m.m[ 9], m.m[13],
+        m.m[2], m.m[6], m.m[10], m.m[14]
+    };
+}
+
+
+/**
+* @brief 変換を合成します (a * b はaを適用した後にbを適用します)
+**/
+template <class Ty>
+affine3<Ty> operator * (const affine3<Ty> &a, const affine3<Ty> &b) noexcept {
+    return detail::compose(b, a);
+}
+
+template <class Ty>
+affine3<Ty>& operator *= (affine3<Ty> &a, const affine3<Ty> &b) noexcept {
+    return a = detail::compose(b, a);
+}
+
+
+template <class Ty>
+vector3<Ty> operator * (const vector3<Ty> &v, const affine3<Ty> &a) noexcept {
+    return {
+        a.m[0] * v.x + a.m[1] * v.y + a.m[ 2] * v.z + a.m[ 3],
+        a.m[4] * v.x + a.m[5] * v.y + a.m[ 6] * v.z + a.m[ 7],
+        a.m[8] * v.x + a.m[9] * v.y + a.m[10] * v.z + a.m[11]
+    };
+}
+
+
+namespace right_hand {
+
+template <class Ty>
+affine3<Ty> to_affine(quaternion<Ty> q) noexcept {
+    return row_major::to_affine(to_matrix(q));
+}
+
+} // namespace right_hand
+
+
+namespace left_hand {
+
+template <class Ty>
+affine3<Ty> to_affine(quaternion<Ty> q) noexcept {
+    return row_major::to_affine(to_matrix(q));
+}
+
+} // namespace left_hand
+} // namespace row_major
+
+
+
+using affine = affine3<float>;
+
+} // namespace gdv
+
+#endif
@@ -0,0 +1,323 @@
+/**
+* @file batch_projection.h
+* @brief 大量の点を一括でスクリーン座標へ投影する関数の宣言
+* @details 行列の乗算、wでの除算、ビューポート変換を1回の走査で行い、クリップフラグを出力します
+*          floatはSIMDで4点ずつ処理され、threadsを指定すると並列に処理されます
+**/
+#ifndef GDV_BATCH_PROJECTION_H_
+#define GDV_BATCH_PROJECTION_H_
+
+#include <algorithm>
+#include <stdint.h>
+#include <gdv/math/vector3.h>
+#include <gdv/math/matrix4x4.h>
+#include <gdv/math/math_function.h>
+#include <gdv/math/viewport.h>
+#include <gdv/math/camera.h>
+#include <gdv/math/simd.h>
+#include <gdv/tools/parallel.h>
+
+namespace gdv {
+
+/**
+* @brief クリップ空間で点が視錐台のどの平面の外側にあるかを表すフラグです
+* @details ビットの位置はfrustum::sideと対応します
+*          0の点は視錐台の内側 (-w <= x, y <= w, 0 <= z <= w) にあります
+*          リバースZの投影行列ではnearとfarのフラグが入れ替わります
+**/
+namespace clip {
+enum : uint8_t {
+    left   = 1 << 0, ///< x < -w
+    right  = 1 << 1, ///< x > w
+    bottom = 1 << 2, ///< y < -w
+    top    = 1 << 3, ///< y > w
+    near   = 1 << 4, ///< z < 0
+    far    = 1 << 5  ///< z > w
+};
+} // namespace clip
+
+
+
+
+namespace detail {
+
+/**
+* @brief m * (x, y, z, 1)をwで除算し、ビューポート変換した座標を[first, last)について計算します
+* @details mはcolumn_majorの配置です
+*          vは x, y の拡大率と平行移動量 {sx, sy, tx, ty} です
+*          oz、flagsがnullptrの場合、その出力は行われません
+**/
+template <class Ty>
+void project_soa(const Ty *m, const Ty *v,
+                 const Ty *x, const Ty *y, const Ty *z,
+                 Ty *ox, Ty *oy, Ty *oz, uint8_t *flags,
+                 size_t first, size_t last) noexcept {
+    constexpr Ty _0 = static_cast<Ty>(0);
+    constexpr Ty _1 = static_cast<Ty>(1);
+    for (size_t i = first; i < last; ++i) {
+        const Ty px = x[i], py = y[i], pz = z[i];
+        const Ty cx = m[ 0] * px + m[ 1] * py + m[ 2] * pz + m[ 3];
+        const Ty cy = m[ 4] * px + m[ 5] * py + m[ 6] * pz + m[ 7];
+        const Ty cz = m[ 8] * px + m[ 9] * py + m[10] * pz + m[11];
+        const Ty cw = m[12] * px + m[13] * py + m[14] * pz + m[15];
+        if (flags) {
+            flags[i] = static_cast<uint8_t>((cx < -cw ? clip::left   : 0) | (cw < cx ? clip::right : 0)
+                                          | (cy < -cw ? clip::bottom : 0) | (cw < cy ? clip::top   : 0)
+                                          | (cz < _0  ? clip::near   : 0) | (cw < cz ? clip::far   : 0));
+        }
+        const Ty rw = _1 / cw;
+        ox[i] = cx * rw * v[0] + v[2];
+        oy[i] = cy * rw * v[1] + v[3];
+        if (oz) { oz[i] = cz * rw; }
+    }
+}
+
+
+inline void project_soa(const float *m, const float *v,
+                        const float *x, const float *y, const float *z,
+                        float *ox, float *oy, float *oz, uint8_t *flags,
+                        size_t first, size_t last) noexcept {
+    simd::float4 k[16];
+    for (int j = 0; j < 16; ++j) { k[j] = simd::splat(m[j]); }
+    const simd::float4 sx = simd::splat(v[0]), sy = simd::splat(v[1]);
+    const simd::float4 tx = simd::splat(v[2]), ty = simd::splat(v[3]);
+    const simd::float4 zero = simd::zero(), one = simd::splat(1.0f);
+
+    size_t i = first;
+    for (; i + 4 <= last; i += 4) {
+        const simd::float4 px = simd::loadu(x + i);
+        const simd::float4 py = simd::loadu(y + i);
+        const simd::float4 pz = simd::loadu(z + i);
+        const simd::float4 cx = simd::add(simd::madd(k[ 2], pz, simd::madd(k[ 1], py, simd::mul(k[ 0], px))), k[ 3]);
+        const simd::float4 cy = simd::add(simd::madd(k[ 6], pz, simd::madd(k[ 5], py, simd::mul(k[ 4], px))), k[ 7]);
+        const simd::float4 cz = simd::add(simd::madd(k[10], pz, simd::madd(k[ 9], py, simd::mul(k[ 8], px))), k[11]);
+        const simd::float4 cw = simd::add(simd::madd(k[14], pz, simd::madd(k[13], py, simd::mul(k[12], px))), k[15]);
+        if (flags) {
+            // 各ビットの値を浮動小数点数のまま加算します (2のべき乗の和なので誤差は生じません)
+            const simd::float4 nw = simd::sub(zero, cw);
+            simd::float4 f = simd::select(simd::less(cx, nw), simd::splat(static_cast<float>(clip::left)), zero);
+            f = simd::add(f, simd::select(simd::less(cw, cx), simd::splat(static_cast<float>(clip::right)),  zero));
+            f = simd::add(f, simd::select(simd::less(cy, nw), simd::splat(static_cast<float>(clip::bottom)), zero));
+            f = simd::add(f, simd::select(simd::less(cw, cy), simd::splat(static_cast<float>(clip::top)),    zero));
+            f = simd::add(f, simd::select(simd::less(cz, zero), simd::splat(static_cast<float>(clip::near)), zero));
+            f = simd::add(f, simd::select(simd::less(cw, cz), simd::splat(static_cast<float>(clip::far)),    zero));
+            alignas(16) float b[4];
+            simd::store(b, f);
+            flags[i + 0] = static_cast<uint8_t>(b[0]);
+            flags[i + 1] = static_cast<uint8_t>(b[1]);
+            flags[i + 2] = static_cast<uint8_t>(b[2]);
+            flags[i + 3] = static_cast<uint8_t>(b[3]);
+        }
+        const simd::float4 rw = simd::div(one, cw);
+        simd::storeu(ox + i, simd::madd(simd::mul(cx, rw), sx, tx));
+        simd::storeu(oy + i, simd::madd(simd::mul(cy, rw), sy, ty));
+        if (oz) { simd::storeu(oz + i, simd::mul(cz, rw)); }
+    }
+    detail::project_soa<float>(m, v, x, y, z, ox, oy, oz, flags, i, last);
+}
+
+
+template <class Ty>
+void project_aos(const Ty *m, const Ty *v, const vector3<Ty> *in, vector3<Ty> *out, uint8_t *flags, size_t first, size_t last) noexcept {
+    constexpr size_t block = 64;
+    Ty x[block], y[block], z[block];
+    for (size_t i = first; i < last; i += block) {
+        const size_t count = std::min(block, last - i);
+        for (size_t j = 0; j < count; ++j) {
+            x[j] = in[i + j].x;
+            y[j] = in[i + j].y;
+            z[j] = in[i + j].z;
+        }
+        detail::project_soa(m, v, x, y, z, x, y, z, flags ? flags + i : nullptr, 0, count);
+        for (size_t j = 0; j < count; ++j) {
+            out[i + j] = vector3<Ty>{x[j], y[j], z[j]};
+        }
+    }
+}
+
+
+// to_matrix(viewport)と同じ写像の拡大率と平行移動量
+template <class Ty>
+void viewport_scale(const viewport<Ty> &vp, Ty *v) noexcept {
+    constexpr Ty _2 = static_cast<Ty>(2);
+    v[0] = vp.w / _2;
+    v[1] = vp.h / _2;
+    v[2] = vp.x + vp.w / _2;
+    v[3] = vp.y + vp.h / _2;
+}
+
+} // namespace detail
+
+
+
+
+namespace column_major {
+
+/**
+* @brief SoA配列の点群を m * (x, y, z, 1) で変換し、wで除算してビューポートへ写像します
+* @details 結果は丸め誤差を除き to_matrix(vp) * (m * p / w) と等しくなります
+*          w <= 0 の点の座標は意味を持たないため、flagsで判定してください
+* @param[in]  m        変換行列 (ビュー・射影行列等)
+* @param[in]  vp       ビューポート
+* @param[in]  x, y, z  入力座標の配列
+* @param[out] ox, oy   スクリーン座標の出力先 (入力と同じ配列でも構いません)
+* @param[out] oz       正規化デバイス座標の深度の出力先 (不要な場合はnullptr)
+* @param[out] flags    クリップフラグ (clip::left等の論理和) の出力先 (不要な場合はnullptr)
+* @param[in]  n        点の数
+* @param[in]  threads  スレッド数 (1で呼び出しスレッドのみ、0でハードウェアスレッド数)
+* @return none
+* @exception none
+**/
+template <class Ty>
+void project(const matrix4x4<Ty> &m, const viewport<Ty> &vp,
+             const Ty *x, const Ty *y, const Ty *z,
+             Ty *ox, Ty *oy, Ty *oz, uint8_t *flags,
+             size_t n, size_t threads = 1) {
+    Ty v[4];
+    detail::viewport_scale(vp, v);
+    parallel_for(n, threads, [&](size_t first, size_t last) {
+        detail::project_soa(m.m, v, x, y, z, ox, oy, oz, flags, first, last);
+    }, 4096);
+}
+
+
+/**
+* @brief AoS配列の点群をスクリーン座標へ投影します
+* @param[in]  m       変換行列
+* @param[in]  vp      ビューポート
+* @param[in]  in      入力座標の配列
+* @param[out] out     出力先 (x, yはスクリーン座標、zは正規化デバイス座標の深度)
+* @param[out] flags   クリップフラグの出力先 (不要な場合はnullptr)
+* @param[in]  n       点の数
+* @param[in]  threads スレッド数
+* @return none
+* @exception none
+**/
+template <class Ty>
+void project(const matrix4x4<Ty> &m, const viewport<Ty> &vp,
+             const vector3<Ty> *in, vector3<Ty> *out, uint8_t *flags,
+             size_t n, size_t threads = 1) {
+    Ty v[4];
+    detail::viewport_scale(vp, v);
+    parallel_for(n, threads, [&](size_t first, size_t last) {
+        detail::project_aos(m.m, v, in, out, flags, first, last);
+    }, 4096);
+}
+
+
+namespace right_hand {
+
+/**
+* @brief カメラのビュー・射影行列で点群をスクリーン座標へ投影します
+* @details 引数はcolumn_major::projectと同じです
+**/
+template <class Ty>
+void project(const camera<Ty> &c, const viewport<Ty> &vp,
+             const Ty *x, const Ty *y, const Ty *z,
+             Ty *ox, Ty *oy, Ty *oz, uint8_t *flags,
+             size_t n, size_t threads = 1) {
+    column_major::project(to_matrix(c), vp, x, y, z, ox, oy, oz, flags, n, threads);
+}
+
+
+template <class Ty>
+void project(const camera<Ty> &c, const viewport<Ty> &vp,
+             const vector3<Ty> *in, vector3<Ty> *out, uint8_t *flags,
+             size_t n, size_t threads = 1) {
+    column_major::project(to_matrix(c), vp, in, out, flags, n, threads);
+}
+
+} // namespace right_hand
+
+
+namespace left_hand {
+
+template <class Ty>
+void project(const camera<Ty> &c, const viewport<Ty> &vp,
+             const Ty *x, const Ty *y, const Ty *z,
+             Ty *ox, Ty *oy, Ty *oz, uint8_t *flags,
+             size_t n, size_t threads = 1) {
+    column_major::project(to_matrix(c), vp, x, y, z, ox, oy, oz, flags, n, threads);
+}
+
+
+template <class Ty>
+void project(const camera<Ty> &c, const viewport<Ty> &vp,
+             const vector3<Ty> *in, vector3<Ty> *out, uint8_t *flags,
+             size_t n, size_t threads = 1) {
+    column_major::project(to_matrix(c), vp, in, out, flags, n, threads);
+}
+
+} // namespace left_hand
+} // namespace column_major
+
+
+
+
+namespace row_major {
+
+/**
+* @brief SoA配列の点群を (x, y, z, 1) * m で変換し、wで除算してビューポートへ写像します
+* @details 引数はcolumn_major::projectと同じです
+**/
+template <class Ty>
+void project(const matrix4x4<Ty> &m, const viewport<Ty> &vp,
+             const Ty *x, const Ty *y, const Ty *z,
+             Ty *ox, Ty *oy, Ty *oz, uint8_t *flags,
+             size_t n, size_t threads = 1) {
+    column_major::project(transpose(m), vp, x, y, z, ox, oy, oz, flags, n, threads);
+}
+
+
+template <class Ty>
+void project(const matrix4x4<Ty> &m, const viewport<Ty> &vp,
+             const vector3<Ty> *in, vector3<Ty> *out, uint8_t *flags,
+             size_t n, size_t threads = 1) {
+    column_major::project(transpose(m), vp, in, out, flags, n, threads);
+}
+
+
+namespace right_hand {
+
+template <class Ty>
+void project(const camera<Ty> &c, const viewport<Ty> &vp,
+             const Ty *x, const Ty *y, const Ty *z,
+             Ty *ox, Ty *oy, Ty *oz, uint8_t *flags,
+             size_t n, size_t threads = 1) {
+    row_major::project(to_matrix(c), vp, x, y, z, ox, oy, oz, flags, n, threads);
+}
+
+
+template <class Ty>
+void project(const camera<Ty> &c, const viewport<Ty> &vp,
+             const vector3<Ty> *in, vector3<Ty> *out, uint8_t *flags,
+             size_t n, size_t threads = 1) {
+    row_major::project(to_matrix(c), vp, in, out, flags, n, threads);
+}
+
+} // namespace right_hand
+
+
+namespace left_hand {
+
+template <class Ty>
+void project(const camera<Ty> &c, const viewport<Ty> &vp,
+             const Ty *x, const Ty *y, const Ty *z,
+             Ty *ox, Ty *oy, Ty *oz, uint8_t *flags,
+             size_t n, size_t threads = 1) {
+    row_major::project(to_matrix(c), vp, x, y, z, ox, oy, oz, flags, n, threads);
+}
+
+
+template <class Ty>
+void project(const camera<Ty> &c, const viewport<Ty> &vp,
+             const vector3<Ty> *in, vector3<Ty> *out, uint8_t *flags,
+             size_t n, size_t threads = 1) {
+    row_major::project(to_matrix(c), vp, in, out, flags, n, threads);
+}
+
+} // namespace left_hand
+} // namespace row_major
+} // namespace gdv
+
+#endif
@@ -0,0 +1,487 @@
+/**
+* @file batch_quaternion.h
+* @brief SoA配列のクォータニオンを一括で補間、行列と相互変換する関数の宣言
+* @details t, x, y, zを個別の配列で保持し、floatはSIMDで4要素ずつ処理します
+*          threadsを指定すると並列に処理されます
+**/
+#ifndef GDV_BATCH_QUATERNION_H_
+#define GDV_BATCH_QUATERNION_H_
+
+#include <type_traits>
+#include <gdv/math/matrix4x4.h>
+#include <gdv/math/quaternion.h>
+#include <gdv/math/simd.h>
+#include <gdv/tools/parallel.h>
+
+namespace gdv {
+
+/**
+* @class quaternion_soa
+* @tparam Ty 浮動小数点型 (入力にはconst付きの型を使います)
+* @brief t, x, y, zの配列の組を参照します
+* @details 配列の所有権は持ちません。要素数は各関数に渡します
+**/
+template <class Ty>
+struct quaternion_soa {
+    using value_type = typename std::remove_const<Ty>::type;
+    using const_type = quaternion_soa<const value_type>;
+
+    quaternion_soa() noexcept :
+        t{}, x{}, y{}, z{} {}
+
+    quaternion_soa(Ty *t, Ty *x, Ty *y, Ty *z) noexcept :
+        t{t}, x{x}, y{y}, z{z} {}
+
+    template <class U, class = typename std::enable_if<!std::is_same<U, Ty>::value && std::is_same<const U, Ty>::value>::type>
+    quaternion_soa(const quaternion_soa<U> &q) noexcept :
+        t{q.t}, x{q.x}, y{q.y}, z{q.z} {}
+
+    quaternion<value_type> get(size_t i) const noexcept {return {t[i], x[i], y[i], z[i]};}
+
+    void set(size_t i, quaternion<value_type> q) const noexcept {
+        t[i] = q.t;
+        x[i] = q.x;
+        y[i] = q.y;
+        z[i] = q.z;
+    }
+
+    Ty *t;
+    Ty *x;
+    Ty *y;
+    Ty *z;
+};
+
+
+
+
+namespace detail {
+
+enum class interpolation : int {
+    linear,
+    spherical,
+    approximate,
+};
+
+
+template <class Ty>
+quaternion<Ty> interpolate(interpolation mode, quaternion<Ty> q1, quaternion<Ty> q2, Ty t) noexcept {
+    switch (mode) {
+    case interpolation::linear:    return nlerp(q1, q2, t);
+    case interpolation::spherical: return slerp(q1, q2, t);
+    default:                       return fast_slerp(q1, q2, t);
+    }
+}
+
+
+/**
+* @brief [first, last)の要素を補間します
+* @details 補間係数はs[i * step]です (stepが0の場合は全要素で共通)
+**/
+template <class Ty>
+void interpolate_soa(interpolation mode,
+                     quaternion_soa<const Ty> a, quaternion_soa<const Ty> b,
+                     const Ty *s, size_t step, quaternion_soa<Ty> out,
+                     size_t first, size_t last) noexcept {
+    for (size_t i = first; i < last; ++i) {
+        out.set(i, interpolate(mode, a.get(i), b.get(i), s[i * step]));
+    }
+}
+
+
+inline void interpolate_soa(interpolation mode,
+                            quaternion_soa<const float> a, quaternion_soa<const float> b,
+                            const float *s, size_t step, quaternion_soa<float> out,
+                            size_t first, size_t last) noexcept {
+    const simd::float4 one = simd::splat(1.0f);
+    const simd::float4 half = simd::splat(0.5f);
+    alignas(16) float c[4], w1[4], w2[4];
+
+    size_t i = first;
+    for (; i + 4 <= last; i += 4) {
+        const simd::float4 at = simd::loadu(a.t + i), ax = simd::loadu(a.x + i);
+        const simd::float4 ay = simd::loadu(a.y + i), az = simd::loadu(a.z + i);
+        const simd::float4 bt = simd::loadu(b.t + i), bx = simd::loadu(b.x + i);
+        const simd::float4 by = simd::loadu(b.y + i), bz = simd::loadu(b.z + i);
+        const simd::float4 t = step ? simd::loadu(s + i) : simd::splat(*s);
+        const simd::float4 d = simd::madd(az, bz, simd::madd(ay, by, simd::madd(ax, bx, simd::mul(at, bt))));
+
+        simd::float4 u1, u2;
+        if (mode == interpolation::linear) {
+            u1 = simd::sub(one, t);
+            u2 = t;
+        } else if (mode == interpolation::approximate) {
+            // fast_slerp()と同じ多項式で補間係数を補正します
+            const simd::float4 e = simd::abs(d);
+            simd::float4 p = simd::sub(simd::splat(3.55645f), simd::mul(e, simd::splat(1.43519f)));
+            p = simd::madd(e, simd::madd(e, p, simd::splat(-3.2452f)), simd::splat(1.0904f));
+            simd::float4 q = simd::madd(e, simd::splat(0.215638f), simd::splat(-1.06021f));
+            q = simd::madd(e, q, simd::splat(0.848013f));
+            const simd::float4 h = simd::sub(t, half);
+            const simd::float4 k = simd::madd(simd::mul(p, h), h, q);
+            u2 = simd::madd(simd::mul(simd::mul(t, h), simd::sub(t, one)), k, t);
+            u1 = simd::sub(one, u2);
+        } else {
+            // 三角関数はレーンごとに計算します
+            simd::store(c, simd::abs(d));
+            simd::store(w2, t);
+            for (int k = 0; k < 4; ++k) {
+                w1[k] = 1.0f - w2[k];
+                if (c[k] < 0.9995f) {
+                    const float g = std::acos(c[k]);
+                    const float r = 1.0f / std::sin(g);
+                    w1[k] = std::sin(w1[k] * g) * r;
+                    w2[k] = std::sin(w2[k] * g) * r;
+                }
+            }
+            u1 = simd::load(w1);
+            u2 = simd::load(w2);
+        }
+        u2 = simd::mul(u2, simd::copysign(one, d));
+
+        const simd::float4 rt = simd::madd(bt, u2, simd::mul(at, u1));
+        const simd::float4 rx = simd::madd(bx, u2, simd::mul(ax, u1));
+        const simd::float4 ry = simd::madd(by, u2, simd::mul(ay, u1));
+        const simd::float4 rz = simd::madd(bz, u2, simd::mul(az, u1));
+        const simd::float4 l = simd::madd(rz, rz, simd::madd(ry, ry, simd::madd(rx, rx, simd::mul(rt, rt))));
+        const simd::float4 r = simd::div(one, simd::sqrt(l));
+        simd::storeu(out.t + i, simd::mul(rt, r));
+        simd::storeu(out.x + i, simd::mul(rx, r));
+        simd::storeu(out.y + i, simd::mul(ry, r));
+        simd::storeu(out.z + i, simd::mul(rz, r));
+    }
+    interpolate_soa<float>(mode, a, b, s, step, out, i, last);
+}
+
+
+template <class Ty>
+void interpolate_batch(interpolation mode,
+                       quaternion_soa<const Ty> a, quaternion_soa<const Ty> b,
+                       const Ty *s, size_t step, quaternion_soa<Ty> out,
+                       size_t n, size_t threads) {
+    parallel_for(n, threads, [=](size_t first, size_t last) {
+        interpolate_soa(mode, a, b, s, step, out, first, last);
+    }, 4096);
+}
+
+} // namespace detail
+
+
+
+
+/**
+* @brief SoA配列のクォータニオンをnlerpで一括補間します
+* @param[in]  a       始点の配列
+* @param[in]  b       終点の配列
+* @param[in]  t       補間係数 (全要素で共通)
+* @param[out] out     結果の配列 (a、bと同じ配列でも構いません)
+* @param[in]  n       要素数
+* @param[in]  threads スレッド数 (1で呼び出しスレッドのみ、0でハードウェアスレッド数)
+* @return none
+* @exception none
+**/
+template <class Ty>
+void nlerp(typename quaternion_soa<Ty>::const_type a, typename quaternion_soa<Ty>::const_type b,
+           typename quaternion_soa<Ty>::value_type t, quaternion_soa<Ty> out, size_t n, size_t threads = 1) {
+    detail::interpolate_batch<Ty>(detail::interpolation::linear, a, b, &t, 0, out, n, threads);
+}
+
+
+/**
+* @brief 要素ごとの補間係数でnlerpします
+* @param[in] t 補間係数の配列
+**/
+template <class Ty>
+void nlerp(typename quaternion_soa<Ty>::const_type a, typename quaternion_soa<Ty>::const_type b,
+           const typename quaternion_soa<Ty>::value_type *t, quaternion_soa<Ty> out, size_t n, size_t threads = 1) {
+    detail::interpolate_batch<Ty>(detail::interpolation::linear, a, b, t, 1, out, n, threads);
+}
+
+
+
+/**
+* @brief SoA配列のクォータニオンをslerpで一括補間します
+* @details 三角関数は要素ごとにスカラで計算し、内積と合成をSIMDで行います
+**/
+template <class Ty>
+void slerp(typename quaternion_soa<Ty>::const_type a, typename quaternion_soa<Ty>::const_type b,
+           typename quaternion_soa<Ty>::value_type t, quaternion_soa<Ty> out, size_t n, size_t threads = 1) {
+    detail::interpolate_batch<Ty>(detail::interpolation::spherical, a, b, &t, 0, out, n, threads);
+}
+
+
+template <class Ty>
+void slerp(typename quaternion_soa<Ty>::const_type a, typename quaternion_soa<Ty>::const_type b,
+           const typename quaternion_soa<Ty>::value_type *t, quaternion_soa<Ty> out, size_t n, size_t threads = 1) {
+    detail::interpolate_batch<Ty>(detail::interpolation::spherical, a, b, t, 1, out, n, threads);
+}
+
+
+
+/**
+* @brief SoA配列のクォータニオンをfast_slerpで一括補間します
+* @details 全ての計算をSIMDで行います
+**/
+template <class Ty>
+void fast_slerp(typename quaternion_soa<Ty>::const_type a, typename quaternion_soa<Ty>::const_type b,
+                typename quaternion_soa<Ty>::value_type t, quaternion_soa<Ty> out, size_t n, size_t threads = 1) {
+    detail::interpolate_batch<Ty>(detail::interpolation::approximate, a, b, &t, 0, out, n, threads);
+}
+
+
+template <class Ty>
+void fast_slerp(typename quaternion_soa<Ty>::const_type a, typename quaternion_soa<Ty>::const_type b,
+                const typename quaternion_soa<Ty>::value_type *t, quaternion_soa<Ty> out, size_t n, size_t threads = 1) {
+    detail::interpolate_batch<Ty>(detail::interpolation::approximate, a, b, t, 1, out, n, threads);
+}
+
+
+
+
+namespace detail {
+
+/**
+* @brief [first, last)のクォータニオンを回転行列に変換します
+* @details transposedがfalseの場合はcolumn_major::left_hand、trueの場合はcolumn_major::right_handの
+*          to_matrix()と同じ行列になります (row_majorは右手系と左手系が逆になります)
+**/
+template <class Ty>
+void to_matrix_soa(bool transposed, quaternion_soa<const Ty> q, matrix4x4<Ty> *out, size_t first, size_t last) noexcept {
+    for (size_t i = first; i < last; ++i) {
+        out[i] = transposed ? column_major::right_hand::to_matrix(q.get(i)) : column_major::left_hand::to_matrix(q.get(i));
+    }
+}
+
+
+template <bool Transposed>
+void to_matrix_simd(quaternion_soa<const float> q, matrix4x4<float> *out, size_t first, size_t last) noexcept {
+    const simd::float4 one = simd::splat(1.0f);
+    const simd::float4 two = simd::splat(2.0f);
+    const simd::float4 zero = simd::zero();
+    const simd::float4 w = simd::set(0.0f, 0.0f, 0.0f, 1.0f);
+
+    for (size_t i = first; i + 4 <= last; i += 4) {
+        const simd::float4 t = simd::loadu(q.t + i), x = simd::loadu(q.x + i);
+        const simd::float4 y = simd::loadu(q.y + i), z = simd::loadu(q.z + i);
+        const simd::float4 t2 = simd::mul(two, t), x2 = simd::mul(two, x);
+        const simd::float4 y2 = simd::mul(two, y), z2 = simd::mul(two, z);
+        const simd::float4 xy = simd::mul(x2, y), tz = simd::mul(t2, z);
+        const simd::float4 xz = simd::mul(x2, z), ty = simd::mul(t2, y);
+        const simd::float4 yz = simd::mul(y2, z), tx = simd::mul(t2, x);
+        const simd::float4 xx = simd::sub(one, simd::mul(x2, x));
+
+        // 転置しない場合の各行 (v' = R * v の形式)
+        simd::float4 r00 = simd::sub(simd::sub(one, simd::mul(y2, y)), simd::mul(z2, z));
+        simd::float4 r01 = Transposed ? simd::add(xy, tz) : simd::sub(xy, tz);
+        simd::float4 r02 = Transposed ? simd::sub(xz, ty) : simd::add(xz, ty);
+        simd::float4 r10 = Transposed ? simd::sub(xy, tz) : simd::add(xy, tz);
+        simd::float4 r11 = simd::sub(xx, simd::mul(z2, z));
+        simd::float4 r12 = Transposed ? simd::add(yz, tx) : simd::sub(yz, tx);
+        simd::float4 r20 = Transposed ? simd::add(xz, ty) : simd::sub(xz, ty);
+        simd::float4 r21 = Transposed ? simd::sub(yz, tx) : simd::add(yz, tx);
+        simd::float4 r22 = simd::sub(xx, simd::mul(y2, y));
+        simd::float4 r03 = zero, r13 = zero, r23 = zero;
+
+        simd::transpose(r00, r01, r02, r03);
+        simd::transpose(r10, r11, r12, r13);
+        simd::transpose(r20, r21, r22, r23);
+        float *m0 = out[i].m, *m1 = out[i + 1].m, *m2 = out[i + 2].m, *m3 = out[i + 3].m;
+        simd::store(m0, r00); simd::store(m0 + 4, r10); simd::store(m0 + 8, r20); simd::store(m0 + 12, w);
+        simd::store(m1, r01); simd::store(m1 + 4, r11); simd::store(m1 + 8, r21); simd::store(m1 + 12, w);
+        simd::store(m2, r02); simd::store(m2 + 4, r12); simd::store(m2 + 8, r22); simd::store(m2 + 12, w);
+        simd::store(m3, r03); simd::store(m3 + 4, r13); simd::store(m3 + 8, r23); simd::store(m3 + 12, w);
+    }
+}
+
+
+inline void to_matrix_soa(bool transposed, quaternion_soa<const float> q, matrix4x4<float> *out, size_t first, size_t last) noexcept {
+    const size_t simd_last = first + (last - first) / 4 * 4;
+    if (transposed) {
+        to_matrix_simd<true>(q, out, first, simd_last);
+    } else {
+        to_matrix_simd<false>(q, out, first, simd_last);
+    }
+    to_matrix_soa<float>(transposed, q, out, simd_last, last);
+}
+
+
+
+/**
+* @brief [first, last)の回転行列をクォータニオンに変換します
+**/
+template <class Ty>
+void to_quaternion_soa(bool transposed, const matrix4x4<Ty> *in, quaternion_soa<Ty> out, size_t first, size_t last) noexcept {
+    for (size_t i = first; i < last; ++i) {
+        out.set(i, transposed ? column_major::right_hand::to_quaternion(in[i]) : column_major::left_hand::to_quaternion(in[i]));
+    }
+}
+
+
+// detail::to_quaternion()の4通りの場合分けをすべて計算し、レーンごとに選択します
+template <bool Transposed>
+void to_quaternion_simd(const matrix4x4<float> *in, quaternion_soa<float> out, size_t first, size_t last) noexcept {
+    const simd::float4 zero = simd::zero();
+    const simd::float4 one = simd::splat(1.0f);
+    const simd::float4 half = simd::splat(0.5f);
+
+    for (size_t i = first; i + 4 <= last; i += 4) {
+        const float *a = in[i].m, *b = in[i + 1].m, *c = in[i + 2].m, *d = in[i + 3].m;
+        simd::float4 a0 = simd::load(a), b0 = simd::load(b), c0 = simd::load(c), d0 = simd::load(d);
+        simd::float4 a1 = simd::load(a + 4), b1 = simd::load(b + 4), c1 = simd::load(c + 4), d1 = simd::load(d + 4);
+        simd::float4 a2 = simd::load(a + 8), b2 = simd::load(b + 8), c2 = simd::load(c + 8), d2 = simd::load(d + 8);
+        simd::transpose(a0, b0, c0, d0);
+        simd::transpose(a1, b1, c1, d1);
+        simd::transpose(a2, b2, c2, d2);
+        const simd::float4 m00 = a0, m01 = Transposed ? a1 : b0, m02 = Transposed ? a2 : c0;
+        const simd::float4 m10 = Transposed ? b0 : a1, m11 = b1, m12 = Transposed ? b2 : c1;
+        const simd::float4 m20 = Transposed ? c0 : a2, m21 = Transposed ? c1 : b2, m22 = c2;
+
+        const simd::float4 tr = simd::add(simd::add(m00, m11), m22);
+        const simd::mask4 ct = simd::less(zero, tr);
+        const simd::mask4 cyz = simd::less(m00, simd::max(m11, m22));
+        const simd::mask4 cz = simd::less(m11, m22);
+        auto pick = [&](simd::float4 vt, simd::float4 vx, simd::float4 vy, simd::float4 vz) {
+            return simd::select(ct, vt, simd::select(cyz, simd::select(cz, vz, vy), vx));
+        };
+
+        const simd::float4 r = simd::sqrt(pick(
+            simd::add(one, tr),
+            simd::sub(simd::sub(simd::add(one, m00), m11), m22),
+            simd::sub(simd::add(simd::sub(one, m00), m11), m22),
+            simd::add(simd::sub(simd::sub(one, m00), m11), m22)));
+        const simd::float4 f = simd::div(half, r);
+        const simd::float4 big = simd::mul(half, r);
+        const simd::float4 e0 = simd::mul(simd::sub(m21, m12), f);
+        const simd::float4 e1 = simd::mul(simd::sub(m02, m20), f);
+        const simd::float4 e2 = simd::mul(simd::sub(m10, m01), f);
+        const simd::float4 p01 = simd::mul(simd::add(m01, m10), f);
+        const simd::float4 p02 = simd::mul(simd::add(m02, m20), f);
+        const simd::float4 p12 = simd::mul(simd::add(m12, m21), f);
+
+        simd::storeu(out.t + i, pick(big, e0, e1, e2));
+        simd::storeu(out.x + i, pick(e0, big, p01, p02));
+        simd::storeu(out.y + i, pick(e1, p01, big, p12));
+        simd::storeu(out.z + i, pick(e2, p02, p12, big));
+    }
+}
+
+
+inline void to_quaternion_soa(bool transposed, const matrix4x4<float> *in, quaternion_soa<float> out, size_t first, size_t last) noexcept {
+    const size_t simd_last = first + (last - first) / 4 * 4;
+    if (transposed) {
+        to_quaternion_simd<true>(in, out, first, simd_last);
+    } else {
+        to_quaternion_simd<false>(in, out, first, simd_last);
+    }
+    to_quaternion_soa<float>(transposed, in, out, simd_last, last);
+}
+
+
+template <class Ty>
+void to_matrix_batch(bool transposed, quaternion_soa<const Ty> q, matrix4x4<Ty> *out, size_t n, size_t threads) {
+    parallel_for(n, threads, [=](size_t first, size_t last) {
+        to_matrix_soa(transposed, q, out, first, last);
+    }, 4096);
+}
+
+
+template <class Ty>
+void to_quaternion_batch(bool transposed, const matrix4x4<Ty> *in, quaternion_soa<Ty> out, size_t n, size_t threads) {
+    parallel_for(n, threads, [=](size_t first, size_t last) {
+        to_quaternion_soa(transposed, in, out, first, last);
+    }, 4096);
+}
+
+} // namespace detail
+
+
+
+
+namespace column_major {
+namespace right_hand {
+
+/**
+* @brief SoA配列のクォータニオンを一括で回転行列に変換します
+* @param[in]  q       クォータニオンの配列
+* @param[out] out     回転行列の配列
+* @param[in]  n       要素数
+* @param[in]  threads スレッド数 (1で呼び出しスレッドのみ、0でハードウェアスレッド数)
+* @return none
+* @exception none
+**/
+template <class Ty>
+void to_matrix(typename quaternion_soa<Ty>::const_type q, matrix4x4<Ty> *out, size_t n, size_t threads = 1) {
+    detail::to_matrix_batch<Ty>(true, q, out, n, threads);
+}
+
+
+/**
+* @brief 回転行列の配列を一括でSoA配列のクォータニオンに変換します
+* @param[in]  in      回転行列の配列
+* @param[out] out     クォータニオンの配列
+* @param[in]  n       要素数
+* @param[in]  threads スレッド数
+* @return none
+* @exception none
+**/
+template <class Ty>
+void to_quaternion(const matrix4x4<Ty> *in, quaternion_soa<Ty> out, size_t n, size_t threads = 1) {
+    detail::to_quaternion_batch<Ty>(true, in, out, n, threads);
+}
+
+} // namespace right_hand
+
+
+namespace left_hand {
+
+template <class Ty>
+void to_matrix(typename quaternion_soa<Ty>::const_type q, matrix4x4<Ty> *out, size_t n, size_t threads = 1) {
+    detail::to_matrix_batch<Ty>(false, q, out, n, threads);
+}
+
+
+template <class Ty>
+void to_quaternion(const matrix4x4<Ty> *in, quaternion_soa<Ty> out, size_t n, size_t threads = 1) {
+    detail::to_quaternion_batch<Ty>(false, in, out, n, threads);
+}
+
+} // namespace left_hand
+} // namespace column_major
+
+
+
+
+namespace row_major {
+namespace right_hand {
+
+template <class Ty>
+void to_matrix(typename quaternion_soa<Ty>::const_type q, matrix4x4<Ty> *out, size_t n, size_t threads = 1) {
+    detail::to_matrix_batch<Ty>(false, q, out, n, threads);
+}
+
+
+template <class Ty>
+void to_quaternion(const matrix4x4<Ty> *in, quaternion_soa<Ty> out, size_t n, size_t threads = 1) {
+    detail::to_quaternion_batch<Ty>(false, in, out, n, threads);
+}
+
+} // namespace right_hand
+
+
+namespace left_hand {
+
+template <class Ty>
+void to_matrix(typename quaternion_soa<Ty>::const_type q, matrix4x4<Ty> *out, size_t n, size_t threads = 1) {
+    detail::to_matrix_batch<Ty>(true, q, out, n, threads);
+}
+
+
+template <class Ty>
+void to_quaternion(const matrix4x4<Ty> *in, quaternion_soa<Ty> out, size_t n, size_t threads = 1) {
+    detail::to_quaternion_batch<Ty>(true, in, out, n, threads);
+}
+
+} // namespace left_hand
+} // namespace row_major
+} // namespace gdv
+
+#endif
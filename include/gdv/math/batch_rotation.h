@@ -0,0 +1,334 @@
+/**
+* @file batch_rotation.h
+* @brief 角度の配列から正弦・余弦、回転行列、回転クォータニオンを一括で生成する関数の宣言
+* @details 正弦と余弦は1回の範囲縮約でまとめて求めます
+*          テンプレート引数 Math の既定値はfast_mathで、floatはSIMDで4要素ずつ計算されます
+*          std_mathを指定するとrotate_x等の単体の関数と同じ結果になります
+**/
+#ifndef GDV_BATCH_ROTATION_H_
+#define GDV_BATCH_ROTATION_H_
+
+#include <gdv/math/vector3.h>
+#include <gdv/math/matrix4x4.h>
+#include <gdv/math/quaternion.h>
+#include <gdv/math/batch_quaternion.h>
+#include <gdv/math/fast_math.h>
+#include <gdv/math/simd.h>
+#include <gdv/tools/parallel.h>
+
+namespace gdv {
+namespace detail {
+
+/**
+* @brief [first, last)の各iについて sincos(angle[i] * scale) を求め、fn(i, s, c)を呼び出します
+**/
+template <class Math, class Ty, class Function>
+void sincos_each(Math, const Ty *angle, Ty scale, size_t first, size_t last, Function fn) noexcept {
+    for (size_t i = first; i < last; ++i) {
+        Ty s, c;
+        Math::sincos(angle[i] * scale, s, c);
+        fn(i, s, c);
+    }
+}
+
+
+template <class Function>
+void sincos_each(fast_math, const float *angle, float scale, size_t first, size_t last, Function fn) noexcept {
+    const simd::float4 k = simd::splat(scale);
+    alignas(16) float s[4], c[4];
+    size_t i = first;
+    for (; i + 4 <= last; i += 4) {
+        simd::float4 vs, vc;
+        fast::sincos(simd::mul(simd::loadu(angle + i), k), vs, vc);
+        simd::store(s, vs);
+        simd::store(c, vc);
+        fn(i + 0, s[0], c[0]);
+        fn(i + 1, s[1], c[1]);
+        fn(i + 2, s[2], c[2]);
+        fn(i + 3, s[3], c[3]);
+    }
+    for (; i < last; ++i) {
+        float s0, c0;
+        fast::sincos(angle[i] * scale, s0, c0);
+        fn(i, s0, c0);
+    }
+}
+
+
+template <class Math, class Ty>
+void sincos_range(const Ty *angle, Ty *s, Ty *c, size_t first, size_t last) noexcept {
+    detail::sincos_each(Math{}, angle, static_cast<Ty>(1), first, last, [=](size_t i, Ty si, Ty ci) {
+        s[i] = si;
+        c[i] = ci;
+    });
+}
+
+
+template <>
+inline void sincos_range<fast_math, float>(const float *angle, float *s, float *c, size_t first, size_t last) noexcept {
+    size_t i = first;
+    for (; i + 4 <= last; i += 4) {
+        simd::float4 vs, vc;
+        fast::sincos(simd::loadu(angle + i), vs, vc);
+        simd::storeu(s + i, vs);
+        simd::storeu(c + i, vc);
+    }
+    for (; i < last; ++i) {
+        fast::sincos(angle[i], s[i], c[i]);
+    }
+}
+
+
+// column_majorのrotate_x等と同じ配置の回転行列 (Transposedならrow_majorの配置)
+template <bool Transposed, class Ty>
+matrix4x4<Ty> rotation_x(Ty s, Ty c) noexcept {
+    constexpr Ty _0 = static_cast<Ty>(0);
+    constexpr Ty _1 = static_cast<Ty>(1);
+    s = Transposed ? -s : s;
+    return {
+        _1, _0, _0, _0,
+        _0,  c, -s, _0,
+        _0,  s,  c, _0,
+        _0, _0, _0, _1
+    };
+}
+
+
+template <bool Transposed, class Ty>
+matrix4x4<Ty> rotation_y(Ty s, Ty c) noexcept {
+    constexpr Ty _0 = static_cast<Ty>(0);
+    constexpr Ty _1 = static_cast<Ty>(1);
+    s = Transposed ? -s : s;
+    return {
+         c, _0,  s, _0,
+        _0, _1, _0, _0,
+        -s, _0,  c, _0,
+        _0, _0, _0, _1
+    };
+}
+
+
+template <bool Transposed, class Ty>
+matrix4x4<Ty> rotation_z(Ty s, Ty c) noexcept {
+    constexpr Ty _0 = static_cast<Ty>(0);
+    constexpr Ty _1 = static_cast<Ty>(1);
+    s = Transposed ? -s : s;
+    return {
+         c, -s, _0, _0,
+         s,  c, _0, _0,
+        _0, _0, _1, _0,
+        _0, _0, _0, _1
+    };
+}
+
+
+// axisは正規化済みであること
+template <bool Transposed, class Ty>
+matrix4x4<Ty> rotation(const vector3<Ty> &axis, Ty s, Ty c) noexcept {
+    constexpr Ty _0 = static_cast<Ty>(0);
+    constexpr Ty _1 = static_cast<Ty>(1);
+    s = Transposed ? -s : s;
+    const Ty x = axis.x;
+    const Ty y = axis.y;
+    const Ty z = axis.z;
+    const Ty ic = _1 - c;
+    return {
+        x * x * ic + c,     x * y * ic + z * s, x * z * ic - y * s, _0,
+        x * y * ic - z * s, y * y * ic + c,     y * z * ic + x * s, _0,
+        x * z * ic + y * s, y * z * ic - x * s, z * z * ic + c,     _0,
+                        _0,                 _0,                 _0, _1
+    };
+}
+
+
+template <bool Transposed, class Math, class Ty>
+void rotate_batch(int axis, const Ty *angle, matrix4x4<Ty> *out, size_t n, size_t threads) {
+    parallel_for(n, threads, [=](size_t first, size_t last) {
+        switch (axis) {
+        case 0:
+            detail::sincos_each(Math{}, angle, static_cast<Ty>(1), first, last, [=](size_t i, Ty s, Ty c) {
+                out[i] = detail::rotation_x<Transposed>(s, c);
+            });
+            break;
+        case 1:
+            detail::sincos_each(Math{}, angle, static_cast<Ty>(1), first, last, [=](size_t i, Ty s, Ty c) {
+                out[i] = detail::rotation_y<Transposed>(s, c);
+            });
+            break;
+        default:
+            detail::sincos_each(Math{}, angle, static_cast<Ty>(1), first, last, [=](size_t i, Ty s, Ty c) {
+                out[i] = detail::rotation_z<Transposed>(s, c);
+            });
+            break;
+        }
+    }, 4096);
+}
+
+
+template <bool Transposed, class Math, class Ty>
+void rotate_batch(const vector3<Ty> *axis, size_t axis_step, const Ty *angle, matrix4x4<Ty> *out, size_t n, size_t threads) {
+    const vector3<Ty> a0 = n && !axis_step ? normalize(axis[0]) : vector3<Ty>{};
+    parallel_for(n, threads, [=](size_t first, size_t last) {
+        detail::sincos_each(Math{}, angle, static_cast<Ty>(1), first, last, [=](size_t i, Ty s, Ty c) {
+            out[i] = detail::rotation<Transposed>(axis_step ? normalize(axis[i]) : a0, s, c);
+        });
+    }, 4096);
+}
+
+} // namespace detail
+
+
+
+
+/**
+* @brief 角度の配列の正弦と余弦を一括で求めます
+* @tparam Math 使用する関数 (fast_math / std_math)
+* @param[in]  angle   角度 (ラジアン) の配列
+* @param[out] s       sin(angle)の出力先
+* @param[out] c       cos(angle)の出力先
+* @param[in]  n       要素数
+* @param[in]  threads スレッド数 (1で呼び出しスレッドのみ、0でハードウェアスレッド数)
+* @return none
+* @exception none
+**/
+template <class Math = fast_math, class Ty>
+void sincos(const Ty *angle, Ty *s, Ty *c, size_t n, size_t threads = 1) {
+    parallel_for(n, threads, [=](size_t first, size_t last) {
+        detail::sincos_range<Math>(angle, s, c, first, last);
+    }, 4096);
+}
+
+
+/**
+* @brief 回転軸と角度の配列から回転クォータニオンを一括で生成します
+* @details quaternion(axis, angle)と同じ値を生成します
+* @param[in]  axis    回転軸の配列 (正規化されていなくても構いません)
+* @param[in]  angle   回転角 (ラジアン) の配列
+* @param[out] out     出力先
+* @param[in]  n       要素数
+* @param[in]  threads スレッド数
+* @return none
+* @exception none
+**/
+template <class Math = fast_math, class Ty>
+void rotate(const vector3<Ty> *axis, const Ty *angle, quaternion_soa<Ty> out, size_t n, size_t threads = 1) {
+    parallel_for(n, threads, [=](size_t first, size_t last) {
+        detail::sincos_each(Math{}, angle, static_cast<Ty>(0.5), first, last, [=](size_t i, Ty s, Ty c) {
+            const vector3<Ty> v = normalize(axis[i]);
+            out.set(i, quaternion<Ty>{c, v.x * s, v.y * s, v.z * s});
+        });
+    }, 4096);
+}
+
+
+/**
+* @brief 共通の回転軸と角度の配列から回転クォータニオンを一括で生成します
+**/
+template <class Math = fast_math, class Ty>
+void rotate(const vector3<Ty> &axis, const Ty *angle, quaternion_soa<Ty> out, size_t n, size_t threads = 1) {
+    const vector3<Ty> v = normalize(axis);
+    parallel_for(n, threads, [=](size_t first, size_t last) {
+        detail::sincos_each(Math{}, angle, static_cast<Ty>(0.5), first, last, [=](size_t i, Ty s, Ty c) {
+            out.set(i, quaternion<Ty>{c, v.x * s, v.y * s, v.z * s});
+        });
+    }, 4096);
+}
+
+
+
+
+namespace column_major {
+
+/**
+* @brief 角度の配列からx軸に関する回転行列を一括で生成します
+* @tparam Math 使用する関数 (fast_math / std_math)
+* @param[in]  radians 回転角 (ラジアン) の配列
+* @param[out] out     出力先
+* @param[in]  n       要素数
+* @param[in]  threads スレッド数
+* @return none
+* @exception none
+**/
+template <class Math = fast_math, class Ty>
+void rotate_x(const Ty *radians, matrix4x4<Ty> *out, size_t n, size_t threads = 1) {
+    detail::rotate_batch<false, Math>(0, radians, out, n, threads);
+}
+
+
+template <class Math = fast_math, class Ty>
+void rotate_y(const Ty *radians, matrix4x4<Ty> *out, size_t n, size_t threads = 1) {
+    detail::rotate_batch<false, Math>(1, radians, out, n, threads);
+}
+
+
+template <class Math = fast_math, class Ty>
+void rotate_z(const Ty *radians, matrix4x4<Ty> *out, size_t n, size_t threads = 1) {
+    detail::rotate_batch<false, Math>(2, radians, out, n, threads);
+}
+
+
+/**
+* @brief 回転軸と角度の配列から任意軸に関する回転行列を一括で生成します
+* @param[in]  axis    回転軸の配列
+* @param[in]  angle   回転角 (ラジアン) の配列
+* @param[out] out     出力先
+* @param[in]  n       要素数
+* @param[in]  threads スレッド数
+* @return none
+* @exception none
+**/
+template <class Math = fast_math, class Ty>
+void rotate(const vector3<Ty> *axis, const Ty *angle, matrix4x4<Ty> *out, size_t n, size_t threads = 1) {
+    detail::rotate_batch<false, Math>(axis, 1, angle, out, n, threads);
+}
+
+
+template <class Math = fast_math, class Ty>
+void rotate(const vector3<Ty> &axis, const Ty *angle, matrix4x4<Ty> *out, size_t n, size_t threads = 1) {
+    detail::rotate_batch<false, Math>(&axis, 0, angle, out, n, threads);
+}
+
+} // namespace column_major
+
+
+
+
+namespace row_major {
+
+/**
+* @brief 角度の配列から回転行列を一括で生成します
+* @details 引数はcolumn_major::rotate_x等と同じです
+**/
+template <class Math = fast_math, class Ty>
+void rotate_x(const Ty *radians, matrix4x4<Ty> *out, size_t n, size_t threads = 1) {
+    detail::rotate_batch<true, Math>(0, radians, out, n, threads);
+}
+
+
+template <class Math = fast_math, class Ty>
+void rotate_y(const Ty *radians, matrix4x4<Ty> *out, size_t n, size_t threads = 1) {
+    detail::rotate_batch<true, Math>(1, radians, out, n, threads);
+}
+
+
+template <class Math = fast_math, class Ty>
+void rotate_z(const Ty *radians, matrix4x4<Ty> *out, size_t n, size_t threads = 1) {
+    detail::rotate_batch<true, Math>(2, radians, out, n, threads);
+}
+
+
+template <class Math = fast_math, class Ty>
+void rotate(const vector3<Ty> *axis, const Ty *angle, matrix4x4<Ty> *out, size_t n, size_t threads = 1) {
+    detail::rotate_batch<true, Math>(axis, 1, angle, out, n, threads);
+}
+
+
+template <class Math = fast_math, class Ty>
+void rotate(const vector3<Ty> &axis, const Ty *angle, matrix4x4<Ty> *out, size_t n, size_t threads = 1) {
+    detail::rotate_batch<true, Math>(&axis, 0, angle, out, n, threads);
+}
+
+} // namespace row_major
+} // namespace gdv
+
+#endif
@@ -0,0 +1,223 @@
+/**
+* @file batch_transform.h
+* @brief 大量の点を一括で座標変換する関数の宣言
+* @details SoA(x, y, zの個別配列)とAoS(vector3の配列)の両方を受け付けます
+*          floatはSIMDで4点ずつ処理され、threadsを指定すると並列に処理されます
+**/
+#ifndef GDV_BATCH_TRANSFORM_H_
+#define GDV_BATCH_TRANSFORM_H_
+
+#include <gdv/math/vector3.h>
+#include <gdv/math/vector4.h>
+#include <gdv/math/matrix4x4.h>
+#include <gdv/math/simd.h>
+#include <gdv/tools/parallel.h>
+
+namespace gdv {
+namespace detail {
+
+/**
+* @brief out_i = a[4i] * x + a[4i + 1] * y + a[4i + 2] * z + a[4i + 3] を[first, last)について計算します
+* @details owがnullptrの場合w成分は出力されません
+**/
+template <class Ty>
+void transform_soa(const Ty *a,
+                   const Ty *x, const Ty *y, const Ty *z,
+                   Ty *ox, Ty *oy, Ty *oz, Ty *ow,
+                   size_t first, size_t last) noexcept {
+    for (size_t i = first; i < last; ++i) {
+        const Ty px = x[i], py = y[i], pz = z[i];
+        ox[i] = a[ 0] * px + a[ 1] * py + a[ 2] * pz + a[ 3];
+        oy[i] = a[ 4] * px + a[ 5] * py + a[ 6] * pz + a[ 7];
+        oz[i] = a[ 8] * px + a[ 9] * py + a[10] * pz + a[11];
+        if (ow) { ow[i] = a[12] * px + a[13] * py + a[14] * pz + a[15]; }
+    }
+}
+
+
+inline void transform_soa(const float *a,
+                          const float *x, const float *y, const float *z,
+                          float *ox, float *oy, float *oz, float *ow,
+                          size_t first, size_t last) noexcept {
+    simd::float4 k[16];
+    for (int j = 0; j < 16; ++j) { k[j] = simd::splat(a[j]); }
+
+    size_t i = first;
+    for (; i + 4 <= last; i += 4) {
+        const simd::float4 px = simd::loadu(x + i);
+        const simd::float4 py = simd::loadu(y + i);
+        const simd::float4 pz = simd::loadu(z + i);
+        simd::storeu(ox + i, simd::add(simd::madd(k[ 2], pz, simd::madd(k[ 1], py, simd::mul(k[ 0], px))), k[ 3]));
+        simd::storeu(oy + i, simd::add(simd::madd(k[ 6], pz, simd::madd(k[ 5], py, simd::mul(k[ 4], px))), k[ 7]));
+        simd::storeu(oz + i, simd::add(simd::madd(k[10], pz, simd::madd(k[ 9], py, simd::mul(k[ 8], px))), k[11]));
+        if (ow) {
+            simd::storeu(ow + i, simd::add(simd::madd(k[14], pz, simd::madd(k[13], py, simd::mul(k[12], px))), k[15]));
+        }
+    }
+    transform_soa<float>(a, x, y, z, ox, oy, oz, ow, i, last);
+}
+
+
+
+template <class Ty>
+void transform_aos(const Ty *a, const vector3<Ty> *in, vector4<Ty> *out, size_t first, size_t last) noexcept {
+    for (size_t i = first; i < last; ++i) {
+        const vector3<Ty> p = in[i];
+        out[i] = {
+            a[ 0] * p.x + a[ 1] * p.y + a[ 2] * p.z + a[ 3],
+            a[ 4] * p.x + a[ 5] * p.y + a[ 6] * p.z + a[ 7],
+            a[ 8] * p.x + a[ 9] * p.y + a[10] * p.z + a[11],
+            a[12] * p.x + a[13] * p.y + a[14] * p.z + a[15],
+        };
+    }
+}
+
+
+inline void transform_aos(const float *a, const vector3<float> *in, vector4<float> *out, size_t first, size_t last) noexcept {
+    const simd::float4 c0 = simd::set(a[0], a[4], a[ 8], a[12]);
+    const simd::float4 c1 = simd::set(a[1], a[5], a[ 9], a[13]);
+    const simd::float4 c2 = simd::set(a[2], a[6], a[10], a[14]);
+    const simd::float4 c3 = simd::set(a[3], a[7], a[11], a[15]);
+    for (size_t i = first; i < last; ++i) {
+        const simd::float4 r = simd::mul(simd::splat(in[i].x), c0);
+        simd::store(&out[i].x, simd::add(simd::madd(simd::splat(in[i].z), c2, simd::madd(simd::splat(in[i].y), c1, r)), c3));
+    }
+}
+
+
+
+template <class Ty>
+void transform_aos(const Ty *a, const vector3<Ty> *in, vector3<Ty> *out, size_t first, size_t last) noexcept {
+    for (size_t i = first; i < last; ++i) {
+        const vector3<Ty> p = in[i];
+        out[i] = {
+            a[ 0] * p.x + a[ 1] * p.y + a[ 2] * p.z + a[ 3],
+            a[ 4] * p.x + a[ 5] * p.y + a[ 6] * p.z + a[ 7],
+            a[ 8] * p.x + a[ 9] * p.y + a[10] * p.z + a[11],
+        };
+    }
+}
+
+
+inline void transform_aos(const float *a, const vector3<float> *in, vector3<float> *out, size_t first, size_t last) noexcept {
+    const simd::float4 c0 = simd::set(a[0], a[4], a[ 8], a[12]);
+    const simd::float4 c1 = simd::set(a[1], a[5], a[ 9], a[13]);
+    const simd::float4 c2 = simd::set(a[2], a[6], a[10], a[14]);
+    const simd::float4 c3 = simd::set(a[3], a[7], a[11], a[15]);
+    alignas(16) float t[4];
+    for (size_t i = first; i < last; ++i) {
+        const simd::float4 r = simd::mul(simd::splat(in[i].x), c0);
+        simd::store(t, simd::add(simd::madd(simd::splat(in[i].z), c2, simd::madd(simd::splat(in[i].y), c1, r)), c3));
+        out[i] = {t[0], t[1], t[2]};
+    }
+}
+
+} // namespace detail
+
+
+
+
+namespace column_major {
+
+/**
+* @brief SoA配列の点群を m * (x, y, z, 1) で変換します
+* @param[in]  m       変換行列
+* @param[in]  x, y, z 入力座標の配列
+* @param[out] ox, oy, oz 出力座標の配列 (入力と同じ配列でも構いません)
+* @param[out] ow      出力w成分の配列 (不要な場合はnullptr)
+* @param[in]  n       点の数
+* @param[in]  threads スレッド数 (1で呼び出しスレッドのみ、0でハードウェアスレッド数)
+* @return none
+* @exception none
+**/
+template <class Ty>
+void transform(const matrix4x4<Ty> &m,
+               const Ty *x, const Ty *y, const Ty *z,
+               Ty *ox, Ty *oy, Ty *oz, Ty *ow,
+               size_t n, size_t threads = 1) {
+    parallel_for(n, threads, [&](size_t first, size_t last) {
+        detail::transform_soa(m.m, x, y, z, ox, oy, oz, ow, first, last);
+    });
+}
+
+
+template <class Ty>
+void transform(const matrix4x4<Ty> &m,
+               const Ty *x, const Ty *y, const Ty *z,
+               Ty *ox, Ty *oy, Ty *oz,
+               size_t n, size_t threads = 1) {
+    transform(m, x, y, z, ox, oy, oz, static_cast<Ty*>(nullptr), n, threads);
+}
+
+
+/**
+* @brief AoS配列の点群を m * v で変換します
+* @param[in]  m       変換行列
+* @param[in]  in      入力座標の配列
+* @param[out] out     出力座標の配列 (vector4ならw成分も出力されます)
+* @param[in]  n       点の数
+* @param[in]  threads スレッド数
+* @return none
+* @exception none
+**/
+template <class Ty, class Out>
+void transform(const matrix4x4<Ty> &m, const vector3<Ty> *in, Out *out, size_t n, size_t threads = 1) {
+    parallel_for(n, threads, [&](size_t first, size_t last) {
+        detail::transform_aos(m.m, in, out, first, last);
+    });
+}
+
+} // namespace column_major
+
+
+
+
+namespace row_major {
+
+/**
+* @brief SoA配列の点群を (x, y, z, 1) * m で変換します
+* @details 引数はcolumn_major::transformと同じです
+**/
+template <class Ty>
+void transform(const matrix4x4<Ty> &m,
+               const Ty *x, const Ty *y, const Ty *z,
+               Ty *ox, Ty *oy, Ty *oz, Ty *ow,
+               size_t n, size_t threads = 1) {
+    const matrix4x4<Ty> t{
+        m.m[0], m.m[4], m.m[ 8], m.m[12],
+        m.m[1], m.m[5], m.m[ 9], m.m[13],
+        m.m[2], m.m[6], m.m[10], m.m[14],
+        m.m[3], m.m[7], m.m[11], m.m[15]
+    };
+    column_major::transform(t, x, y, z, ox, oy, oz, ow, n, threads);
+}
+
+
+template <class Ty>
+void transform(const matrix4x4<Ty> &m,
+               const Ty *x, const Ty *y, const Ty *z,
+               Ty *ox, Ty *oy, Ty *oz,
+               size_t n, size_t threads = 1) {
+    transform(m, x, y, z, ox, oy, oz, static_cast<Ty*>(nullptr), n, threads);
+}
+
+
+/**
+* @brief AoS配列の点群を v * m で変換します
+* @details 引数はcolumn_major::transformと同じです
+**/
+template <class Ty, class Out>
+void transform(const matrix4x4<Ty> &m, const vector3<Ty> *in, Out *out, size_t n, size_t threads = 1) {
+    const matrix4x4<Ty> t{
+        m.m[0], m.m[4], m.m[ 8], m.m[12],
+        m.m[1], m.m[5], m.m[ 9], m.m[13],
+        m.m[2], m.m[6], m.m[10], m.m[14],
+        m.m[3], m.m[7], m.m[11], m.m[15]
+    };
+    column_major::transform(t, in, out, n, threads);
+}
+
+} // namespace row_major
+} // namespace gdv
+
+#endif
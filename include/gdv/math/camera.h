@@ -5,16 +5,57 @@
 #ifndef GDV_CAMERA_H_
 #define GDV_CAMERA_H_
 
+#include <atomic>
+#include <new>
 #include <gdv/math/math_function.h>
 #include <gdv/math/vector3.h>
 #include <gdv/math/matrix4x4.h>
 
 namespace gdv {
 
+namespace detail {
+
+/**
+* @enum convention
+* @brief 行列の規約 (camera のキャッシュがどの名前空間の関数で作られたかを表します)
+**/
+enum class convention : int {
+    column_major_right_hand = 0,
+    column_major_left_hand = 1,
+    row_major_right_hand = 2,
+    row_major_left_hand = 3,
+};
+
+
+/**
+* @enum camera_slot
+* @brief camera のキャッシュする行列の種類
+**/
+enum class camera_slot : int {
+    view = 0,
+    projection = 1,
+    view_projection = 2,
+    inverse_view = 3,
+    inverse_projection = 4,
+    inverse_view_projection = 5,
+};
+
+
+struct camera_access;
+
+} // namespace detail
+
+
+
 /**
 * @class camera
 * @brief カメラの状態を表すクラスです
 * @details ビューとプロジェクションの情報が保存されます
+*          view、projection、to_matrixとそれらの逆行列は最初の取得時に計算してキャッシュされ、
+*          setterが呼ばれるまで再計算されません。キャッシュの領域は規約ごとに最初の取得時に確保されるため、
+*          行列を取得しないカメラの大きさは変わりません。コピーではキャッシュは引き継がれません
+*          constの取得関数は複数のスレッドから同時に呼び出せますが、setterや代入は他のスレッドが
+*          参照していない間に呼び出してください
 **/
 template <class Ty>
 class camera {
@@ -31,6 +72,15 @@ public:
 
         //! 平行投影カメラ
         orthogonal = 1,
+
+        //! 透視投影カメラ (リバースZ、近くのクリップ面の深度が1)
+        reverse_perspective = 2,
+
+        //! 遠くのクリップ面が無限遠の透視投影カメラ (farは使用されません)
+        infinite_perspective = 3,
+
+        //! 遠くのクリップ面が無限遠の透視投影カメラ (リバースZ、farは使用されません)
+        reverse_infinite_perspective = 4,
     };
 
 
@@ -257,6 +307,17 @@ public:
 
 
 
+    /**
+    * @brief デストラクタ
+    * @return none
+    * @exception none
+    **/
+    ~camera() noexcept {
+        for (std::atomic<cache_block*> &b : cache_) { delete b.load(std::memory_order_relaxed); }
+    }
+
+
+
     /**
     * @brief 代入演算子
     * @param[in] c コピー元のカメラ
@@ -274,6 +335,7 @@ public:
         top_    = c.top_;
         near_   = c.near_;
         far_    = c.far_;
+        invalidate();
         return *this;
     }
 
@@ -286,7 +348,7 @@ public:
     * @return none
     * @exception none
     **/
-    void set_mode(mode mode) noexcept {mode_ = mode;}
+    void set_mode(mode mode) noexcept {mode_ = mode; invalidate();}
 
     /**
     * @brief カメラの位置を設定します
@@ -294,7 +356,7 @@ public:
     * @return none
     * @exception none
     **/
-    void set_pos(vector3<Ty> pos) noexcept {pos_ = pos;}
+    void set_pos(vector3<Ty> pos) noexcept {pos_ = pos; invalidate();}
 
     /**
     * @brief カメラの注視点を設定します
@@ -302,7 +364,7 @@ public:
     * @return none
     * @exception none
     **/
-    void set_dst(vector3<Ty> dst) noexcept {dst_ = dst;}
+    void set_dst(vector3<Ty> dst) noexcept {dst_ = dst; invalidate();}
 
     /**
     * @brief カメラの上方を設定します
@@ -310,7 +372,7 @@ public:
     * @return none
     * @exception none
     **/
-    void set_up(vector3<Ty> up) noexcept {up_ = up;}
+    void set_up(vector3<Ty> up) noexcept {up_ = up; invalidate();}
 
     /**
     * @brief 視錐台の左端を設定します
@@ -318,7 +380,7 @@ public:
     * @return none
     * @exception none
     **/
-    void set_left(Ty left) noexcept {left_ = left;}
+    void set_left(Ty left) noexcept {left_ = left; invalidate();}
 
     /**
     * @brief 視錐台の右端を設定します
@@ -326,7 +388,7 @@ public:
     * @return none
     * @exception none
     **/
-    void set_right(Ty right) noexcept {right_ = right;}
+    void set_right(Ty right) noexcept {right_ = right; invalidate();}
 
     /**
     * @brief 視錐台の下端を設定します
@@ -334,7 +396,7 @@ public:
     * @return none
     * @exception none
     **/
-    void set_bottom(Ty bottom) noexcept {bottom_ = bottom;}
+    void set_bottom(Ty bottom) noexcept {bottom_ = bottom; invalidate();}
 
     /**
     * @brief 視錐台の上端を設定します
@@ -342,7 +404,7 @@ public:
     * @return none
     * @exception none
     **/
-    void set_top(Ty top) noexcept {top_ = top;}
+    void set_top(Ty top) noexcept {top_ = top; invalidate();}
 
     /**
     * @brief 近くのクリップ面の奥行きを設定します
@@ -350,7 +412,7 @@ public:
     * @return none
     * @exception none
     **/
-    void set_near(Ty near) noexcept {near_ = near;}
+    void set_near(Ty near) noexcept {near_ = near; invalidate();}
 
     /**
     * @brief 遠くのクリップ面の奥行きを設定します
@@ -358,7 +420,7 @@ public:
     * @return none
     * @exception none
     **/
-    void set_far(Ty far) noexcept{far_ = far;}
+    void set_far(Ty far) noexcept {far_ = far; invalidate();}
 
     /**
     * @brief 視錐台の幅を設定します
@@ -369,6 +431,7 @@ public:
     void set_width(Ty width) noexcept {
         left_   = -width / static_cast<Ty>(2);
         right_  =  width / static_cast<Ty>(2);
+        invalidate();
     }
 
     /**
@@ -378,8 +441,9 @@ public:
     * @exception none
     **/
     void set_height(Ty height) noexcept {
-        top_    = height / static_cast<Ty>(2);
-        bottom_ = height / static_cast<Ty>(2);
+        top_    =  height / static_cast<Ty>(2);
+        bottom_ = -height / static_cast<Ty>(2);
+        invalidate();
     }
 
     /**
@@ -392,6 +456,7 @@ public:
     void set_near_far(Ty near, Ty far) noexcept {
         near_   = near;
         far_    = far;
+        invalidate();
     }
 
     /**
@@ -408,6 +473,7 @@ public:
         right_  = right;
         bottom_ = bottom;
         top_    = top;
+        invalidate();
     }
 
 
@@ -498,6 +564,76 @@ public:
     Ty get_height() const noexcept {return top_ - bottom_;}
 
 
+
+private:
+    friend struct detail::camera_access;
+
+    static constexpr int        slot_count = 6;     //! 規約ごとのキャッシュの数
+    static constexpr unsigned   empty = 0;          //! キャッシュが無効
+    static constexpr unsigned   busy = 1;           //! いずれかのスレッドが計算中
+    static constexpr unsigned   ready = 2;          //! キャッシュが有効
+
+    /**
+    * @brief 1つの規約のキャッシュです
+    **/
+    struct cache_block {
+        matrix4x4<Ty>           matrix[slot_count]; //! キャッシュした行列
+        std::atomic<unsigned>   state[slot_count];  //! 各キャッシュの状態
+    };
+
+
+    /**
+    * @brief キャッシュされた行列を取得します
+    * @param[in] c       行列の規約
+    * @param[in] s       行列の種類
+    * @param[in] compute キャッシュが無効な場合に行列を計算する関数
+    * @return 行列
+    * @exception none
+    * @details キャッシュは規約ごとに保持されるため、規約を交互に使っても破棄されません
+    *          最初に計算を始めたスレッドだけがキャッシュに書き込み、計算中に呼び出した他のスレッドは
+    *          待たずに自分で計算した値を返します。領域を確保できない場合は毎回計算します
+    **/
+    template <class Function>
+    matrix4x4<Ty> cached(detail::convention c, detail::camera_slot s, Function compute) const noexcept {
+        cache_block *b = block(c);
+        if (!b) { return compute(); }
+        const int i = static_cast<int>(s);
+        std::atomic<unsigned> &state = b->state[i];
+        unsigned expected = state.load(std::memory_order_acquire);
+        if (expected == ready) { return b->matrix[i]; }
+        if (expected == empty && state.compare_exchange_strong(expected, busy, std::memory_order_acquire)) {
+            b->matrix[i] = compute();
+            state.store(ready, std::memory_order_release);
+            return b->matrix[i];
+        }
+        return expected == ready ? b->matrix[i] : compute();
+    }
+
+
+    /**
+    * @brief 規約のキャッシュを取得し、まだ無ければ確保します
+    **/
+    cache_block* block(detail::convention c) const noexcept {
+        std::atomic<cache_block*> &p = cache_[static_cast<int>(c)];
+        cache_block *b = p.load(std::memory_order_acquire);
+        if (b) { return b; }
+        cache_block *n = new (std::nothrow) cache_block();
+        if (!n) { return nullptr; }
+        if (p.compare_exchange_strong(b, n, std::memory_order_acq_rel, std::memory_order_acquire)) { return n; }
+        delete n;
+        return b;
+    }
+
+
+    void invalidate() noexcept {
+        for (std::atomic<cache_block*> &p : cache_) {
+            cache_block *b = p.load(std::memory_order_relaxed);
+            if (!b) { continue; }
+            for (std::atomic<unsigned> &s : b->state) { s.store(empty, std::memory_order_relaxed); }
+        }
+    }
+
+
 private:
     mode        mode_;      //! カメラの投影モード
     vector3<Ty> pos_;       //! カメラの位置
@@ -509,47 +645,100 @@ private:
     Ty          top_;       //! 視錐台の上端
     Ty          near_;      //! 近くのクリップ面の奥行き
     Ty          far_;       //! 遠くのクリップ面の奥行き
+
+    mutable std::atomic<cache_block*> cache_[4] = {};   //! 規約ごとのキャッシュ (最初の取得時に確保)
 };
 
 
 
+namespace detail {
+
+/**
+* @brief 各名前空間の行列関数から camera のキャッシュを使うための窓口です
+**/
+struct camera_access {
+    template <class Ty, class Function>
+    static matrix4x4<Ty> cached(const camera<Ty> &c, convention cv, camera_slot s, Function compute) noexcept {
+        return c.cached(cv, s, compute);
+    }
+};
+
+} // namespace detail
+
+
+
 namespace row_major {
 namespace right_hand {
 namespace {
 template <class Ty>
-constexpr matrix4x4<Ty>(*projection_func[])(Ty, Ty, Ty, Ty) noexcept {perspective, orthogonal};
+constexpr matrix4x4<Ty>(*projection_func[])(Ty, Ty, Ty, Ty) noexcept {
+    perspective,
+    orthogonal,
+    perspective_reverse,
+    [](Ty w, Ty h, Ty n, Ty) noexcept {return perspective_infinite(w, h, n);},
+    [](Ty w, Ty h, Ty n, Ty) noexcept {return perspective_infinite_reverse(w, h, n);},
+};
+
+constexpr detail::convention convention = detail::convention::row_major_right_hand;
+}
+
+template <class Ty>
+matrix4x4<Ty> projection(const camera<Ty> &c) noexcept {
+    return detail::camera_access::cached(c, convention, detail::camera_slot::projection, [&c] {
+        return projection_func<Ty>[(int)c.get_mode()](c.get_width(), c.get_height(), c.get_near(), c.get_far());
+    });
+}
+
+template <class Ty>
+matrix4x4<Ty> view(const camera<Ty> &c) noexcept {
+    return detail::camera_access::cached(c, convention, detail::camera_slot::view, [&c] {
+        return look_at(c.get_pos(), c.get_dst(), c.get_up());
+    });
 }
 
 template <class Ty>
-matrix4x4<Ty> projection(camera<Ty> c) noexcept {
-    return projection_func<Ty>[(int)c.mode()](c.width(), c.height(), c.near(), c.far());
+matrix4x4<Ty> to_matrix(const camera<Ty> &c) noexcept {
+    return detail::camera_access::cached(c, convention, detail::camera_slot::view_projection, [&c] {
+        return view(c) * projection(c);
+    });
 }
 
 template <class Ty>
-matrix4x4<Ty> view(camera<Ty> c) noexcept {
-    return look_at(c.pos(), c.dst(), c.up());
+matrix4x4<Ty> inverse_view(const camera<Ty> &c) noexcept {
+    return detail::camera_access::cached(c, convention, detail::camera_slot::inverse_view, [&c] {
+        return affine_inverse(view(c));
+    });
 }
 
 template <class Ty>
-matrix4x4<Ty> to_matrix(camera<Ty> c) noexcept {
-    return view(c) * projection(c);
+matrix4x4<Ty> inverse_projection(const camera<Ty> &c) noexcept {
+    return detail::camera_access::cached(c, convention, detail::camera_slot::inverse_projection, [&c] {
+        return inverse(projection(c));
+    });
+}
+
+template <class Ty>
+matrix4x4<Ty> inverse_matrix(const camera<Ty> &c) noexcept {
+    return detail::camera_access::cached(c, convention, detail::camera_slot::inverse_view_projection, [&c] {
+        return inverse(to_matrix(c));
+    });
 }
 
 
 template <class Ty>
-matrix4x4<Ty> operator * (camera<Ty> c, matrix4x4<Ty> m) noexcept {
+matrix4x4<Ty> operator * (const camera<Ty> &c, matrix4x4<Ty> m) noexcept {
     return to_matrix(c) * m;
 }
 
 
 template <class Ty>
-matrix4x4<Ty> operator * (matrix4x4<Ty> m, camera<Ty> c) noexcept {
+matrix4x4<Ty> operator * (matrix4x4<Ty> m, const camera<Ty> &c) noexcept {
     return m * to_matrix(c);
 }
 
 
 template <class Ty>
-vector3<Ty> operator * (vector3<Ty> v, camera<Ty> c) noexcept {
+vector3<Ty> operator * (vector3<Ty> v, const camera<Ty> &c) noexcept {
 	return to_matrix(c) * v;
 }
 
@@ -560,39 +749,74 @@ vector3<Ty> operator * (vector3<Ty> v, camera<Ty> c) noexcept {
 namespace left_hand {
 namespace {
 template <class Ty>
-constexpr matrix4x4<Ty>(*projection_func[])(Ty, Ty, Ty, Ty) noexcept {perspective, orthogonal};
+constexpr matrix4x4<Ty>(*projection_func[])(Ty, Ty, Ty, Ty) noexcept {
+    perspective,
+    orthogonal,
+    perspective_reverse,
+    [](Ty w, Ty h, Ty n, Ty) noexcept {return perspective_infinite(w, h, n);},
+    [](Ty w, Ty h, Ty n, Ty) noexcept {return perspective_infinite_reverse(w, h, n);},
+};
+
+constexpr detail::convention convention = detail::convention::row_major_left_hand;
 }
 
 template <class Ty>
-matrix4x4<Ty> projection(camera<Ty> c) noexcept {
-    return projection_func<Ty>[(int)c.get_mode()](c.get_width(), c.get_height(), c.get_near(), c.get_far());
+matrix4x4<Ty> projection(const camera<Ty> &c) noexcept {
+    return detail::camera_access::cached(c, convention, detail::camera_slot::projection, [&c] {
+        return projection_func<Ty>[(int)c.get_mode()](c.get_width(), c.get_height(), c.get_near(), c.get_far());
+    });
 }
 
 template <class Ty>
-matrix4x4<Ty> view(camera<Ty> c) noexcept {
-    return look_at(c.get_pos(), c.get_dst(), c.get_up());
+matrix4x4<Ty> view(const camera<Ty> &c) noexcept {
+    return detail::camera_access::cached(c, convention, detail::camera_slot::view, [&c] {
+        return look_at(c.get_pos(), c.get_dst(), c.get_up());
+    });
 }
 
 template <class Ty>
-matrix4x4<Ty> to_matrix(camera<Ty> c) noexcept {
-	return view(c) * projection(c);
+matrix4x4<Ty> to_matrix(const camera<Ty> &c) noexcept {
+    return detail::camera_access::cached(c, convention, detail::camera_slot::view_projection, [&c] {
+        return view(c) * projection(c);
+    });
 }
 
+template <class Ty>
+matrix4x4<Ty> inverse_view(const camera<Ty> &c) noexcept {
+    return detail::camera_access::cached(c, convention, detail::camera_slot::inverse_view, [&c] {
+        return affine_inverse(view(c));
+    });
+}
+
+template <class Ty>
+matrix4x4<Ty> inverse_projection(const camera<Ty> &c) noexcept {
+    return detail::camera_access::cached(c, convention, detail::camera_slot::inverse_projection, [&c] {
+        return inverse(projection(c));
+    });
+}
 
 template <class Ty>
-matrix4x4<Ty> operator * (camera<Ty> c, matrix4x4<Ty> m) noexcept {
+matrix4x4<Ty> inverse_matrix(const camera<Ty> &c) noexcept {
+    return detail::camera_access::cached(c, convention, detail::camera_slot::inverse_view_projection, [&c] {
+        return inverse(to_matrix(c));
+    });
+}
+
+
+template <class Ty>
+matrix4x4<Ty> operator * (const camera<Ty> &c, matrix4x4<Ty> m) noexcept {
     return to_matrix(c) * m;
 }
 
 
 template <class Ty>
-matrix4x4<Ty> operator * (matrix4x4<Ty> m, camera<Ty> c) noexcept {
+matrix4x4<Ty> operator * (matrix4x4<Ty> m, const camera<Ty> &c) noexcept {
     return m * to_matrix(c);
 }
 
 
 template <class Ty>
-vector3<Ty> operator * (vector3<Ty> v, camera<Ty> c) noexcept {
+vector3<Ty> operator * (vector3<Ty> v, const camera<Ty> &c) noexcept {
     return to_matrix(c) * v;
 }
 
@@ -608,42 +832,73 @@ namespace column_major {
 namespace right_hand {
 namespace {
 template <class Ty>
-constexpr matrix4x4<Ty>(*projection_func[])(Ty, Ty, Ty, Ty) noexcept {perspective, orthogonal};
+constexpr matrix4x4<Ty>(*projection_func[])(Ty, Ty, Ty, Ty) noexcept {
+    perspective,
+    orthogonal,
+    perspective_reverse,
+    [](Ty w, Ty h, Ty n, Ty) noexcept {return perspective_infinite(w, h, n);},
+    [](Ty w, Ty h, Ty n, Ty) noexcept {return perspective_infinite_reverse(w, h, n);},
+};
+
+constexpr detail::convention convention = detail::convention::column_major_right_hand;
 }
 
 template <class Ty>
-matrix4x4<Ty> projection(camera<Ty> c) noexcept {
-	/*return
-		c.mode() == camera<Ty>::mode::PERSPECTIVE ?
-		perspective(c.width(), c.height(), c.near(), c.far()):
-		orthogonal(c.width(), c.height(), c.near(), c.far());*/
-    return projection_func<Ty>[(int)c.get_mode()](c.get_width(), c.get_height(), c.get_near(), c.get_far());
+matrix4x4<Ty> projection(const camera<Ty> &c) noexcept {
+    return detail::camera_access::cached(c, convention, detail::camera_slot::projection, [&c] {
+        return projection_func<Ty>[(int)c.get_mode()](c.get_width(), c.get_height(), c.get_near(), c.get_far());
+    });
 }
 
 template <class Ty>
-matrix4x4<Ty> view(camera<Ty> c) noexcept {
-    return look_at(c.get_pos(), c.get_dst(), c.get_up());
+matrix4x4<Ty> view(const camera<Ty> &c) noexcept {
+    return detail::camera_access::cached(c, convention, detail::camera_slot::view, [&c] {
+        return look_at(c.get_pos(), c.get_dst(), c.get_up());
+    });
 }
 
 template <class Ty>
-matrix4x4<Ty> to_matrix(camera<Ty> c) noexcept {
-    return projection(c) * view(c);
+matrix4x4<Ty> to_matrix(const camera<Ty> &c) noexcept {
+    return detail::camera_access::cached(c, convention, detail::camera_slot::view_projection, [&c] {
+        return projection(c) * view(c);
+    });
 }
 
 template <class Ty>
-matrix4x4<Ty> operator * (camera<Ty> c, matrix4x4<Ty> m) noexcept {
+matrix4x4<Ty> inverse_view(const camera<Ty> &c) noexcept {
+    return detail::camera_access::cached(c, convention, detail::camera_slot::inverse_view, [&c] {
+        return affine_inverse(view(c));
+    });
+}
+
+template <class Ty>
+matrix4x4<Ty> inverse_projection(const camera<Ty> &c) noexcept {
+    return detail::camera_access::cached(c, convention, detail::camera_slot::inverse_projection, [&c] {
+        return inverse(projection(c));
+    });
+}
+
+template <class Ty>
+matrix4x4<Ty> inverse_matrix(const camera<Ty> &c) noexcept {
+    return detail::camera_access::cached(c, convention, detail::camera_slot::inverse_view_projection, [&c] {
+        return inverse(to_matrix(c));
+    });
+}
+
+template <class Ty>
+matrix4x4<Ty> operator * (const camera<Ty> &c, matrix4x4<Ty> m) noexcept {
     return to_matrix(c) * m;
 }
 
 
 template <class Ty>
-matrix4x4<Ty> operator * (matrix4x4<Ty> m, camera<Ty> c) noexcept {
+matrix4x4<Ty> operator * (matrix4x4<Ty> m, const camera<Ty> &c) noexcept {
     return m * to_matrix(c);
 }
 
 
 template <class Ty>
-vector3<Ty> operator * (camera<Ty> c, vector3<Ty> v) noexcept {
+vector3<Ty> operator * (const camera<Ty> &c, vector3<Ty> v) noexcept {
     return to_matrix(c) * v;
 }
 
@@ -654,39 +909,74 @@ vector3<Ty> operator * (camera<Ty> c, vector3<Ty> v) noexcept {
 namespace left_hand {
 namespace {
 template <class Ty>
-constexpr matrix4x4<Ty>(*projection_func[])(Ty, Ty, Ty, Ty) noexcept {perspective, orthogonal};
+constexpr matrix4x4<Ty>(*projection_func[])(Ty, Ty, Ty, Ty) noexcept {
+    perspective,
+    orthogonal,
+    perspective_reverse,
+    [](Ty w, Ty h, Ty n, Ty) noexcept {return perspective_infinite(w, h, n);},
+    [](Ty w, Ty h, Ty n, Ty) noexcept {return perspective_infinite_reverse(w, h, n);},
+};
+
+constexpr detail::convention convention = detail::convention::column_major_left_hand;
+}
+
+template <class Ty>
+matrix4x4<Ty> projection(const camera<Ty> &c) noexcept {
+    return detail::camera_access::cached(c, convention, detail::camera_slot::projection, [&c] {
+        return projection_func<Ty>[(int)c.get_mode()](c.get_width(), c.get_height(), c.get_near(), c.get_far());
+    });
+}
+
+template <class Ty>
+matrix4x4<Ty> view(const camera<Ty> &c) noexcept {
+    return detail::camera_access::cached(c, convention, detail::camera_slot::view, [&c] {
+        return look_at(c.get_pos(), c.get_dst(), c.get_up());
+    });
+}
+
+template <class Ty>
+matrix4x4<Ty> to_matrix(const camera<Ty> &c) noexcept {
+    return detail::camera_access::cached(c, convention, detail::camera_slot::view_projection, [&c] {
+        return projection(c) * view(c);
+    });
 }
 
 template <class Ty>
-matrix4x4<Ty> projection(camera<Ty> c) noexcept {
-    return projection_func<Ty>[(int)c.get_mode()](c.get_width(), c.get_height(), c.get_near(), c.get_far());
+matrix4x4<Ty> inverse_view(const camera<Ty> &c) noexcept {
+    return detail::camera_access::cached(c, convention, detail::camera_slot::inverse_view, [&c] {
+        return affine_inverse(view(c));
+    });
 }
 
 template <class Ty>
-matrix4x4<Ty> view(camera<Ty> c) noexcept {
-    return look_at(c.get_pos(), c.get_dst(), c.get_up());
+matrix4x4<Ty> inverse_projection(const camera<Ty> &c) noexcept {
+    return detail::camera_access::cached(c, convention, detail::camera_slot::inverse_projection, [&c] {
+        return inverse(projection(c));
+    });
 }
 
 template <class Ty>
-matrix4x4<Ty> to_matrix(camera<Ty> c) noexcept {
-    return projection(c) * view(c);
+matrix4x4<Ty> inverse_matrix(const camera<Ty> &c) noexcept {
+    return detail::camera_access::cached(c, convention, detail::camera_slot::inverse_view_projection, [&c] {
+        return inverse(to_matrix(c));
+    });
 }
 
 
 template <class Ty>
-matrix4x4<Ty> operator * (camera<Ty> c, matrix4x4<Ty> m) noexcept {
+matrix4x4<Ty> operator * (const camera<Ty> &c, matrix4x4<Ty> m) noexcept {
     return to_matrix(c) * m;
 }
 
 
 template <class Ty>
-matrix4x4<Ty> operator * (matrix4x4<Ty> m, camera<Ty> c) noexcept {
+matrix4x4<Ty> operator * (matrix4x4<Ty> m, const camera<Ty> &c) noexcept {
     return m * to_matrix(c);
 }
 
 
 template <class Ty>
-vector3<Ty> operator * (camera<Ty> c, vector3<Ty> v) noexcept {
+vector3<Ty> operator * (const camera<Ty> &c, vector3<Ty> v) noexcept {
     return to_matrix(c) * v;
 }
 
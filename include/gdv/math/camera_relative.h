@@ -0,0 +1,396 @@
+/**
+* @file camera_relative.h
+* @brief 広い座標系をカメラ基準のfloat座標へ変換する関数の宣言
+* @details floatは原点から1e7離れると精度が1程度になるため、位置はvector3<double>、
+*          ワールド行列はmatrix4x4<double>で保持し、カメラの位置を差し引いてからfloatへ丸めます
+*          ビュー行列はカメラを原点に置いた回転のみの行列になり、描画にはfloatの行列だけを使います
+*          doubleからfloatへの変換はSIMDで行われ、threadsを指定すると並列に処理されます
+**/
+#ifndef GDV_CAMERA_RELATIVE_H_
+#define GDV_CAMERA_RELATIVE_H_
+
+#include <algorithm>
+#include <gdv/math/vector3.h>
+#include <gdv/math/matrix4x4.h>
+#include <gdv/math/math_function.h>
+#include <gdv/math/camera.h>
+#include <gdv/math/simd.h>
+#include <gdv/tools/parallel.h>
+
+namespace gdv {
+namespace detail {
+
+/**
+* @brief 行列の各要素をfloatへ丸めます
+**/
+template <class Ty>
+matrix4x4<float> downcast(const matrix4x4<Ty> &m) noexcept {
+    matrix4x4<float> r;
+    for (int i = 0; i < 16; ++i) { r.m[i] = static_cast<float>(m.m[i]); }
+    return r;
+}
+
+
+/**
+* @brief (x, y, z) - oを[first, last)についてfloatで出力します
+**/
+template <class Ty>
+void relative_soa(const Ty *x, const Ty *y, const Ty *z, vector3<Ty> o,
+                  float *ox, float *oy, float *oz,
+                  size_t first, size_t last) noexcept {
+    for (size_t i = first; i < last; ++i) {
+        ox[i] = static_cast<float>(x[i] - o.x);
+        oy[i] = static_cast<float>(y[i] - o.y);
+        oz[i] = static_cast<float>(z[i] - o.z);
+    }
+}
+
+
+inline void relative_soa(const double *x, const double *y, const double *z, vector3<double> o,
+                         float *ox, float *oy, float *oz,
+                         size_t first, size_t last) noexcept {
+    const double cx[4] = {o.x, o.x, o.x, o.x};
+    const double cy[4] = {o.y, o.y, o.y, o.y};
+    const double cz[4] = {o.z, o.z, o.z, o.z};
+
+    size_t i = first;
+    for (; i + 4 <= last; i += 4) {
+        simd::storeu(ox + i, simd::sub_cvt(x + i, cx));
+        simd::storeu(oy + i, simd::sub_cvt(y + i, cy));
+        simd::storeu(oz + i, simd::sub_cvt(z + i, cz));
+    }
+    relative_soa<double>(x, y, z, o, ox, oy, oz, i, last);
+}
+
+
+
+template <class Ty>
+void relative_aos(const vector3<Ty> *in, vector3<Ty> o, vector3<float> *out, size_t first, size_t last) noexcept {
+    for (size_t i = first; i < last; ++i) {
+        out[i] = {
+            static_cast<float>(in[i].x - o.x),
+            static_cast<float>(in[i].y - o.y),
+            static_cast<float>(in[i].z - o.z),
+        };
+    }
+}
+
+
+/**
+* @details 4点 (12要素) をxyzの順に並べ直した配列を1組として、周期12の差分配列で処理します
+*          別々のvector3をまたぐポインタ演算を避けるため、メンバを経由して読み書きします
+**/
+inline void relative_aos(const vector3<double> *in, vector3<double> o, vector3<float> *out, size_t first, size_t last) noexcept {
+    const double c[12] = {o.x, o.y, o.z, o.x, o.y, o.z, o.x, o.y, o.z, o.x, o.y, o.z};
+
+    size_t i = first;
+    for (; i + 4 <= last; i += 4) {
+        double a[12];
+        float b[12];
+        for (int j = 0; j < 4; ++j) {
+            a[3 * j] = in[i + j].x;
+            a[3 * j + 1] = in[i + j].y;
+            a[3 * j + 2] = in[i + j].z;
+        }
+        simd::storeu(b,     simd::sub_cvt(a,     c));
+        simd::storeu(b + 4, simd::sub_cvt(a + 4, c + 4));
+        simd::storeu(b + 8, simd::sub_cvt(a + 8, c + 8));
+        for (int j = 0; j < 4; ++j) { out[i + j] = {b[3 * j], b[3 * j + 1], b[3 * j + 2]}; }
+    }
+    relative_aos<double>(in, o, out, i, last);
+}
+
+
+
+/**
+* @brief translation(-o) * in[i] を[first, last)についてfloatで出力します (column_majorの配置)
+* @details 行iから o_i * (4行目) を差し引きます。アフィン行列では平行移動成分からoを引くことと同じです
+**/
+template <class Ty>
+void relative_column(const matrix4x4<Ty> *in, vector3<Ty> o, matrix4x4<float> *out, size_t first, size_t last) noexcept {
+    const Ty d[3] = {o.x, o.y, o.z};
+    for (size_t i = first; i < last; ++i) {
+        const Ty *a = in[i].m;
+        float *b = out[i].m;
+        for (int r = 0; r < 3; ++r) {
+            for (int j = 0; j < 4; ++j) { b[4 * r + j] = static_cast<float>(a[4 * r + j] - d[r] * a[12 + j]); }
+        }
+        for (int j = 12; j < 16; ++j) { b[j] = static_cast<float>(a[j]); }
+    }
+}
+
+
+inline void relative_column(const matrix4x4<double> *in, vector3<double> o, matrix4x4<float> *out, size_t first, size_t last) noexcept {
+    const double d[3] = {o.x, o.y, o.z};
+    const double zero[4] = {};
+    for (size_t i = first; i < last; ++i) {
+        const double *a = in[i].m;
+        float *b = out[i].m;
+        for (int r = 0; r < 3; ++r) {
+            const double t[4] = {d[r] * a[12], d[r] * a[13], d[r] * a[14], d[r] * a[15]};
+            simd::store(b + 4 * r, simd::sub_cvt(a + 4 * r, t));
+        }
+        simd::store(b + 12, simd::sub_cvt(a + 12, zero));
+    }
+}
+
+
+
+/**
+* @brief in[i] * translation(-o) を[first, last)についてfloatで出力します (row_majorの配置)
+* @details 列jから o_j * (4列目) を差し引きます
+**/
+template <class Ty>
+void relative_row(const matrix4x4<Ty> *in, vector3<Ty> o, matrix4x4<float> *out, size_t first, size_t last) noexcept {
+    const Ty d[4] = {o.x, o.y, o.z, static_cast<Ty>(0)};
+    for (size_t i = first; i < last; ++i) {
+        const Ty *a = in[i].m;
+        float *b = out[i].m;
+        for (int r = 0; r < 4; ++r) {
+            for (int j = 0; j < 4; ++j) { b[4 * r + j] = static_cast<float>(a[4 * r + j] - d[j] * a[4 * r + 3]); }
+        }
+    }
+}
+
+
+inline void relative_row(const matrix4x4<double> *in, vector3<double> o, matrix4x4<float> *out, size_t first, size_t last) noexcept {
+    for (size_t i = first; i < last; ++i) {
+        const double *a = in[i].m;
+        float *b = out[i].m;
+        for (int r = 0; r < 4; ++r) {
+            const double w = a[4 * r + 3];
+            const double t[4] = {o.x * w, o.y * w, o.z * w, 0.0};
+            simd::store(b + 4 * r, simd::sub_cvt(a + 4 * r, t));
+        }
+    }
+}
+
+} // namespace detail
+
+
+
+
+/**
+* @brief SoA配列の位置からoriginを差し引き、floatで出力します
+* @param[in]  x, y, z  入力座標の配列
+* @param[in]  origin   基準点 (通常はカメラの位置)
+* @param[out] ox, oy, oz 出力座標の配列
+* @param[in]  n        点の数
+* @param[in]  threads  スレッド数 (1で呼び出しスレッドのみ、0でハードウェアスレッド数)
+* @return none
+* @exception none
+**/
+template <class Ty>
+void relative(const Ty *x, const Ty *y, const Ty *z, const vector3<Ty> &origin,
+              float *ox, float *oy, float *oz,
+              size_t n, size_t threads = 1) {
+    parallel_for(n, threads, [&](size_t first, size_t last) {
+        detail::relative_soa(x, y, z, origin, ox, oy, oz, first, last);
+    }, 4096);
+}
+
+
+/**
+* @brief AoS配列の位置からoriginを差し引き、floatで出力します
+* @param[in]  in      入力座標の配列
+* @param[in]  origin  基準点
+* @param[out] out     出力座標の配列
+* @param[in]  n       点の数
+* @param[in]  threads スレッド数
+* @return none
+* @exception none
+**/
+template <class Ty>
+void relative(const vector3<Ty> *in, const vector3<Ty> &origin, vector3<float> *out, size_t n, size_t threads = 1) {
+    parallel_for(n, threads, [&](size_t first, size_t last) {
+        detail::relative_aos(in, origin, out, first, last);
+    }, 4096);
+}
+
+
+
+
+namespace column_major {
+
+/**
+* @brief ワールド行列の配列をoriginを原点とする座標系へ移し、floatで出力します
+* @details out[i] = translation(-origin) * in[i] をTyの精度で計算してから丸めます
+* @param[in]  in      ワールド行列の配列
+* @param[in]  origin  基準点 (通常はカメラの位置)
+* @param[out] out     出力先
+* @param[in]  n       行列の数
+* @param[in]  threads スレッド数
+* @return none
+* @exception none
+**/
+template <class Ty>
+void relative(const matrix4x4<Ty> *in, const vector3<Ty> &origin, matrix4x4<float> *out, size_t n, size_t threads = 1) {
+    parallel_for(n, threads, [&](size_t first, size_t last) {
+        detail::relative_column(in, origin, out, first, last);
+    });
+}
+
+
+/**
+* @brief ワールド行列の配列をoriginを基準に丸め、floatの行列mを左から乗算します
+* @details out[i] = m * float(translation(-origin) * in[i]) です
+*          mにはrelative_matrix(camera)等のカメラ基準のビュー・射影行列を指定します
+**/
+template <class Ty>
+void relative(const matrix4x4<float> &m, const matrix4x4<Ty> *in, const vector3<Ty> &origin,
+              matrix4x4<float> *out, size_t n, size_t threads = 1) {
+    parallel_for(n, threads, [&](size_t first, size_t last) {
+        for (size_t b = first; b < last; b += 64) {
+            const size_t e = std::min(b + 64, last);
+            detail::relative_column(in, origin, out, b, e);
+            for (size_t i = b; i < e; ++i) { out[i] = m * out[i]; }
+        }
+    });
+}
+
+
+namespace right_hand {
+
+/**
+* @brief カメラを原点に置いたビュー行列をfloatで取得します
+* @details 回転のみの行列になり、位置はrelative()でカメラ基準に変換したものを使います
+* @param[in] c カメラ
+* @return ビュー行列
+* @exception none
+**/
+template <class Ty>
+matrix4x4<float> relative_view(const camera<Ty> &c) noexcept {
+    return detail::downcast(look_at(vector3<Ty>{}, c.get_dst() - c.get_pos(), c.get_up()));
+}
+
+
+/**
+* @brief カメラを原点に置いたビュー・射影行列をfloatで取得します
+* @details Tyの精度で乗算してから丸めます
+**/
+template <class Ty>
+matrix4x4<float> relative_matrix(const camera<Ty> &c) noexcept {
+    return detail::downcast(projection(c) * look_at(vector3<Ty>{}, c.get_dst() - c.get_pos(), c.get_up()));
+}
+
+
+/**
+* @brief ワールド行列の配列からカメラ基準のfloatのビュー・射影・ワールド行列を一括で作成します
+* @param[in]  c       カメラ
+* @param[in]  in      ワールド行列の配列
+* @param[out] out     出力先
+* @param[in]  n       行列の数
+* @param[in]  threads スレッド数
+* @return none
+* @exception none
+**/
+template <class Ty>
+void relative(const camera<Ty> &c, const matrix4x4<Ty> *in, matrix4x4<float> *out, size_t n, size_t threads = 1) {
+    column_major::relative(relative_matrix(c), in, c.get_pos(), out, n, threads);
+}
+
+} // namespace right_hand
+
+
+namespace left_hand {
+
+template <class Ty>
+matrix4x4<float> relative_view(const camera<Ty> &c) noexcept {
+    return detail::downcast(look_at(vector3<Ty>{}, c.get_dst() - c.get_pos(), c.get_up()));
+}
+
+
+template <class Ty>
+matrix4x4<float> relative_matrix(const camera<Ty> &c) noexcept {
+    return detail::downcast(projection(c) * look_at(vector3<Ty>{}, c.get_dst() - c.get_pos(), c.get_up()));
+}
+
+
+template <class Ty>
+void relative(const camera<Ty> &c, const matrix4x4<Ty> *in, matrix4x4<float> *out, size_t n, size_t threads = 1) {
+    column_major::relative(relative_matrix(c), in, c.get_pos(), out, n, threads);
+}
+
+} // namespace left_hand
+} // namespace column_major
+
+
+
+
+namespace row_major {
+
+/**
+* @brief ワールド行列の配列をoriginを原点とする座標系へ移し、floatで出力します
+* @details out[i] = in[i] * translation(-origin) です。引数はcolumn_major::relativeと同じです
+**/
+template <class Ty>
+void relative(const matrix4x4<Ty> *in, const vector3<Ty> &origin, matrix4x4<float> *out, size_t n, size_t threads = 1) {
+    parallel_for(n, threads, [&](size_t first, size_t last) {
+        detail::relative_row(in, origin, out, first, last);
+    });
+}
+
+
+/**
+* @brief ワールド行列の配列をoriginを基準に丸め、floatの行列mを右から乗算します
+* @details out[i] = float(in[i] * translation(-origin)) * m です
+**/
+template <class Ty>
+void relative(const matrix4x4<float> &m, const matrix4x4<Ty> *in, const vector3<Ty> &origin,
+              matrix4x4<float> *out, size_t n, size_t threads = 1) {
+    parallel_for(n, threads, [&](size_t first, size_t last) {
+        for (size_t b = first; b < last; b += 64) {
+            const size_t e = std::min(b + 64, last);
+            detail::relative_row(in, origin, out, b, e);
+            for (size_t i = b; i < e; ++i) { out[i] = out[i] * m; }
+        }
+    });
+}
+
+
+namespace right_hand {
+
+template <class Ty>
+matrix4x4<float> relative_view(const camera<Ty> &c) noexcept {
+    return detail::downcast(look_at(vector3<Ty>{}, c.get_dst() - c.get_pos(), c.get_up()));
+}
+
+
+template <class Ty>
+matrix4x4<float> relative_matrix(const camera<Ty> &c) noexcept {
+    return detail::downcast(look_at(vector3<Ty>{}, c.get_dst() - c.get_pos(), c.get_up()) * projection(c));
+}
+
+
+template <class Ty>
+void relative(const camera<Ty> &c, const matrix4x4<Ty> *in, matrix4x4<float> *out, size_t n, size_t threads = 1) {
+    row_major::relative(relative_matrix(c), in, c.get_pos(), out, n, threads);
+}
+
+} // namespace right_hand
+
+
+namespace left_hand {
+
+template <class Ty>
+matrix4x4<float> relative_view(const camera<Ty> &c) noexcept {
+    return detail::downcast(look_at(vector3<Ty>{}, c.get_dst() - c.get_pos(), c.get_up()));
+}
+
+
+template <class Ty>
+matrix4x4<float> relative_matrix(const camera<Ty> &c) noexcept {
+    return detail::downcast(look_at(vector3<Ty>{}, c.get_dst() - c.get_pos(), c.get_up()) * projection(c));
+}
+
+
+template <class Ty>
+void relative(const camera<Ty> &c, const matrix4x4<Ty> *in, matrix4x4<float> *out, size_t n, size_t threads = 1) {
+    row_major::relative(relative_matrix(c), in, c.get_pos(), out, n, threads);
+}
+
+} // namespace left_hand
+} // namespace row_major
+} // namespace gdv
+
+#endif
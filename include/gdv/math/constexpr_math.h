@@ -0,0 +1,95 @@
+/**
+* @file constexpr_math.h
+* @brief 定数式で評価できる三角関数と、それを使うポリシー
+* @details constexpr_mathをrotate_x等のテンプレート引数 Math に指定すると、回転行列をコンパイル時に作成できます
+*          内部はdouble (long doubleの場合はlong double) で計算し、|x| < 2^20 で誤差は1～2ulp程度です
+**/
+#ifndef GDV_CONSTEXPR_MATH_H_
+#define GDV_CONSTEXPR_MATH_H_
+
+#include <type_traits>
+
+namespace gdv {
+namespace detail {
+
+template <class Ty>
+using constexpr_real = typename std::conditional<(sizeof(Ty) > sizeof(double)), Ty, double>::type;
+
+
+// [-π/4, π/4]のテイラー展開
+template <class Ty>
+constexpr Ty constexpr_sin_series(Ty r) noexcept {
+    const Ty r2 = r * r;
+    Ty term = r, sum = r;
+    for (int i = 2; i < 22; i += 2) {
+        term *= -r2 / static_cast<Ty>(i * (i + 1));
+        sum += term;
+    }
+    return sum;
+}
+
+
+template <class Ty>
+constexpr Ty constexpr_cos_series(Ty r) noexcept {
+    const Ty r2 = r * r;
+    Ty term = static_cast<Ty>(1), sum = static_cast<Ty>(1);
+    for (int i = 1; i < 21; i += 2) {
+        term *= -r2 / static_cast<Ty>(i * (i + 1));
+        sum += term;
+    }
+    return sum;
+}
+
+
+/**
+* @brief x = r + qπ/2 (|r| <= π/4) と分解し、qを4で割った余りを返します
+**/
+template <class Ty>
+constexpr int constexpr_reduce(Ty x, Ty &r) noexcept {
+    // π/2の3分割 (上位2つは下位ビットが0なので q との積が丸められない)
+    constexpr Ty pio2_1 = static_cast<Ty>(1.57079632673412561417e+00);
+    constexpr Ty pio2_2 = static_cast<Ty>(6.07710050630396597660e-11);
+    constexpr Ty pio2_3 = static_cast<Ty>(2.02226624879595063154e-21);
+    const Ty t = x * static_cast<Ty>(0.63661977236758134308);
+    const long long q = static_cast<long long>(t < static_cast<Ty>(0) ? t - static_cast<Ty>(0.5) : t + static_cast<Ty>(0.5));
+    r = ((x - static_cast<Ty>(q) * pio2_1) - static_cast<Ty>(q) * pio2_2) - static_cast<Ty>(q) * pio2_3;
+    return static_cast<int>(q & 3);
+}
+
+} // namespace detail
+
+
+
+
+/**
+* @brief 定数式で評価できる関数を使うポリシーです
+**/
+struct constexpr_math {
+    template <class Ty>
+    static constexpr Ty sin(Ty x) noexcept {
+        using real = detail::constexpr_real<Ty>;
+        real r = 0;
+        const int q = detail::constexpr_reduce(static_cast<real>(x), r);
+        const real v = (q & 1) ? detail::constexpr_cos_series(r) : detail::constexpr_sin_series(r);
+        return static_cast<Ty>(q & 2 ? -v : v);
+    }
+
+    template <class Ty>
+    static constexpr Ty cos(Ty x) noexcept {
+        using real = detail::constexpr_real<Ty>;
+        real r = 0;
+        const int q = detail::constexpr_reduce(static_cast<real>(x), r);
+        const real v = (q & 1) ? detail::constexpr_sin_series(r) : detail::constexpr_cos_series(r);
+        return static_cast<Ty>(((q + 1) & 2) ? -v : v);
+    }
+
+    template <class Ty>
+    static constexpr void sincos(Ty x, Ty &s, Ty &c) noexcept {
+        s = sin(x);
+        c = cos(x);
+    }
+};
+
+} // namespace gdv
+
+#endif
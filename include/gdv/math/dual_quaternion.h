@@ -0,0 +1,489 @@
+/**
+* @file dual_quaternion.h
+* @brief 剛体変換を表現するデュアルクォータニオンと、頂点の一括スキニング関数の宣言
+**/
+#ifndef GDV_DUAL_QUATERNION_H_
+#define GDV_DUAL_QUATERNION_H_
+
+#include <cmath>
+#include <type_traits>
+#include <gdv/math/vector3.h>
+#include <gdv/math/matrix4x4.h>
+#include <gdv/math/quaternion.h>
+#include <gdv/math/affine3.h>
+#include <gdv/math/simd.h>
+#include <gdv/tools/parallel.h>
+
+namespace gdv {
+namespace detail {
+
+// ハミルトン積 q1 * q2 (q2を先に適用) を求めます
+template <class Ty>
+quaternion<Ty> hamilton(quaternion<Ty> q1, quaternion<Ty> q2) noexcept {
+    return {
+        q1.t * q2.t - q1.x * q2.x - q1.y * q2.y - q1.z * q2.z,
+        q1.t * q2.x + q1.x * q2.t + q1.y * q2.z - q1.z * q2.y,
+        q1.t * q2.y + q1.y * q2.t + q1.z * q2.x - q1.x * q2.z,
+        q1.t * q2.z + q1.z * q2.t + q1.x * q2.y - q1.y * q2.x,
+    };
+}
+
+} // namespace detail
+
+
+
+
+/**
+* @class dual_quaternion
+* @tparam Ty 浮動小数点型のみ受付ます
+* @brief 回転 (real) と平行移動 (dual) を8要素で表す剛体変換です
+* @details 点pは回転してから平行移動され、回転はクォータニオンのq * pと同じ向きです
+*          行列と異なり拡大縮小は表現できません
+*          重み付きの和を正規化しても剛体変換のままであるため、スキニングで体積が潰れません
+**/
+template <class Ty>
+class dual_quaternion {
+    static_assert(std::is_floating_point<Ty>::value, "invalid template parameter.");
+
+public:
+
+    dual_quaternion() noexcept :
+        real{}, dual{} {}
+
+
+    dual_quaternion(quaternion<Ty> real, quaternion<Ty> dual) noexcept :
+        real{real}, dual{dual} {}
+
+
+    /**
+    * @brief 回転と移動量から作成します
+    * @param[in] rotation    回転 (単位クォータニオン)
+    * @param[in] translation 回転後に加える移動量
+    * @return none
+    * @exception none
+    **/
+    dual_quaternion(quaternion<Ty> rotation, vector3<Ty> translation) noexcept :
+        real{rotation},
+        dual{detail::hamilton(quaternion<Ty>{
+            static_cast<Ty>(0),
+            translation.x * static_cast<Ty>(0.5),
+            translation.y * static_cast<Ty>(0.5),
+            translation.z * static_cast<Ty>(0.5)}, rotation)} {}
+
+
+    dual_quaternion(const dual_quaternion<Ty> &q) noexcept = default;
+
+
+    dual_quaternion<Ty>& operator = (const dual_quaternion<Ty> &q) noexcept = default;
+
+
+    quaternion<Ty> rotation() const noexcept {return real;}
+
+
+    vector3<Ty> translation() const noexcept {
+        constexpr Ty _2 = static_cast<Ty>(2);
+        const quaternion<Ty> t = detail::hamilton(dual, quaternion<Ty>{real.t, -real.x, -real.y, -real.z});
+        return {t.x * _2, t.y * _2, t.z * _2};
+    }
+
+
+public:
+    quaternion<Ty> real;
+    quaternion<Ty> dual;
+};
+
+
+
+
+/**
+* @brief 恒等変換を作成します
+* @tparam Ty 浮動小数点型のみ受付ます
+* @return dual_quaternion<Ty>
+* @exception none
+**/
+template <class Ty>
+dual_quaternion<Ty> unit_dual_quaternion() noexcept {
+    constexpr Ty _0 = static_cast<Ty>(0);
+    constexpr Ty _1 = static_cast<Ty>(1);
+    return {quaternion<Ty>{_1, _0, _0, _0}, quaternion<Ty>{_0, _0, _0, _0}};
+}
+
+
+
+/**
+* @brief 変換を合成します (a * b はbを適用した後にaを適用します)
+**/
+template <class Ty>
+dual_quaternion<Ty> operator * (const dual_quaternion<Ty> &a, const dual_quaternion<Ty> &b) noexcept {
+    const quaternion<Ty> d1 = detail::hamilton(a.real, b.dual);
+    const quaternion<Ty> d2 = detail::hamilton(a.dual, b.real);
+    return {detail::hamilton(a.real, b.real), quaternion<Ty>{d1.t + d2.t, d1.x + d2.x, d1.y + d2.y, d1.z + d2.z}};
+}
+
+
+
+/**
+* @brief 実部の長さを1にし、双対部を実部と直交させます
+* @tparam Ty 浮動小数点型のみ受付ます
+* @param[in] q 対象の値 (実部は0でない必要があります)
+* @return dual_quaternion<Ty>
+* @exception none
+**/
+template <class Ty>
+dual_quaternion<Ty> normalize(const dual_quaternion<Ty> &q) noexcept {
+    const Ty r = static_cast<Ty>(1) / std::sqrt(dot(q.real, q.real));
+    const quaternion<Ty> a{q.real.t * r, q.real.x * r, q.real.y * r, q.real.z * r};
+    const quaternion<Ty> b{q.dual.t * r, q.dual.x * r, q.dual.y * r, q.dual.z * r};
+    const Ty d = dot(a, b);
+    return {a, quaternion<Ty>{b.t - a.t * d, b.x - a.x * d, b.y - a.y * d, b.z - a.z * d}};
+}
+
+
+
+/**
+* @brief 点を変換します
+* @param[in] q 単位デュアルクォータニオン
+* @param[in] p 対象の点
+* @return vector3<Ty>
+* @exception none
+**/
+template <class Ty>
+vector3<Ty> transform_point(const dual_quaternion<Ty> &q, vector3<Ty> p) noexcept {
+    constexpr Ty _2 = static_cast<Ty>(2);
+    const quaternion<Ty> &r = q.real;
+    const quaternion<Ty> &d = q.dual;
+    const vector3<Ty> a{r.y * p.z - r.z * p.y + r.t * p.x,
+                        r.z * p.x - r.x * p.z + r.t * p.y,
+                        r.x * p.y - r.y * p.x + r.t * p.z};
+    const vector3<Ty> t{r.t * d.x - d.t * r.x + (r.y * d.z - r.z * d.y),
+                        r.t * d.y - d.t * r.y + (r.z * d.x - r.x * d.z),
+                        r.t * d.z - d.t * r.z + (r.x * d.y - r.y * d.x)};
+    return {
+        p.x + _2 * (r.y * a.z - r.z * a.y) + _2 * t.x,
+        p.y + _2 * (r.z * a.x - r.x * a.z) + _2 * t.y,
+        p.z + _2 * (r.x * a.y - r.y * a.x) + _2 * t.z,
+    };
+}
+
+
+
+/**
+* @brief 方向ベクトル (法線等) を回転だけで変換します
+**/
+template <class Ty>
+vector3<Ty> transform_vector(const dual_quaternion<Ty> &q, vector3<Ty> v) noexcept {
+    constexpr Ty _2 = static_cast<Ty>(2);
+    const quaternion<Ty> &r = q.real;
+    const vector3<Ty> a{r.y * v.z - r.z * v.y + r.t * v.x,
+                        r.z * v.x - r.x * v.z + r.t * v.y,
+                        r.x * v.y - r.y * v.x + r.t * v.z};
+    return {
+        v.x + _2 * (r.y * a.z - r.z * a.y),
+        v.y + _2 * (r.z * a.x - r.x * a.z),
+        v.z + _2 * (r.x * a.y - r.y * a.x),
+    };
+}
+
+
+
+/**
+* @brief 複数の変換を重み付きで合成します (dual quaternion linear blending)
+* @tparam Ty 浮動小数点型のみ受付ます
+* @param[in] q       変換の配列
+* @param[in] weights 重みの配列 (合計は1である必要はありません)
+* @param[in] count   要素数 (スキニングでは4または8)
+* @return 正規化した dual_quaternion<Ty>
+* @exception none
+* @details 実部が先頭の要素と逆向きの要素は符号を反転して加算し、最短経路で補間します
+**/
+template <class Ty>
+dual_quaternion<Ty> blend(const dual_quaternion<Ty> *q, const Ty *weights, size_t count) noexcept {
+    constexpr Ty _0 = static_cast<Ty>(0);
+    dual_quaternion<Ty> s{quaternion<Ty>{_0, _0, _0, _0}, quaternion<Ty>{_0, _0, _0, _0}};
+    for (size_t k = 0; k < count; ++k) {
+        const Ty w = dot(q[0].real, q[k].real) < _0 ? -weights[k] : weights[k];
+        s.real.t += q[k].real.t * w;
+        s.real.x += q[k].real.x * w;
+        s.real.y += q[k].real.y * w;
+        s.real.z += q[k].real.z * w;
+        s.dual.t += q[k].dual.t * w;
+        s.dual.x += q[k].dual.x * w;
+        s.dual.y += q[k].dual.y * w;
+        s.dual.z += q[k].dual.z * w;
+    }
+    return normalize(s);
+}
+
+
+
+/**
+* @brief アフィン変換の回転と平行移動を取り出します
+* @details 線形部分は拡大縮小を含まない回転である必要があります
+**/
+template <class Ty>
+dual_quaternion<Ty> to_dual_quaternion(const affine3<Ty> &a) noexcept {
+    return {
+        detail::to_quaternion(a.m[0], a.m[1], a.m[ 2],
+                              a.m[4], a.m[5], a.m[ 6],
+                              a.m[8], a.m[9], a.m[10]),
+        vector3<Ty>{a.m[3], a.m[7], a.m[11]}
+    };
+}
+
+
+
+
+namespace detail {
+
+/**
+* @brief [first, last)の頂点をスキニングします
+* @details 頂点iの影響ボーンはindices[i * influences + k]、重みはweights[i * influences + k]です
+*          nor、out_norがnullptrの場合は法線を処理しません
+**/
+template <class Ty, class Index>
+void skin(const dual_quaternion<Ty> *bones, const Index *indices, const Ty *weights, size_t influences,
+          const vector3<Ty> *pos, vector3<Ty> *out_pos, const vector3<Ty> *nor, vector3<Ty> *out_nor,
+          size_t first, size_t last) noexcept {
+    constexpr Ty _0 = static_cast<Ty>(0);
+    for (size_t i = first; i < last; ++i) {
+        const Index *index = indices + i * influences;
+        const Ty *weight = weights + i * influences;
+        const dual_quaternion<Ty> &b0 = bones[index[0]];
+        dual_quaternion<Ty> s{quaternion<Ty>{_0, _0, _0, _0}, quaternion<Ty>{_0, _0, _0, _0}};
+        for (size_t k = 0; k < influences; ++k) {
+            const dual_quaternion<Ty> &b = bones[index[k]];
+            const Ty w = dot(b0.real, b.real) < _0 ? -weight[k] : weight[k];
+            s.real.t = b.real.t * w + s.real.t;
+            s.real.x = b.real.x * w + s.real.x;
+            s.real.y = b.real.y * w + s.real.y;
+            s.real.z = b.real.z * w + s.real.z;
+            s.dual.t = b.dual.t * w + s.dual.t;
+            s.dual.x = b.dual.x * w + s.dual.x;
+            s.dual.y = b.dual.y * w + s.dual.y;
+            s.dual.z = b.dual.z * w + s.dual.z;
+        }
+        // 点の変換では実部と双対部の直交化は不要なため、長さだけを正規化します
+        const Ty r = static_cast<Ty>(1) / std::sqrt(dot(s.real, s.real));
+        const dual_quaternion<Ty> q{
+            quaternion<Ty>{s.real.t * r, s.real.x * r, s.real.y * r, s.real.z * r},
+            quaternion<Ty>{s.dual.t * r, s.dual.x * r, s.dual.y * r, s.dual.z * r}};
+        out_pos[i] = transform_point(q, pos[i]);
+        if (nor) { out_nor[i] = transform_vector(q, nor[i]); }
+    }
+}
+
+
+// 4頂点ずつ、影響ボーンを転置してレーンに並べてから合成します
+template <class Index>
+void skin(const dual_quaternion<float> *bones, const Index *indices, const float *weights, size_t influences,
+          const vector3<float> *pos, vector3<float> *out_pos, const vector3<float> *nor, vector3<float> *out_nor,
+          size_t first, size_t last) noexcept {
+    static_assert(sizeof(dual_quaternion<float>) == sizeof(float) * 8, "unexpected padding.");
+    const simd::float4 zero = simd::zero();
+    const simd::float4 one = simd::splat(1.0f);
+    const simd::float4 two = simd::splat(2.0f);
+    alignas(16) float ox[4], oy[4], oz[4];
+
+    auto cross = [](simd::float4 ax, simd::float4 ay, simd::float4 az,
+                    simd::float4 bx, simd::float4 by, simd::float4 bz,
+                    simd::float4 &cx, simd::float4 &cy, simd::float4 &cz) {
+        cx = simd::sub(simd::mul(ay, bz), simd::mul(az, by));
+        cy = simd::sub(simd::mul(az, bx), simd::mul(ax, bz));
+        cz = simd::sub(simd::mul(ax, by), simd::mul(ay, bx));
+    };
+
+    size_t i = first;
+    for (; i + 4 <= last; i += 4) {
+        simd::float4 rt = zero, rx = zero, ry = zero, rz = zero;
+        simd::float4 dt = zero, dx = zero, dy = zero, dz = zero;
+        simd::float4 ft = zero, fx = zero, fy = zero, fz = zero;
+        for (size_t k = 0; k < influences; ++k) {
+            const dual_quaternion<float> &b0 = bones[indices[(i    ) * influences + k]];
+            const dual_quaternion<float> &b1 = bones[indices[(i + 1) * influences + k]];
+            const dual_quaternion<float> &b2 = bones[indices[(i + 2) * influences + k]];
+            const dual_quaternion<float> &b3 = bones[indices[(i + 3) * influences + k]];
+            simd::float4 qt = simd::loadu(&b0.real.t), qx = simd::loadu(&b1.real.t);
+            simd::float4 qy = simd::loadu(&b2.real.t), qz = simd::loadu(&b3.real.t);
+            simd::float4 pt = simd::loadu(&b0.dual.t), px = simd::loadu(&b1.dual.t);
+            simd::float4 py = simd::loadu(&b2.dual.t), pz = simd::loadu(&b3.dual.t);
+            simd::transpose(qt, qx, qy, qz);
+            simd::transpose(pt, px, py, pz);
+            if (k == 0) {
+                ft = qt; fx = qx; fy = qy; fz = qz;
+            }
+
+            const simd::float4 d = simd::add(simd::add(simd::add(simd::mul(ft, qt), simd::mul(fx, qx)), simd::mul(fy, qy)), simd::mul(fz, qz));
+            simd::float4 w = simd::set(weights[(i    ) * influences + k], weights[(i + 1) * influences + k],
+                                       weights[(i + 2) * influences + k], weights[(i + 3) * influences + k]);
+            w = simd::select(simd::less(d, zero), simd::sub(zero, w), w);
+            rt = simd::madd(qt, w, rt); rx = simd::madd(qx, w, rx);
+            ry = simd::madd(qy, w, ry); rz = simd::madd(qz, w, rz);
+            dt = simd::madd(pt, w, dt); dx = simd::madd(px, w, dx);
+            dy = simd::madd(py, w, dy); dz = simd::madd(pz, w, dz);
+        }
+
+        const simd::float4 l = simd::add(simd::add(simd::add(simd::mul(rt, rt), simd::mul(rx, rx)), simd::mul(ry, ry)), simd::mul(rz, rz));
+        const simd::float4 r = simd::div(one, simd::sqrt(l));
+        rt = simd::mul(rt, r); rx = simd::mul(rx, r); ry = simd::mul(ry, r); rz = simd::mul(rz, r);
+        dt = simd::mul(dt, r); dx = simd::mul(dx, r); dy = simd::mul(dy, r); dz = simd::mul(dz, r);
+
+        // t = r.t * d.v - d.t * r.v + cross(r.v, d.v)
+        simd::float4 tx, ty, tz;
+        cross(rx, ry, rz, dx, dy, dz, tx, ty, tz);
+        tx = simd::add(simd::sub(simd::mul(rt, dx), simd::mul(dt, rx)), tx);
+        ty = simd::add(simd::sub(simd::mul(rt, dy), simd::mul(dt, ry)), ty);
+        tz = simd::add(simd::sub(simd::mul(rt, dz), simd::mul(dt, rz)), tz);
+
+        auto rotate = [&](const vector3<float> *in, vector3<float> *out, bool translate) {
+            const simd::float4 vx = simd::set(in[i].x, in[i + 1].x, in[i + 2].x, in[i + 3].x);
+            const simd::float4 vy = simd::set(in[i].y, in[i + 1].y, in[i + 2].y, in[i + 3].y);
+            const simd::float4 vz = simd::set(in[i].z, in[i + 1].z, in[i + 2].z, in[i + 3].z);
+            simd::float4 ax, ay, az, cx, cy, cz;
+            cross(rx, ry, rz, vx, vy, vz, ax, ay, az);
+            ax = simd::add(ax, simd::mul(rt, vx));
+            ay = simd::add(ay, simd::mul(rt, vy));
+            az = simd::add(az, simd::mul(rt, vz));
+            cross(rx, ry, rz, ax, ay, az, cx, cy, cz);
+            simd::float4 x = simd::add(vx, simd::mul(two, cx));
+            simd::float4 y = simd::add(vy, simd::mul(two, cy));
+            simd::float4 z = simd::add(vz, simd::mul(two, cz));
+            if (translate) {
+                x = simd::add(x, simd::mul(two, tx));
+                y = simd::add(y, simd::mul(two, ty));
+                z = simd::add(z, simd::mul(two, tz));
+            }
+            simd::store(ox, x);
+            simd::store(oy, y);
+            simd::store(oz, z);
+            for (int j = 0; j < 4; ++j) { out[i + j] = {ox[j], oy[j], oz[j]}; }
+        };
+        rotate(pos, out_pos, true);
+        if (nor) { rotate(nor, out_nor, false); }
+    }
+    detail::skin<float, Index>(bones, indices, weights, influences, pos, out_pos, nor, out_nor, i, last);
+}
+
+} // namespace detail
+
+
+
+
+/**
+* @brief 頂点をデュアルクォータニオンで一括スキニングします
+* @tparam Ty    浮動小数点型のみ受付ます
+* @tparam Index ボーン番号の型 (uint8_t、uint16_t等)
+* @param[in]  bones      ボーンの変換の配列 (バインドポーズの逆変換を合成済みのもの)
+* @param[in]  indices    頂点ごとの影響ボーン番号 (頂点数 * influences)
+* @param[in]  weights    頂点ごとの重み (頂点数 * influences)
+* @param[in]  influences 1頂点あたりの影響ボーン数 (4または8を想定)
+* @param[in]  pos        頂点座標の配列
+* @param[out] out_pos    変換後の頂点座標の配列
+* @param[in]  n          頂点数
+* @param[in]  threads    スレッド数 (1で呼び出しスレッドのみ、0でハードウェアスレッド数)
+* @return none
+* @exception none
+* @details 使われない影響は重み0として、任意のボーン番号を指定してください
+*          floatは4頂点ずつSIMDで処理されます
+**/
+template <class Ty, class Index>
+void skin(const dual_quaternion<Ty> *bones, const Index *indices, const Ty *weights, size_t influences,
+          const vector3<Ty> *pos, vector3<Ty> *out_pos, size_t n, size_t threads = 1) {
+    parallel_for(n, threads, [=](size_t first, size_t last) {
+        detail::skin(bones, indices, weights, influences, pos, out_pos,
+                     static_cast<const vector3<Ty>*>(nullptr), static_cast<vector3<Ty>*>(nullptr), first, last);
+    }, 1024);
+}
+
+
+/**
+* @brief 頂点座標と法線を一括スキニングします
+* @param[in]  nor     法線の配列
+* @param[out] out_nor 変換後の法線の配列
+**/
+template <class Ty, class Index>
+void skin(const dual_quaternion<Ty> *bones, const Index *indices, const Ty *weights, size_t influences,
+          const vector3<Ty> *pos, vector3<Ty> *out_pos, const vector3<Ty> *nor, vector3<Ty> *out_nor,
+          size_t n, size_t threads = 1) {
+    parallel_for(n, threads, [=](size_t first, size_t last) {
+        detail::skin(bones, indices, weights, influences, pos, out_pos, nor, out_nor, first, last);
+    }, 1024);
+}
+
+
+
+
+namespace column_major {
+
+/**
+* @brief 回転と平行移動だけを含む行列から作成します
+* @tparam Ty 浮動小数点型のみ受付ます
+* @param[in] m 拡大縮小を含まない行列 (m * v の形式)
+* @return dual_quaternion<Ty>
+* @exception none
+* @details 行列の作用 (m * v) と同じ変換になり、右手系と左手系の区別はありません
+**/
+template <class Ty>
+dual_quaternion<Ty> to_dual_quaternion(const matrix4x4<Ty> &m) noexcept {
+    return {
+        detail::to_quaternion(m.m[0], m.m[1], m.m[ 2],
+                              m.m[4], m.m[5], m.m[ 6],
+                              m.m[8], m.m[9], m.m[10]),
+        vector3<Ty>{m.m[3], m.m[7], m.m[11]}
+    };
+}
+
+
+/**
+* @brief 行列に変換します
+* @param[in] q 単位デュアルクォータニオン
+**/
+template <class Ty>
+matrix4x4<Ty> to_matrix(const dual_quaternion<Ty> &q) noexcept {
+    matrix4x4<Ty> m = left_hand::to_matrix(q.real);
+    const vector3<Ty> t = q.translation();
+    m.m[ 3] = t.x;
+    m.m[ 7] = t.y;
+    m.m[11] = t.z;
+    return m;
+}
+
+} // namespace column_major
+
+
+
+
+namespace row_major {
+
+/**
+* @brief 回転と平行移動だけを含む行列 (v * m の形式) から作成します
+**/
+template <class Ty>
+dual_quaternion<Ty> to_dual_quaternion(const matrix4x4<Ty> &m) noexcept {
+    return {
+        detail::to_quaternion(m.m[0], m.m[4], m.m[ 8],
+                              m.m[1], m.m[5], m.m[ 9],
+                              m.m[2], m.m[6], m.m[10]),
+        vector3<Ty>{m.m[12], m.m[13], m.m[14]}
+    };
+}
+
+
+template <class Ty>
+matrix4x4<Ty> to_matrix(const dual_quaternion<Ty> &q) noexcept {
+    matrix4x4<Ty> m = left_hand::to_matrix(q.real);
+    const vector3<Ty> t = q.translation();
+    m.m[12] = t.x;
+    m.m[13] = t.y;
+    m.m[14] = t.z;
+    return m;
+}
+
+} // namespace row_major
+
+
+
+using dual_rotation = dual_quaternion<float>;
+
+} // namespace gdv
+
+#endif
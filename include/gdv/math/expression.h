@@ -0,0 +1,264 @@
+/**
+* @file expression.h
+* @brief vector3、vector4、matrix4x4の要素ごとの演算を遅延評価する式テンプレートです
+* @details lazy()で包んだ値から始まる式は一時オブジェクトを作らず、代入時に1回で評価されます
+*          例: vec3 r = lazy(a) + lazy(b) * s - c;
+*          式は被演算子への参照を保持するため、autoで受けて被演算子より長く保持しないでください
+*          行列積は要素ごとの演算ではないため対象外です
+**/
+#ifndef GDV_EXPRESSION_H_
+#define GDV_EXPRESSION_H_
+
+#include <cstddef>
+#include <utility>
+#include <gdv/math/vector3.h>
+#include <gdv/math/vector4.h>
+#include <gdv/math/matrix4x4.h>
+
+namespace gdv {
+namespace expression {
+
+/**
+* @brief 式テンプレートが扱う型の要素数、要素の取り出し、組み立て方法を定義します
+**/
+template <class V>
+struct traits;
+
+template <class Ty>
+struct traits<vector3<Ty>> {
+    using value_type = Ty;
+    static constexpr size_t size = 3;
+
+    template <size_t I>
+    static constexpr Ty get(const vector3<Ty> &v) noexcept {
+        return I == 0 ? v.x : (I == 1 ? v.y : v.z);
+    }
+};
+
+template <class Ty>
+struct traits<vector4<Ty>> {
+    using value_type = Ty;
+    static constexpr size_t size = 4;
+
+    template <size_t I>
+    static constexpr Ty get(const vector4<Ty> &v) noexcept {
+        return I == 0 ? v.x : (I == 1 ? v.y : (I == 2 ? v.z : v.w));
+    }
+};
+
+template <class Ty>
+struct traits<matrix4x4<Ty>> {
+    using value_type = Ty;
+    static constexpr size_t size = 16;
+
+    template <size_t I>
+    static constexpr Ty get(const matrix4x4<Ty> &m) noexcept {
+        return m.m[I];
+    }
+};
+
+
+
+
+/**
+* @class node
+* @brief 式の基底クラス (CRTP)
+* @details Derivedはget<I>()でI番目の要素を返します
+*          Vへの変換時に全要素を1つの初期化子で組み立てるため、途中結果は保存されません
+**/
+template <class Derived, class V>
+class node {
+public:
+    using value_type = typename traits<V>::value_type;
+    using result_type = V;
+
+    constexpr const Derived& self() const noexcept {return static_cast<const Derived&>(*this);}
+
+    constexpr V eval() const noexcept {
+        return make(std::make_index_sequence<traits<V>::size>{});
+    }
+
+    constexpr operator V() const noexcept {return eval();}
+
+private:
+    template <size_t... I>
+    constexpr V make(std::index_sequence<I...>) const noexcept {
+        return V{self().template get<I>()...};
+    }
+};
+
+
+
+template <class V>
+class terminal : public node<terminal<V>, V> {
+public:
+    constexpr explicit terminal(const V &v) noexcept : v_{v} {}
+
+    template <size_t I>
+    constexpr typename traits<V>::value_type get() const noexcept {return traits<V>::template get<I>(v_);}
+
+private:
+    const V &v_;
+};
+
+
+
+template <class L, class R, class Op, class V>
+class binary : public node<binary<L, R, Op, V>, V> {
+public:
+    constexpr binary(const L &l, const R &r) noexcept : l_{l}, r_{r} {}
+
+    template <size_t I>
+    constexpr typename traits<V>::value_type get() const noexcept {
+        return Op::apply(l_.template get<I>(), r_.template get<I>());
+    }
+
+private:
+    L l_;
+    R r_;
+};
+
+
+
+template <class L, class Op, class V>
+class scalar : public node<scalar<L, Op, V>, V> {
+public:
+    using value_type = typename traits<V>::value_type;
+
+    constexpr scalar(const L &l, value_type s) noexcept : l_{l}, s_{s} {}
+
+    template <size_t I>
+    constexpr value_type get() const noexcept {
+        return Op::apply(l_.template get<I>(), s_);
+    }
+
+private:
+    L l_;
+    value_type s_;
+};
+
+
+
+template <class L, class V>
+class negate : public node<negate<L, V>, V> {
+public:
+    constexpr explicit negate(const L &l) noexcept : l_{l} {}
+
+    template <size_t I>
+    constexpr typename traits<V>::value_type get() const noexcept {return -l_.template get<I>();}
+
+private:
+    L l_;
+};
+
+
+
+struct plus {
+    template <class Ty>
+    static constexpr Ty apply(Ty a, Ty b) noexcept {return a + b;}
+};
+
+struct minus {
+    template <class Ty>
+    static constexpr Ty apply(Ty a, Ty b) noexcept {return a - b;}
+};
+
+struct multiplies {
+    template <class Ty>
+    static constexpr Ty apply(Ty a, Ty b) noexcept {return a * b;}
+};
+
+struct divides {
+    template <class Ty>
+    static constexpr Ty apply(Ty a, Ty b) noexcept {return a / b;}
+};
+
+
+
+
+/**
+* @brief 値を式テンプレートの終端に変換します
+* @param[in] v 対象の値 (式の評価が終わるまで有効である必要があります)
+* @return 終端の式
+* @exception none
+**/
+template <class V>
+constexpr terminal<V> lazy(const V &v) noexcept {return terminal<V>{v};}
+
+
+
+
+template <class L, class R, class V>
+constexpr binary<L, R, plus, V> operator + (const node<L, V> &l, const node<R, V> &r) noexcept {
+    return {l.self(), r.self()};
+}
+
+template <class L, class V>
+constexpr binary<L, terminal<V>, plus, V> operator + (const node<L, V> &l, const V &r) noexcept {
+    return {l.self(), terminal<V>{r}};
+}
+
+template <class R, class V>
+constexpr binary<terminal<V>, R, plus, V> operator + (const V &l, const node<R, V> &r) noexcept {
+    return {terminal<V>{l}, r.self()};
+}
+
+
+template <class L, class R, class V>
+constexpr binary<L, R, minus, V> operator - (const node<L, V> &l, const node<R, V> &r) noexcept {
+    return {l.self(), r.self()};
+}
+
+template <class L, class V>
+constexpr binary<L, terminal<V>, minus, V> operator - (const node<L, V> &l, const V &r) noexcept {
+    return {l.self(), terminal<V>{r}};
+}
+
+template <class R, class V>
+constexpr binary<terminal<V>, R, minus, V> operator - (const V &l, const node<R, V> &r) noexcept {
+    return {terminal<V>{l}, r.self()};
+}
+
+
+template <class L, class V>
+constexpr negate<L, V> operator - (const node<L, V> &l) noexcept {
+    return negate<L, V>{l.self()};
+}
+
+
+template <class L, class V>
+constexpr scalar<L, multiplies, V> operator * (const node<L, V> &l, typename traits<V>::value_type s) noexcept {
+    return {l.self(), s};
+}
+
+template <class L, class V>
+constexpr scalar<L, multiplies, V> operator * (typename traits<V>::value_type s, const node<L, V> &l) noexcept {
+    return {l.self(), s};
+}
+
+template <class L, class V>
+constexpr scalar<L, divides, V> operator / (const node<L, V> &l, typename traits<V>::value_type s) noexcept {
+    return {l.self(), s};
+}
+
+
+
+
+/**
+* @brief 式を評価して代入先に加算します
+* @details 代入先が式の中で参照されていても、全要素を評価してから書き込むため安全です
+**/
+template <class E, class V>
+V& operator += (V &v, const node<E, V> &e) noexcept {
+    return v = lazy(v) + e.self();
+}
+
+template <class E, class V>
+V& operator -= (V &v, const node<E, V> &e) noexcept {
+    return v = lazy(v) - e.self();
+}
+
+} // namespace expression
+} // namespace gdv
+
+#endif
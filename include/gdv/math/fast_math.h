@@ -0,0 +1,384 @@
+/**
+* @file fast_math.h
+* @brief 多項式近似による高速な初等関数と、標準ライブラリとの切り替え用のポリシー
+* @details gdv::fastの関数はNaNの判定を除いて分岐を持たず、同じ式をsimd::float4でも計算できます
+*          floatでの誤差 (標準ライブラリとの差の最大値、実測) は次のとおりです
+*          - sin, cos : |x| <= 8192 で絶対誤差 2.5e-7 以下
+*          - exp      : 相対誤差 2.5e-7 以下 (x > -87.3、x < 88.3 の範囲、範囲外は0または約2^127)
+*          - exp2     : 相対誤差 2.5e-7 以下 (x > -126、x < 127 の範囲、範囲外は0または2^127)
+*          - atan2    : 絶対誤差 3e-7 以下 (実測 2.7e-7、atan2(0, 0)は0)
+*          - asin     : 絶対誤差 5e-7 以下
+*          doubleでも同じ多項式を使うため、精度はfloatと同程度です
+*          sin, cos, atan2はスカラでも標準ライブラリより高速です
+*          expのスカラ版は標準ライブラリと同程度で、simd::float4版を使うと高速になります
+*          スカラ版のexp、exp2はNaNをそのまま返し、simd::float4版のexpはNaNに対して0を返します
+*          -ffast-mathでは丸めの手法が成立しないため、使用しないでください
+**/
+#ifndef GDV_FAST_MATH_H_
+#define GDV_FAST_MATH_H_
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+#include <gdv/constant.h>
+#include <gdv/math/simd.h>
+
+namespace gdv {
+namespace detail {
+
+template <class Ty>
+struct fast_limits;
+
+template <>
+struct fast_limits<float> {
+    using bits_type = uint32_t;
+    using int_type = int32_t;
+    static constexpr int mantissa = 23;
+    static constexpr int bias = 127;
+    static constexpr float exp_min = -87.3f;
+    static constexpr float exp_max = 88.3f;
+    static constexpr float exp2_min = -126.0f;
+    static constexpr float exp2_max = 127.0f;
+};
+
+template <>
+struct fast_limits<double> {
+    using bits_type = uint64_t;
+    using int_type = int64_t;
+    static constexpr int mantissa = 52;
+    static constexpr int bias = 1023;
+    static constexpr double exp_min = -708.3;
+    static constexpr double exp_max = 709.0;
+    static constexpr double exp2_min = -1022.0;
+    static constexpr double exp2_max = 1023.0;
+};
+
+
+// 最も近い整数に丸めます (|x| < 2^mantissa)
+template <class Ty>
+Ty fast_round(Ty x) noexcept {
+    constexpr Ty m = static_cast<Ty>(1.5) * static_cast<Ty>(static_cast<uint64_t>(1) << fast_limits<Ty>::mantissa);
+    return (x + m) - m;
+}
+
+
+// 整数値のkについて2^kを求めます
+template <class Ty>
+Ty fast_exp2i(Ty k) noexcept {
+    using limits = fast_limits<Ty>;
+    const typename limits::bits_type b = static_cast<typename limits::bits_type>(static_cast<typename limits::int_type>(k) + limits::bias) << limits::mantissa;
+    Ty r;
+    std::memcpy(&r, &b, sizeof(r));
+    return r;
+}
+
+
+// πの3分割 (c1、c2は仮数部のビット数が少なく、k * c1、k * c2は|k| < 2^13で誤差なく計算できます)
+constexpr double fast_pi1 = 3.140625;
+constexpr double fast_pi2 = 9.675025939941406e-4;
+constexpr double fast_pi3 = 1.5099580252808664e-7;
+
+// ln2の2分割
+constexpr double fast_ln2_1 = 0.693359375;
+constexpr double fast_ln2_2 = -2.1219444170128554e-4;
+
+// [-π/2, π/2]のミニマックス近似の係数
+constexpr double fast_sin[4] = {-0.16666657096474893, 8.333017290833727e-3, -1.9806615148585288e-4, 2.6000546506886563e-6};
+constexpr double fast_cos[4] = {4.166665577313032e-2, -1.3888569161146296e-3, 2.4769304194376373e-5, -2.619381424291087e-7};
+
+// [-ln2/2, ln2/2]の近似の係数
+constexpr double fast_exp[6] = {5.0000001201e-1, 1.6666665459e-1, 4.1665795894e-2, 8.3334519073e-3, 1.3981999507e-3, 1.9875691500e-4};
+
+// [-tan(π/8), tan(π/8)]のatanの近似の係数
+constexpr double fast_atan[4] = {-3.33329491539e-1, 1.99777106478e-1, -1.38776856032e-1, 8.05374449538e-2};
+constexpr double fast_tan_pi8 = 0.41421356237309503;
+
+
+/**
+* @brief xを[-π/2, π/2]のrに縮約し、(-1)^k (x = r + kπ) を返します
+**/
+template <class Ty>
+Ty fast_reduce(Ty x, Ty &r) noexcept {
+    constexpr Ty _1 = static_cast<Ty>(1);
+    constexpr Ty half = static_cast<Ty>(0.5);
+    const Ty k = fast_round(x * static_cast<Ty>(1.0 / pi<double>));
+    r = ((x - k * static_cast<Ty>(fast_pi1)) - k * static_cast<Ty>(fast_pi2)) - k * static_cast<Ty>(fast_pi3);
+    const Ty h = k * half;
+    return _1 - static_cast<Ty>(4) * std::fabs(h - fast_round(h));
+}
+
+
+template <class Ty>
+Ty fast_sin_poly(Ty r, Ty r2) noexcept {
+    const Ty p = static_cast<Ty>(fast_sin[0]) + r2 * (static_cast<Ty>(fast_sin[1]) + r2 * (static_cast<Ty>(fast_sin[2]) + r2 * static_cast<Ty>(fast_sin[3])));
+    return r + r * r2 * p;
+}
+
+
+template <class Ty>
+Ty fast_cos_poly(Ty r2) noexcept {
+    const Ty p = static_cast<Ty>(fast_cos[0]) + r2 * (static_cast<Ty>(fast_cos[1]) + r2 * (static_cast<Ty>(fast_cos[2]) + r2 * static_cast<Ty>(fast_cos[3])));
+    return (static_cast<Ty>(1) - static_cast<Ty>(0.5) * r2) + r2 * r2 * p;
+}
+
+
+// |r| <= ln2/2 のexp(r)
+template <class Ty>
+Ty fast_exp_poly(Ty r) noexcept {
+    const Ty p = static_cast<Ty>(fast_exp[0]) + r * (static_cast<Ty>(fast_exp[1]) + r * (static_cast<Ty>(fast_exp[2])
+               + r * (static_cast<Ty>(fast_exp[3]) + r * (static_cast<Ty>(fast_exp[4]) + r * static_cast<Ty>(fast_exp[5])))));
+    return (static_cast<Ty>(1) + r) + r * r * p;
+}
+
+
+// 0 <= t <= 1 のatan(t)
+template <class Ty>
+Ty fast_atan01(Ty t) noexcept {
+    constexpr Ty _1 = static_cast<Ty>(1);
+    const bool reduce = static_cast<Ty>(fast_tan_pi8) < t;
+    const Ty u = reduce ? (t - _1) / (t + _1) : t;
+    const Ty z = u * u;
+    const Ty p = static_cast<Ty>(fast_atan[0]) + z * (static_cast<Ty>(fast_atan[1]) + z * (static_cast<Ty>(fast_atan[2]) + z * static_cast<Ty>(fast_atan[3])));
+    return (u + u * z * p) + (reduce ? static_cast<Ty>(pi<double> / 4) : static_cast<Ty>(0));
+}
+
+} // namespace detail
+
+
+
+
+namespace fast {
+
+/**
+* @brief 近似した正弦を求めます
+* @tparam Ty 浮動小数点型のみ受付ます
+* @param[in] x 角度 (ラジアン)
+* @return sin(x)
+* @exception none
+**/
+template <class Ty>
+Ty sin(Ty x) noexcept {
+    static_assert(std::is_floating_point<Ty>::value, "Template parameters require floating point type.");
+    Ty r;
+    const Ty s = detail::fast_reduce(x, r);
+    return s * detail::fast_sin_poly(r, r * r);
+}
+
+
+/**
+* @brief 近似した余弦を求めます
+**/
+template <class Ty>
+Ty cos(Ty x) noexcept {
+    static_assert(std::is_floating_point<Ty>::value, "Template parameters require floating point type.");
+    Ty r;
+    const Ty s = detail::fast_reduce(x, r);
+    return s * detail::fast_cos_poly(r * r);
+}
+
+
+/**
+* @brief 正弦と余弦を1回の範囲縮約で求めます
+* @param[in]  x 角度 (ラジアン)
+* @param[out] s sin(x)
+* @param[out] c cos(x)
+**/
+template <class Ty>
+void sincos(Ty x, Ty &s, Ty &c) noexcept {
+    static_assert(std::is_floating_point<Ty>::value, "Template parameters require floating point type.");
+    Ty r;
+    const Ty k = detail::fast_reduce(x, r);
+    const Ty r2 = r * r;
+    s = k * detail::fast_sin_poly(r, r2);
+    c = k * detail::fast_cos_poly(r2);
+}
+
+
+/**
+* @brief 近似した指数関数を求めます
+**/
+template <class Ty>
+Ty exp(Ty x) noexcept {
+    static_assert(std::is_floating_point<Ty>::value, "Template parameters require floating point type.");
+    using limits = detail::fast_limits<Ty>;
+    if (std::isnan(x)) { return x; }
+    x = x < limits::exp_min ? limits::exp_min : (limits::exp_max < x ? limits::exp_max : x);
+    const Ty k = detail::fast_round(x * static_cast<Ty>(1.4426950408889634));
+    const Ty r = (x - k * static_cast<Ty>(detail::fast_ln2_1)) - k * static_cast<Ty>(detail::fast_ln2_2);
+    return x <= limits::exp_min ? static_cast<Ty>(0) : detail::fast_exp_poly(r) * detail::fast_exp2i(k);
+}
+
+
+/**
+* @brief 2^xを求めます
+* @details xを整数kと|f| <= 1/2の小数に分け、2^f = exp(f * ln2)を多項式で求めます
+**/
+template <class Ty>
+Ty exp2(Ty x) noexcept {
+    static_assert(std::is_floating_point<Ty>::value, "Template parameters require floating point type.");
+    using limits = detail::fast_limits<Ty>;
+    if (std::isnan(x)) { return x; }
+    x = x < limits::exp2_min ? limits::exp2_min : (limits::exp2_max < x ? limits::exp2_max : x);
+    const Ty k = detail::fast_round(x);
+    const Ty r = (x - k) * static_cast<Ty>(0.6931471805599453);
+    return x <= limits::exp2_min ? static_cast<Ty>(0) : detail::fast_exp_poly(r) * detail::fast_exp2i(k);
+}
+
+
+/**
+* @brief 近似したatan2(y, x)を求めます
+**/
+template <class Ty>
+Ty atan2(Ty y, Ty x) noexcept {
+    static_assert(std::is_floating_point<Ty>::value, "Template parameters require floating point type.");
+    const Ty ax = std::fabs(x), ay = std::fabs(y);
+    const Ty mx = ax < ay ? ay : ax;
+    const Ty mn = ax < ay ? ax : ay;
+    const Ty d = mx < std::numeric_limits<Ty>::min() ? std::numeric_limits<Ty>::min() : mx;
+    Ty a = detail::fast_atan01(mn / d);
+    a = ax < ay ? static_cast<Ty>(pi<double> / 2) - a : a;
+    a = std::signbit(x) ? static_cast<Ty>(pi<double>) - a : a;
+    return std::copysign(a, y);
+}
+
+
+/**
+* @brief 近似したatanを求めます
+**/
+template <class Ty>
+Ty atan(Ty x) noexcept {
+    return fast::atan2(x, static_cast<Ty>(1));
+}
+
+
+/**
+* @brief 近似したasinを求めます
+**/
+template <class Ty>
+Ty asin(Ty x) noexcept {
+    constexpr Ty _1 = static_cast<Ty>(1);
+    return fast::atan2(x, std::sqrt((_1 - x) * (_1 + x)));
+}
+
+
+
+
+/**
+* @brief simd::float4の4要素をまとめて計算します
+* @details スカラ版と同じ手順で計算するため、結果はスカラ版と一致します
+**/
+inline void sincos(simd::float4 x, simd::float4 &s, simd::float4 &c) noexcept {
+    const simd::float4 one = simd::splat(1.0f);
+    const simd::float4 half = simd::splat(0.5f);
+    const simd::float4 magic = simd::splat(12582912.0f);
+    const simd::float4 k = simd::sub(simd::add(simd::mul(x, simd::splat(static_cast<float>(1.0 / pi<double>))), magic), magic);
+    simd::float4 r = simd::sub(x, simd::mul(k, simd::splat(static_cast<float>(detail::fast_pi1))));
+    r = simd::sub(r, simd::mul(k, simd::splat(static_cast<float>(detail::fast_pi2))));
+    r = simd::sub(r, simd::mul(k, simd::splat(static_cast<float>(detail::fast_pi3))));
+    const simd::float4 h = simd::mul(k, half);
+    const simd::float4 sign = simd::sub(one, simd::mul(simd::splat(4.0f), simd::abs(simd::sub(h, simd::sub(simd::add(h, magic), magic)))));
+    const simd::float4 r2 = simd::mul(r, r);
+
+    simd::float4 p = simd::madd(r2, simd::splat(static_cast<float>(detail::fast_sin[3])), simd::splat(static_cast<float>(detail::fast_sin[2])));
+    p = simd::madd(r2, p, simd::splat(static_cast<float>(detail::fast_sin[1])));
+    p = simd::madd(r2, p, simd::splat(static_cast<float>(detail::fast_sin[0])));
+    s = simd::mul(sign, simd::add(r, simd::mul(simd::mul(r, r2), p)));
+
+    simd::float4 q = simd::madd(r2, simd::splat(static_cast<float>(detail::fast_cos[3])), simd::splat(static_cast<float>(detail::fast_cos[2])));
+    q = simd::madd(r2, q, simd::splat(static_cast<float>(detail::fast_cos[1])));
+    q = simd::madd(r2, q, simd::splat(static_cast<float>(detail::fast_cos[0])));
+    c = simd::mul(sign, simd::add(simd::sub(one, simd::mul(half, r2)), simd::mul(simd::mul(r2, r2), q)));
+}
+
+
+inline simd::float4 sin(simd::float4 x) noexcept {
+    simd::float4 s, c;
+    fast::sincos(x, s, c);
+    return s;
+}
+
+
+inline simd::float4 cos(simd::float4 x) noexcept {
+    simd::float4 s, c;
+    fast::sincos(x, s, c);
+    return c;
+}
+
+
+inline simd::float4 exp(simd::float4 x) noexcept {
+    const simd::float4 lo = simd::splat(detail::fast_limits<float>::exp_min);
+    const simd::float4 magic = simd::splat(12582912.0f);
+    x = simd::min(simd::max(x, lo), simd::splat(detail::fast_limits<float>::exp_max));
+    const simd::float4 k = simd::sub(simd::add(simd::mul(x, simd::splat(1.4426950408889634f)), magic), magic);
+    simd::float4 r = simd::sub(x, simd::mul(k, simd::splat(static_cast<float>(detail::fast_ln2_1))));
+    r = simd::sub(r, simd::mul(k, simd::splat(static_cast<float>(detail::fast_ln2_2))));
+    simd::float4 p = simd::madd(r, simd::splat(static_cast<float>(detail::fast_exp[5])), simd::splat(static_cast<float>(detail::fast_exp[4])));
+    p = simd::madd(r, p, simd::splat(static_cast<float>(detail::fast_exp[3])));
+    p = simd::madd(r, p, simd::splat(static_cast<float>(detail::fast_exp[2])));
+    p = simd::madd(r, p, simd::splat(static_cast<float>(detail::fast_exp[1])));
+    p = simd::madd(r, p, simd::splat(static_cast<float>(detail::fast_exp[0])));
+    const simd::float4 e = simd::add(simd::add(simd::splat(1.0f), r), simd::mul(simd::mul(r, r), p));
+    return simd::select(simd::less(lo, x), simd::mul(e, simd::exp2i(k)), simd::zero());
+}
+
+
+inline simd::float4 atan2(simd::float4 y, simd::float4 x) noexcept {
+    const simd::float4 one = simd::splat(1.0f);
+    const simd::float4 ax = simd::abs(x), ay = simd::abs(y);
+    const simd::mask4 swap = simd::less(ax, ay);
+    const simd::float4 mx = simd::select(swap, ay, ax);
+    const simd::float4 mn = simd::select(swap, ax, ay);
+    const simd::float4 t = simd::div(mn, simd::max(mx, simd::splat(std::numeric_limits<float>::min())));
+
+    const simd::mask4 reduce = simd::less(simd::splat(static_cast<float>(detail::fast_tan_pi8)), t);
+    const simd::float4 u = simd::select(reduce, simd::div(simd::sub(t, one), simd::add(t, one)), t);
+    const simd::float4 z = simd::mul(u, u);
+    simd::float4 p = simd::madd(z, simd::splat(static_cast<float>(detail::fast_atan[3])), simd::splat(static_cast<float>(detail::fast_atan[2])));
+    p = simd::madd(z, p, simd::splat(static_cast<float>(detail::fast_atan[1])));
+    p = simd::madd(z, p, simd::splat(static_cast<float>(detail::fast_atan[0])));
+    simd::float4 a = simd::add(simd::add(u, simd::mul(simd::mul(u, z), p)),
+                               simd::select(reduce, simd::splat(static_cast<float>(pi<double> / 4)), simd::zero()));
+
+    a = simd::select(swap, simd::sub(simd::splat(static_cast<float>(pi<double> / 2)), a), a);
+    a = simd::select(simd::less(simd::copysign(one, x), simd::zero()), simd::sub(simd::splat(static_cast<float>(pi<double>)), a), a);
+    return simd::copysign(a, y);
+}
+
+} // namespace fast
+
+
+
+
+/**
+* @brief 標準ライブラリの関数を使うポリシーです
+* @details 三角関数等を使う関数のテンプレート引数 Math に指定します (既定値)
+**/
+struct std_math {
+    template <class Ty> static Ty sin(Ty x) noexcept {return std::sin(x);}
+    template <class Ty> static Ty cos(Ty x) noexcept {return std::cos(x);}
+    template <class Ty> static void sincos(Ty x, Ty &s, Ty &c) noexcept {s = std::sin(x); c = std::cos(x);}
+    template <class Ty> static Ty exp(Ty x) noexcept {return std::exp(x);}
+    template <class Ty> static Ty exp2(Ty x) noexcept {return std::exp2(x);}
+    template <class Ty> static Ty atan2(Ty y, Ty x) noexcept {return std::atan2(y, x);}
+    template <class Ty> static Ty asin(Ty x) noexcept {return std::asin(x);}
+};
+
+
+/**
+* @brief gdv::fastの近似関数を使うポリシーです
+**/
+struct fast_math {
+    template <class Ty> static Ty sin(Ty x) noexcept {return fast::sin(x);}
+    template <class Ty> static Ty cos(Ty x) noexcept {return fast::cos(x);}
+    template <class Ty> static void sincos(Ty x, Ty &s, Ty &c) noexcept {fast::sincos(x, s, c);}
+    template <class Ty> static Ty exp(Ty x) noexcept {return fast::exp(x);}
+    template <class Ty> static Ty exp2(Ty x) noexcept {return fast::exp2(x);}
+    template <class Ty> static Ty atan2(Ty y, Ty x) noexcept {return fast::atan2(y, x);}
+    template <class Ty> static Ty asin(Ty x) noexcept {return fast::asin(x);}
+};
+
+} // namespace gdv
+
+#endif
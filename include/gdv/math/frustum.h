@@ -0,0 +1,389 @@
+/**
+* @file frustum.h
+* @brief 視錐台の平面と、球とAABBの一括カリング関数の宣言
+**/
+#ifndef GDV_FRUSTUM_H_
+#define GDV_FRUSTUM_H_
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <stdint.h>
+#include <gdv/math/vector3.h>
+#include <gdv/math/vector4.h>
+#include <gdv/math/matrix4x4.h>
+#include <gdv/math/camera.h>
+#include <gdv/math/simd.h>
+#include <gdv/tools/parallel.h>
+
+namespace gdv {
+
+/**
+* @class frustum
+* @tparam Ty 浮動小数点型のみ受付ます
+* @brief 正規化された6枚の平面 (left, right, bottom, top, near, far) で表した視錐台です
+* @details 平面は (x, y, z) が内向きの単位法線、w が原点からの距離で、
+*          dot(n, p) + w >= 0 の点が内側です
+**/
+template <class Ty>
+class frustum {
+    static_assert(std::is_floating_point<Ty>::value, "invalid template parameter.");
+
+public:
+    enum side : int {
+        left = 0,
+        right = 1,
+        bottom = 2,
+        top = 3,
+        near = 4,
+        far = 5,
+    };
+
+public:
+    frustum() noexcept :
+        planes{} {}
+
+    /**
+    * @brief 行列の行 (または列) からクリップ平面を作成します
+    * @param[in] r0, r1, r2, r3 クリップ座標の x, y, z, w を与える係数
+    * @details 深度の範囲は [0, 1] (math_function.h の投影行列) を前提とします
+    *          リバースZの投影行列ではnearとfarの平面が入れ替わります
+    **/
+    frustum(vector4<Ty> r0, vector4<Ty> r1, vector4<Ty> r2, vector4<Ty> r3) noexcept :
+        planes{
+            normalize(r3.x + r0.x, r3.y + r0.y, r3.z + r0.z, r3.w + r0.w),
+            normalize(r3.x - r0.x, r3.y - r0.y, r3.z - r0.z, r3.w - r0.w),
+            normalize(r3.x + r1.x, r3.y + r1.y, r3.z + r1.z, r3.w + r1.w),
+            normalize(r3.x - r1.x, r3.y - r1.y, r3.z - r1.z, r3.w - r1.w),
+            normalize(r2.x, r2.y, r2.z, r2.w),
+            normalize(r3.x - r2.x, r3.y - r2.y, r3.z - r2.z, r3.w - r2.w)} {}
+
+public:
+    Ty distance(side s, vector3<Ty> p) const noexcept {
+        return planes[s].x * p.x + planes[s].y * p.y + planes[s].z * p.z + planes[s].w;
+    }
+
+    bool contains(vector3<Ty> p) const noexcept {
+        for (int i = 0; i < 6; ++i) {
+            if (distance(static_cast<side>(i), p) < static_cast<Ty>(0)) { return false; }
+        }
+        return true;
+    }
+
+    /**
+    * @brief 球が視錐台と交差するか判定します
+    **/
+    bool intersects(vector3<Ty> center, Ty radius) const noexcept {
+        for (int i = 0; i < 6; ++i) {
+            if (distance(static_cast<side>(i), center) < -radius) { return false; }
+        }
+        return true;
+    }
+
+    /**
+    * @brief AABBが視錐台と交差するか判定します
+    * @details 各平面について最も内側の頂点だけを調べるため、視錐台の角付近では内側と判定されることがあります
+    **/
+    bool intersects(vector3<Ty> min, vector3<Ty> max) const noexcept {
+        for (int i = 0; i < 6; ++i) {
+            const vector4<Ty> &p = planes[i];
+            vector3<Ty> v{p.x < 0 ? min.x : max.x, p.y < 0 ? min.y : max.y, p.z < 0 ? min.z : max.z};
+            if (distance(static_cast<side>(i), v) < static_cast<Ty>(0)) { return false; }
+        }
+        return true;
+    }
+
+private:
+    static vector4<Ty> normalize(Ty a, Ty b, Ty c, Ty d) noexcept {
+        const Ty l = a * a + b * b + c * c;
+        if (l == static_cast<Ty>(0)) {
+            // 無限遠の平面 (遠くのクリップ面が無限遠の投影行列) はすべての点を内側とします
+            return {static_cast<Ty>(0), static_cast<Ty>(0), static_cast<Ty>(0), static_cast<Ty>(1)};
+        }
+        const Ty r = static_cast<Ty>(1) / std::sqrt(l);
+        return {a * r, b * r, c * r, d * r};
+    }
+
+public:
+    vector4<Ty> planes[6];
+};
+
+
+
+
+namespace detail {
+
+// SIMD版 (madd) と同じ演算順序で平面との距離を求めます。端数の要素もSIMD部分と同じ判定になります
+template <class Ty>
+Ty plane_distance(const vector4<Ty> &p, Ty x, Ty y, Ty z) noexcept {
+    return p.z * z + (p.y * y + (p.x * x + p.w));
+}
+
+
+template <class Ty>
+void cull_spheres(const frustum<Ty> &f,
+                  const Ty *x, const Ty *y, const Ty *z, const Ty *r,
+                  uint8_t *visible, size_t first, size_t last) noexcept {
+    for (size_t i = first; i < last; ++i) {
+        Ty m = plane_distance(f.planes[0], x[i], y[i], z[i]);
+        for (int k = 1; k < 6; ++k) {
+            m = std::min(m, plane_distance(f.planes[k], x[i], y[i], z[i]));
+        }
+        visible[i] = m + r[i] >= static_cast<Ty>(0);
+    }
+}
+
+
+inline void cull_spheres(const frustum<float> &f,
+                         const float *x, const float *y, const float *z, const float *r,
+                         uint8_t *visible, size_t first, size_t last) noexcept {
+    simd::float4 a[6], b[6], c[6], d[6];
+    for (int k = 0; k < 6; ++k) {
+        a[k] = simd::splat(f.planes[k].x);
+        b[k] = simd::splat(f.planes[k].y);
+        c[k] = simd::splat(f.planes[k].z);
+        d[k] = simd::splat(f.planes[k].w);
+    }
+
+    alignas(16) float t[4];
+    size_t i = first;
+    for (; i + 4 <= last; i += 4) {
+        const simd::float4 px = simd::loadu(x + i);
+        const simd::float4 py = simd::loadu(y + i);
+        const simd::float4 pz = simd::loadu(z + i);
+        simd::float4 m = simd::madd(c[0], pz, simd::madd(b[0], py, simd::madd(a[0], px, d[0])));
+        for (int k = 1; k < 6; ++k) {
+            m = simd::min(m, simd::madd(c[k], pz, simd::madd(b[k], py, simd::madd(a[k], px, d[k]))));
+        }
+        simd::store(t, simd::add(m, simd::loadu(r + i)));
+        visible[i    ] = t[0] >= 0.0f;
+        visible[i + 1] = t[1] >= 0.0f;
+        visible[i + 2] = t[2] >= 0.0f;
+        visible[i + 3] = t[3] >= 0.0f;
+    }
+    cull_spheres<float>(f, x, y, z, r, visible, i, last);
+}
+
+
+
+template <class Ty>
+void cull_aabbs(const frustum<Ty> &f,
+                const Ty *min_x, const Ty *min_y, const Ty *min_z,
+                const Ty *max_x, const Ty *max_y, const Ty *max_z,
+                uint8_t *visible, size_t first, size_t last) noexcept {
+    constexpr Ty half = static_cast<Ty>(0.5);
+    for (size_t i = first; i < last; ++i) {
+        const Ty cx = (min_x[i] + max_x[i]) * half, ex = (max_x[i] - min_x[i]) * half;
+        const Ty cy = (min_y[i] + max_y[i]) * half, ey = (max_y[i] - min_y[i]) * half;
+        const Ty cz = (min_z[i] + max_z[i]) * half, ez = (max_z[i] - min_z[i]) * half;
+        Ty m{};
+        for (int k = 0; k < 6; ++k) {
+            const vector4<Ty> &p = f.planes[k];
+            const Ty s = std::abs(p.z) * ez + (std::abs(p.y) * ey + (std::abs(p.x) * ex + plane_distance(p, cx, cy, cz)));
+            m = k == 0 ? s : std::min(m, s);
+        }
+        visible[i] = m >= static_cast<Ty>(0);
+    }
+}
+
+
+// 中心と半径 (extent) に分け、dot(n, center) + w + dot(|n|, extent) を各平面で求めます
+inline void cull_aabbs(const frustum<float> &f,
+                       const float *min_x, const float *min_y, const float *min_z,
+                       const float *max_x, const float *max_y, const float *max_z,
+                       uint8_t *visible, size_t first, size_t last) noexcept {
+    simd::float4 a[6], b[6], c[6], d[6], aa[6], ab[6], ac[6];
+    for (int k = 0; k < 6; ++k) {
+        a[k] = simd::splat(f.planes[k].x);
+        b[k] = simd::splat(f.planes[k].y);
+        c[k] = simd::splat(f.planes[k].z);
+        d[k] = simd::splat(f.planes[k].w);
+        aa[k] = simd::splat(std::fabs(f.planes[k].x));
+        ab[k] = simd::splat(std::fabs(f.planes[k].y));
+        ac[k] = simd::splat(std::fabs(f.planes[k].z));
+    }
+
+    const simd::float4 half = simd::splat(0.5f);
+    alignas(16) float t[4];
+    size_t i = first;
+    for (; i + 4 <= last; i += 4) {
+        const simd::float4 lx = simd::loadu(min_x + i), hx = simd::loadu(max_x + i);
+        const simd::float4 ly = simd::loadu(min_y + i), hy = simd::loadu(max_y + i);
+        const simd::float4 lz = simd::loadu(min_z + i), hz = simd::loadu(max_z + i);
+        const simd::float4 cx = simd::mul(simd::add(lx, hx), half), ex = simd::mul(simd::sub(hx, lx), half);
+        const simd::float4 cy = simd::mul(simd::add(ly, hy), half), ey = simd::mul(simd::sub(hy, ly), half);
+        const simd::float4 cz = simd::mul(simd::add(lz, hz), half), ez = simd::mul(simd::sub(hz, lz), half);
+        simd::float4 m{};
+        for (int k = 0; k < 6; ++k) {
+            simd::float4 s = simd::madd(c[k], cz, simd::madd(b[k], cy, simd::madd(a[k], cx, d[k])));
+            s = simd::madd(ac[k], ez, simd::madd(ab[k], ey, simd::madd(aa[k], ex, s)));
+            m = k == 0 ? s : simd::min(m, s);
+        }
+        simd::store(t, m);
+        visible[i    ] = t[0] >= 0.0f;
+        visible[i + 1] = t[1] >= 0.0f;
+        visible[i + 2] = t[2] >= 0.0f;
+        visible[i + 3] = t[3] >= 0.0f;
+    }
+    cull_aabbs<float>(f, min_x, min_y, min_z, max_x, max_y, max_z, visible, i, last);
+}
+
+
+inline size_t count_visible(const uint8_t *visible, size_t first, size_t last) noexcept {
+    size_t n = 0;
+    for (size_t i = first; i < last; ++i) { n += visible[i]; }
+    return n;
+}
+
+} // namespace detail
+
+
+
+
+/**
+* @brief SoA配列の球を一括でカリングします
+* @param[in]  f       視錐台
+* @param[in]  x, y, z 中心座標の配列
+* @param[in]  r       半径の配列
+* @param[out] visible 判定結果 (視錐台と交差する場合は1)
+* @param[in]  n       球の数
+* @param[in]  threads スレッド数 (1で呼び出しスレッドのみ、0でハードウェアスレッド数)
+* @return 視錐台と交差する球の数
+* @exception none
+**/
+template <class Ty>
+size_t cull(const frustum<Ty> &f,
+            const Ty *x, const Ty *y, const Ty *z, const Ty *r,
+            uint8_t *visible, size_t n, size_t threads = 1) {
+    std::atomic<size_t> count{0};
+    parallel_for(n, threads, [&](size_t first, size_t last) {
+        detail::cull_spheres(f, x, y, z, r, visible, first, last);
+        count.fetch_add(detail::count_visible(visible, first, last), std::memory_order_relaxed);
+    }, 4096);
+    return count.load();
+}
+
+
+/**
+* @brief SoA配列のAABBを一括でカリングします
+* @param[in]  f       視錐台
+* @param[in]  min_x, min_y, min_z 最小座標の配列
+* @param[in]  max_x, max_y, max_z 最大座標の配列
+* @param[out] visible 判定結果 (視錐台と交差する場合は1)
+* @param[in]  n       AABBの数
+* @param[in]  threads スレッド数
+* @return 視錐台と交差するAABBの数
+* @exception none
+**/
+template <class Ty>
+size_t cull(const frustum<Ty> &f,
+            const Ty *min_x, const Ty *min_y, const Ty *min_z,
+            const Ty *max_x, const Ty *max_y, const Ty *max_z,
+            uint8_t *visible, size_t n, size_t threads = 1) {
+    std::atomic<size_t> count{0};
+    parallel_for(n, threads, [&](size_t first, size_t last) {
+        detail::cull_aabbs(f, min_x, min_y, min_z, max_x, max_y, max_z, visible, first, last);
+        count.fetch_add(detail::count_visible(visible, first, last), std::memory_order_relaxed);
+    }, 4096);
+    return count.load();
+}
+
+
+/**
+* @brief vector3配列のAABBを一括でカリングします
+**/
+template <class Ty>
+size_t cull(const frustum<Ty> &f, const vector3<Ty> *min, const vector3<Ty> *max,
+            uint8_t *visible, size_t n, size_t threads = 1) {
+    std::atomic<size_t> count{0};
+    parallel_for(n, threads, [&](size_t first, size_t last) {
+        for (size_t i = first; i < last; ++i) { visible[i] = f.intersects(min[i], max[i]); }
+        count.fetch_add(detail::count_visible(visible, first, last), std::memory_order_relaxed);
+    }, 4096);
+    return count.load();
+}
+
+
+
+
+namespace column_major {
+
+/**
+* @brief ビュー射影行列 (clip = m * v) から視錐台を作成します
+* @tparam Ty 浮動小数点型のみ受付ます
+* @param[in] m ビュー射影行列
+* @return frustum<Ty>
+* @exception none
+**/
+template <class Ty>
+frustum<Ty> to_frustum(const matrix4x4<Ty> &m) noexcept {
+    return {
+        {m.m[ 0], m.m[ 1], m.m[ 2], m.m[ 3]},
+        {m.m[ 4], m.m[ 5], m.m[ 6], m.m[ 7]},
+        {m.m[ 8], m.m[ 9], m.m[10], m.m[11]},
+        {m.m[12], m.m[13], m.m[14], m.m[15]},
+    };
+}
+
+
+namespace right_hand {
+
+template <class Ty>
+frustum<Ty> to_frustum(const camera<Ty> &c) noexcept {
+    return column_major::to_frustum(to_matrix(c));
+}
+
+} // namespace right_hand
+
+
+namespace left_hand {
+
+template <class Ty>
+frustum<Ty> to_frustum(const camera<Ty> &c) noexcept {
+    return column_major::to_frustum(to_matrix(c));
+}
+
+} // namespace left_hand
+} // namespace column_major
+
+
+
+
+namespace row_major {
+
+/**
+* @brief ビュー射影行列 (clip = v * m) から視錐台を作成します
+**/
+template <class Ty>
+frustum<Ty> to_frustum(const matrix4x4<Ty> &m) noexcept {
+    return {
+        {m.m[0], m.m[4], m.m[ 8], m.m[12]},
+        {m.m[1], m.m[5], m.m[ 9], m.m[13]},
+        {m.m[2], m.m[6], m.m[10], m.m[14]},
+        {m.m[3], m.m[7], m.m[11], m.m[15]},
+    };
+}
+
+
+namespace right_hand {
+
+template <class Ty>
+frustum<Ty> to_frustum(const camera<Ty> &c) noexcept {
+    return row_major::to_frustum(to_matrix(c));
+}
+
+} // namespace right_hand
+
+
+namespace left_hand {
+
+template <class Ty>
+frustum<Ty> to_frustum(const camera<Ty> &c) noexcept {
+    return row_major::to_frustum(to_matrix(c));
+}
+
+} // namespace left_hand
+} // namespace row_major
+} // namespace gdv
+
+#endif
@@ -1,16 +1,30 @@
 #ifndef GDV_MATH_H_
 #define GDV_MATH_H_
 
+#include <gdv/math/simd.h>
+#include <gdv/math/fast_math.h>
+#include <gdv/math/constexpr_math.h>
 #include <gdv/math/vector2.h>
 #include <gdv/math/vector3.h>
 #include <gdv/math/vector4.h>
 #include <gdv/math/matrix3x3.h>
 #include <gdv/math/matrix4x4.h>
 #include <gdv/math/quaternion.h>
+#include <gdv/math/affine3.h>
 #include <gdv/math/rect.h>
 #include <gdv/math/viewport.h>
 #include <gdv/math/euler.h>
 #include <gdv/math/camera.h>
+#include <gdv/math/camera_relative.h>
+#include <gdv/math/batch_transform.h>
+#include <gdv/math/batch_quaternion.h>
+#include <gdv/math/batch_rotation.h>
+#include <gdv/math/dual_quaternion.h>
+#include <gdv/math/hierarchy.h>
+#include <gdv/math/frustum.h>
+#include <gdv/math/shadow_cascade.h>
+#include <gdv/math/batch_projection.h>
+#include <gdv/math/expression.h>
 #include <gdv/math/math_function.h>
 
 #endif
@@ -0,0 +1,193 @@
+/**
+* @file hierarchy.h
+* @brief 親インデックス配列で表現した階層構造のワールド行列を一括で更新するクラスです
+**/
+#ifndef GDV_HIERARCHY_H_
+#define GDV_HIERARCHY_H_
+
+#include <algorithm>
+#include <vector>
+#include <stdint.h>
+#include <gdv/math/matrix4x4.h>
+#include <gdv/math/affine3.h>
+#include <gdv/tools/parallel.h>
+
+namespace gdv {
+namespace detail {
+
+// 列ベクトル形式: world = parent * local
+struct parent_local {
+    template <class Ty>
+    static matrix4x4<Ty> apply(const matrix4x4<Ty> &parent, const matrix4x4<Ty> &local) noexcept {return parent * local;}
+
+    template <class Ty>
+    static affine3<Ty> apply(const affine3<Ty> &parent, const affine3<Ty> &local) noexcept {return compose(parent, local);}
+};
+
+// 行ベクトル形式: world = local * parent
+struct local_parent {
+    template <class Ty>
+    static matrix4x4<Ty> apply(const matrix4x4<Ty> &parent, const matrix4x4<Ty> &local) noexcept {return local * parent;}
+
+    template <class Ty>
+    static affine3<Ty> apply(const affine3<Ty> &parent, const affine3<Ty> &local) noexcept {return compose(parent, local);}
+};
+
+
+
+/**
+* @class hierarchy
+* @tparam Matrix matrix4x4<Ty> または affine3<Ty>
+* @tparam Order  親子の乗算順序 (parent_local または local_parent)
+* @brief ノードを追加順 (親は必ず子より前) の配列で保持する階層構造です
+* @details ローカル行列、ワールド行列、親インデックス、更新フラグをそれぞれ別の配列に格納します
+*          update()は深さごとにノードを処理し、同じ深さのノードは互いに独立なため並列に計算できます
+*          ローカル行列が変更されたノードとその子孫だけが再計算されます
+*          ノードの削除はサポートしません
+**/
+template <class Matrix, class Order>
+class hierarchy {
+public:
+    using matrix_type = Matrix;
+    using index_type = uint32_t;
+
+    static constexpr index_type root = ~index_type{};
+
+public:
+    hierarchy() :
+        local_{}, world_{}, parent_{}, depth_{}, dirty_{}, levels_{}, dirty_count_{} {}
+
+public:
+    /**
+    * @brief ノードを追加します
+    * @param[in] parent 親ノードのインデックス (ルートの場合はroot)
+    * @param[in] local  ローカル行列
+    * @return 追加したノードのインデックス
+    * @exception std::bad_alloc
+    * @details parentは追加済みのノードである必要があります
+    **/
+    index_type add(index_type parent, const Matrix &local) {
+        const index_type i = static_cast<index_type>(local_.size());
+        const uint32_t depth = parent == root ? 0 : depth_[parent] + 1;
+        local_.push_back(local);
+        world_.push_back(local);
+        parent_.push_back(parent);
+        depth_.push_back(depth);
+        dirty_.push_back(1);
+        if (levels_.size() <= depth) { levels_.resize(depth + 1); }
+        levels_[depth].push_back(i);
+        ++dirty_count_;
+        return i;
+    }
+
+
+    void set_local(index_type i, const Matrix &local) noexcept {
+        local_[i] = local;
+        dirty_count_ += dirty_[i] == 0;
+        dirty_[i] = 1;
+    }
+
+
+    /**
+    * @brief 更新が必要なノードのワールド行列を再計算します
+    * @param[in] threads スレッド数 (1で呼び出しスレッドのみ、0でハードウェアスレッド数)
+    * @return none
+    * @exception none
+    **/
+    void update(size_t threads = 1) {
+        if (dirty_count_ == 0) { return; }
+
+        const Matrix *local = local_.data();
+        Matrix *world = world_.data();
+        const index_type *parent = parent_.data();
+        uint8_t *dirty = dirty_.data();
+
+        for (size_t d = 0; d < levels_.size(); ++d) {
+            const index_type *level = levels_[d].data();
+            parallel_for(levels_[d].size(), threads, [=](size_t first, size_t last) {
+                for (size_t k = first; k < last; ++k) {
+                    const index_type i = level[k];
+                    const index_type p = parent[i];
+                    if (p == root) {
+                        if (dirty[i]) { world[i] = local[i]; }
+                        continue;
+                    }
+                    dirty[i] |= dirty[p];
+                    if (dirty[i]) { world[i] = Order::apply(world[p], local[i]); }
+                }
+            }, 256);
+        }
+
+        std::fill(dirty_.begin(), dirty_.end(), uint8_t{});
+        dirty_count_ = 0;
+    }
+
+
+    const Matrix& local(index_type i) const noexcept {return local_[i];}
+
+    const Matrix& world(index_type i) const noexcept {return world_[i];}
+
+    index_type parent(index_type i) const noexcept {return parent_[i];}
+
+    uint32_t depth(index_type i) const noexcept {return depth_[i];}
+
+    size_t size() const noexcept {return local_.size();}
+
+    const Matrix* worlds() const noexcept {return world_.data();}
+
+    void reserve(size_t n) {
+        local_.reserve(n);
+        world_.reserve(n);
+        parent_.reserve(n);
+        depth_.reserve(n);
+        dirty_.reserve(n);
+    }
+
+    void clear() noexcept {
+        local_.clear();
+        world_.clear();
+        parent_.clear();
+        depth_.clear();
+        dirty_.clear();
+        levels_.clear();
+        dirty_count_ = 0;
+    }
+
+private:
+    std::vector<Matrix> local_;
+    std::vector<Matrix> world_;
+    std::vector<index_type> parent_;
+    std::vector<uint32_t> depth_;
+    std::vector<uint8_t> dirty_;
+    std::vector<std::vector<index_type>> levels_;
+    size_t dirty_count_;
+};
+
+} // namespace detail
+
+
+
+namespace column_major {
+
+/**
+* @brief world = parent * local で伝播する階層構造
+**/
+template <class Matrix>
+using hierarchy = detail::hierarchy<Matrix, detail::parent_local>;
+
+} // namespace column_major
+
+
+
+namespace row_major {
+
+/**
+* @brief world = local * parent で伝播する階層構造
+**/
+template <class Matrix>
+using hierarchy = detail::hierarchy<Matrix, detail::local_parent>;
+
+} // namespace row_major
+} // namespace gdv
+
+#endif
@@ -5,6 +5,8 @@
 #include <gdv/math/vector4.h>
 #include <gdv/math/matrix4x4.h>
 #include <gdv/math/matrix3x3.h>
+#include <gdv/math/fast_math.h>
+#include <gdv/math/constexpr_math.h>
 
 
 namespace gdv {
@@ -17,7 +19,7 @@ namespace gdv {
 * @exception none
 **/
 template <class Ty>
-matrix4x4<Ty> unit_matrix() noexcept {
+constexpr matrix4x4<Ty> unit_matrix() noexcept {
     constexpr Ty _0 = static_cast<Ty>(0);
     constexpr Ty _1 = static_cast<Ty>(1);
     return {
@@ -38,7 +40,7 @@ matrix4x4<Ty> unit_matrix() noexcept {
 * @exception none
 **/
 template <class Ty>
-matrix3x3<Ty> transpose(matrix3x3<Ty> m) noexcept {
+constexpr matrix3x3<Ty> transpose(matrix3x3<Ty> m) noexcept {
     return {
         m.m[0], m.m[3], m.m[6],
         m.m[1], m.m[4], m.m[7],
@@ -56,7 +58,7 @@ matrix3x3<Ty> transpose(matrix3x3<Ty> m) noexcept {
 * @exception none
 **/
 template <class Ty>
-matrix4x4<Ty> transpose(matrix4x4<Ty> m) noexcept {
+constexpr matrix4x4<Ty> transpose(matrix4x4<Ty> m) noexcept {
     return {
         m.m[0], m.m[4], m.m[ 8], m.m[12],
         m.m[1], m.m[5], m.m[ 9], m.m[13],
@@ -68,6 +70,196 @@ matrix4x4<Ty> transpose(matrix4x4<Ty> m) noexcept {
 
 
 
+/**
+* @brief 行列式を求めます
+* @tparam Ty スカラ型のみ受付ます
+* @param[in] m 対象の行列
+* @return Ty
+* @exception none
+**/
+template <class Ty>
+Ty determinant(const matrix3x3<Ty> &m) noexcept {
+    return m.m[0] * (m.m[4] * m.m[8] - m.m[5] * m.m[7])
+         - m.m[1] * (m.m[3] * m.m[8] - m.m[5] * m.m[6])
+         + m.m[2] * (m.m[3] * m.m[7] - m.m[4] * m.m[6]);
+}
+
+
+
+/**
+* @brief 行列式を求めます
+* @tparam Ty スカラ型のみ受付ます
+* @param[in] m 対象の行列
+* @return Ty
+* @exception none
+**/
+template <class Ty>
+Ty determinant(const matrix4x4<Ty> &m) noexcept {
+    const Ty s0 = m.m[ 0] * m.m[ 5] - m.m[ 4] * m.m[ 1];
+    const Ty s1 = m.m[ 0] * m.m[ 6] - m.m[ 4] * m.m[ 2];
+    const Ty s2 = m.m[ 0] * m.m[ 7] - m.m[ 4] * m.m[ 3];
+    const Ty s3 = m.m[ 1] * m.m[ 6] - m.m[ 5] * m.m[ 2];
+    const Ty s4 = m.m[ 1] * m.m[ 7] - m.m[ 5] * m.m[ 3];
+    const Ty s5 = m.m[ 2] * m.m[ 7] - m.m[ 6] * m.m[ 3];
+    const Ty c0 = m.m[ 8] * m.m[13] - m.m[12] * m.m[ 9];
+    const Ty c1 = m.m[ 8] * m.m[14] - m.m[12] * m.m[10];
+    const Ty c2 = m.m[ 8] * m.m[15] - m.m[12] * m.m[11];
+    const Ty c3 = m.m[ 9] * m.m[14] - m.m[13] * m.m[10];
+    const Ty c4 = m.m[ 9] * m.m[15] - m.m[13] * m.m[11];
+    const Ty c5 = m.m[10] * m.m[15] - m.m[14] * m.m[11];
+    return s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
+}
+
+
+
+/**
+* @brief 逆行列を求めます
+* @tparam Ty 浮動小数点型のみ受付ます
+* @param[in] m 対象の行列
+* @return Mat3
+* @exception none
+* @details 特異行列の場合、結果の要素は有限値になりません
+**/
+template <class Ty>
+matrix3x3<Ty> inverse(const matrix3x3<Ty> &m) noexcept {
+    static_assert(std::is_floating_point<Ty>::value, "Template parameters require floating point type.");
+    const Ty c0 = m.m[4] * m.m[8] - m.m[5] * m.m[7];
+    const Ty c1 = m.m[5] * m.m[6] - m.m[3] * m.m[8];
+    const Ty c2 = m.m[3] * m.m[7] - m.m[4] * m.m[6];
+    const Ty r = static_cast<Ty>(1) / (m.m[0] * c0 + m.m[1] * c1 + m.m[2] * c2);
+    return {
+        c0 * r, (m.m[2] * m.m[7] - m.m[1] * m.m[8]) * r, (m.m[1] * m.m[5] - m.m[2] * m.m[4]) * r,
+        c1 * r, (m.m[0] * m.m[8] - m.m[2] * m.m[6]) * r, (m.m[2] * m.m[3] - m.m[0] * m.m[5]) * r,
+        c2 * r, (m.m[1] * m.m[6] - m.m[0] * m.m[7]) * r, (m.m[0] * m.m[4] - m.m[1] * m.m[3]) * r
+    };
+}
+
+
+
+/**
+* @brief 逆行列を余因子展開で求めます
+* @tparam Ty 浮動小数点型のみ受付ます
+* @param[in] m 対象の行列
+* @return Mat4
+* @exception none
+* @details 特異行列の場合、結果の要素は有限値になりません
+*          回転、拡大縮小、移動だけで構成された行列にはaffine_inverseの方が高速です
+**/
+template <class Ty>
+matrix4x4<Ty> inverse(const matrix4x4<Ty> &m) noexcept {
+    static_assert(std::is_floating_point<Ty>::value, "Template parameters require floating point type.");
+    const Ty s0 = m.m[ 0] * m.m[ 5] - m.m[ 4] * m.m[ 1];
+    const Ty s1 = m.m[ 0] * m.m[ 6] - m.m[ 4] * m.m[ 2];
+    const Ty s2 = m.m[ 0] * m.m[ 7] - m.m[ 4] * m.m[ 3];
+    const Ty s3 = m.m[ 1] * m.m[ 6] - m.m[ 5] * m.m[ 2];
+    const Ty s4 = m.m[ 1] * m.m[ 7] - m.m[ 5] * m.m[ 3];
+    const Ty s5 = m.m[ 2] * m.m[ 7] - m.m[ 6] * m.m[ 3];
+    const Ty c0 = m.m[ 8] * m.m[13] - m.m[12] * m.m[ 9];
+    const Ty c1 = m.m[ 8] * m.m[14] - m.m[12] * m.m[10];
+    const Ty c2 = m.m[ 8] * m.m[15] - m.m[12] * m.m[11];
+    const Ty c3 = m.m[ 9] * m.m[14] - m.m[13] * m.m[10];
+    const Ty c4 = m.m[ 9] * m.m[15] - m.m[13] * m.m[11];
+    const Ty c5 = m.m[10] * m.m[15] - m.m[14] * m.m[11];
+    const Ty r = static_cast<Ty>(1) / (s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0);
+    return {
+        ( m.m[ 5] * c5 - m.m[ 6] * c4 + m.m[ 7] * c3) * r,
+        (-m.m[ 1] * c5 + m.m[ 2] * c4 - m.m[ 3] * c3) * r,
+        ( m.m[13] * s5 - m.m[14] * s4 + m.m[15] * s3) * r,
+        (-m.m[ 9] * s5 + m.m[10] * s4 - m.m[11] * s3) * r,
+
+        (-m.m[ 4] * c5 + m.m[ 6] * c2 - m.m[ 7] * c1) * r,
+        ( m.m[ 0] * c5 - m.m[ 2] * c2 + m.m[ 3] * c1) * r,
+        (-m.m[12] * s5 + m.m[14] * s2 - m.m[15] * s1) * r,
+        ( m.m[ 8] * s5 - m.m[10] * s2 + m.m[11] * s1) * r,
+
+        ( m.m[ 4] * c4 - m.m[ 5] * c2 + m.m[ 7] * c0) * r,
+        (-m.m[ 0] * c4 + m.m[ 1] * c2 - m.m[ 3] * c0) * r,
+        ( m.m[12] * s4 - m.m[13] * s2 + m.m[15] * s0) * r,
+        (-m.m[ 8] * s4 + m.m[ 9] * s2 - m.m[11] * s0) * r,
+
+        (-m.m[ 4] * c3 + m.m[ 5] * c1 - m.m[ 6] * c0) * r,
+        ( m.m[ 0] * c3 - m.m[ 1] * c1 + m.m[ 2] * c0) * r,
+        (-m.m[12] * s3 + m.m[13] * s1 - m.m[14] * s0) * r,
+        ( m.m[ 8] * s3 - m.m[ 9] * s1 + m.m[10] * s0) * r,
+    };
+}
+
+
+
+/**
+* @brief 逆行列を2x2の小行列に分けて求めます (float版)
+* @details M = |A B|, 逆行列 = 1/|M| |X Y| として、2x2の余因子行列からX, Y, Z, Wを4要素ずつ計算します
+*              |C D|                 |Z W|
+**/
+inline matrix4x4<float> inverse(const matrix4x4<float> &m) noexcept {
+    // 2x2行列 (a0 a1; a2 a3) を1レジスタに格納して扱います
+    struct block {
+        // a * b
+        static simd::float4 mul(simd::float4 a, simd::float4 b) noexcept {
+            return simd::add(simd::mul(a, simd::shuffle<0, 3, 0, 3>(b, b)),
+                             simd::mul(simd::shuffle<1, 0, 3, 2>(a, a), simd::shuffle<2, 1, 2, 1>(b, b)));
+        }
+        // adj(a) * b
+        static simd::float4 adj_mul(simd::float4 a, simd::float4 b) noexcept {
+            return simd::sub(simd::mul(simd::shuffle<3, 3, 0, 0>(a, a), b),
+                             simd::mul(simd::shuffle<1, 1, 2, 2>(a, a), simd::shuffle<2, 3, 0, 1>(b, b)));
+        }
+        // a * adj(b)
+        static simd::float4 mul_adj(simd::float4 a, simd::float4 b) noexcept {
+            return simd::sub(simd::mul(a, simd::shuffle<3, 0, 3, 0>(b, b)),
+                             simd::mul(simd::shuffle<1, 0, 3, 2>(a, a), simd::shuffle<2, 1, 2, 1>(b, b)));
+        }
+    };
+
+    const simd::float4 r0 = simd::load(&m.m[ 0]);
+    const simd::float4 r1 = simd::load(&m.m[ 4]);
+    const simd::float4 r2 = simd::load(&m.m[ 8]);
+    const simd::float4 r3 = simd::load(&m.m[12]);
+
+    const simd::float4 a = simd::shuffle<0, 1, 0, 1>(r0, r1);
+    const simd::float4 b = simd::shuffle<2, 3, 2, 3>(r0, r1);
+    const simd::float4 c = simd::shuffle<0, 1, 0, 1>(r2, r3);
+    const simd::float4 d = simd::shuffle<2, 3, 2, 3>(r2, r3);
+
+    // (|A|, |B|, |C|, |D|)
+    const simd::float4 det = simd::sub(
+        simd::mul(simd::shuffle<0, 2, 0, 2>(r0, r2), simd::shuffle<1, 3, 1, 3>(r1, r3)),
+        simd::mul(simd::shuffle<1, 3, 1, 3>(r0, r2), simd::shuffle<0, 2, 0, 2>(r1, r3)));
+    const simd::float4 det_a = simd::broadcast<0>(det);
+    const simd::float4 det_b = simd::broadcast<1>(det);
+    const simd::float4 det_c = simd::broadcast<2>(det);
+    const simd::float4 det_d = simd::broadcast<3>(det);
+
+    const simd::float4 dc = block::adj_mul(d, c);
+    const simd::float4 ab = block::adj_mul(a, b);
+    simd::float4 x = simd::sub(simd::mul(det_d, a), block::mul(b, dc));
+    simd::float4 w = simd::sub(simd::mul(det_a, d), block::mul(c, ab));
+    simd::float4 y = simd::sub(simd::mul(det_b, c), block::mul_adj(d, ab));
+    simd::float4 z = simd::sub(simd::mul(det_c, b), block::mul_adj(a, dc));
+
+    // |M| = |A||D| + |B||C| - tr(adj(A)B adj(D)C)
+    simd::float4 tr = simd::mul(ab, simd::shuffle<0, 2, 1, 3>(dc, dc));
+    tr = simd::add(tr, simd::shuffle<2, 3, 0, 1>(tr, tr));
+    tr = simd::add(tr, simd::shuffle<1, 0, 3, 2>(tr, tr));
+    const simd::float4 det_m = simd::sub(simd::add(simd::mul(det_a, det_d), simd::mul(det_b, det_c)), tr);
+    const simd::float4 r = simd::div(simd::set(1.0f, -1.0f, -1.0f, 1.0f), det_m);
+
+    x = simd::mul(x, r);
+    y = simd::mul(y, r);
+    z = simd::mul(z, r);
+    w = simd::mul(w, r);
+
+    matrix4x4<float> result;
+    simd::store(&result.m[ 0], simd::shuffle<3, 1, 3, 1>(x, y));
+    simd::store(&result.m[ 4], simd::shuffle<2, 0, 2, 0>(x, y));
+    simd::store(&result.m[ 8], simd::shuffle<3, 1, 3, 1>(z, w));
+    simd::store(&result.m[12], simd::shuffle<2, 0, 2, 0>(z, w));
+    return result;
+}
+
+
+
+
 namespace column_major {
 
 
@@ -82,7 +274,7 @@ namespace column_major {
 * @exception none
 **/
 template <class Ty>
-matrix4x4<Ty> scaling(Ty x, Ty y, Ty z) noexcept {
+constexpr matrix4x4<Ty> scaling(Ty x, Ty y, Ty z) noexcept {
     constexpr Ty _0 = static_cast<Ty>(0);
     constexpr Ty _1 = static_cast<Ty>(1);
     return {
@@ -102,7 +294,7 @@ matrix4x4<Ty> scaling(Ty x, Ty y, Ty z) noexcept {
 * @exception none
 **/
 template <class Ty>
-matrix4x4<Ty> scaling(vector3<Ty> v) noexcept {
+constexpr matrix4x4<Ty> scaling(vector3<Ty> v) noexcept {
     return scaling(v.x, v.y, v.z);
 }
 
@@ -118,7 +310,7 @@ matrix4x4<Ty> scaling(vector3<Ty> v) noexcept {
 * @exception none
 **/
 template <class Ty>
-matrix4x4<Ty> translation(Ty x, Ty y, Ty z) noexcept {
+constexpr matrix4x4<Ty> translation(Ty x, Ty y, Ty z) noexcept {
     constexpr Ty _0 = static_cast<Ty>(0);
     constexpr Ty _1 = static_cast<Ty>(1);
     return {
@@ -139,25 +331,54 @@ matrix4x4<Ty> translation(Ty x, Ty y, Ty z) noexcept {
 * @exception none
 **/
 template <class Ty>
-matrix4x4<Ty> translation(vector3<Ty> v) noexcept {
+constexpr matrix4x4<Ty> translation(vector3<Ty> v) noexcept {
     return translation(v.x, v.y, v.z);
 }
 
 
 
+/**
+* @brief 回転、拡大縮小、移動だけで構成された行列の逆行列を求めます
+* @tparam Ty 浮動小数点型のみ受付ます
+* @param[in] m 最下行が(0, 0, 0, 1)の行列
+* @return matrix4x4<Ty>
+* @exception none
+* @details 左上3x3の逆行列と移動量の逆変換だけを計算するため、inverseより大幅に安価です
+**/
+template <class Ty>
+matrix4x4<Ty> affine_inverse(const matrix4x4<Ty> &m) noexcept {
+    constexpr Ty _0 = static_cast<Ty>(0);
+    constexpr Ty _1 = static_cast<Ty>(1);
+    const matrix3x3<Ty> a = inverse(matrix3x3<Ty>{
+        m.m[0], m.m[1], m.m[ 2],
+        m.m[4], m.m[5], m.m[ 6],
+        m.m[8], m.m[9], m.m[10]
+    });
+    const Ty x = m.m[3], y = m.m[7], z = m.m[11];
+    return {
+        a.m[0], a.m[1], a.m[2], -(a.m[0] * x + a.m[1] * y + a.m[2] * z),
+        a.m[3], a.m[4], a.m[5], -(a.m[3] * x + a.m[4] * y + a.m[5] * z),
+        a.m[6], a.m[7], a.m[8], -(a.m[6] * x + a.m[7] * y + a.m[8] * z),
+            _0,     _0,     _0, _1
+    };
+}
+
+
+
 /**
 * @brief x軸に関する回転行列を作成します
 * @tparam Ty スカラ型のみ受付ます
+* @tparam Math 三角関数のポリシー (constexpr_mathを指定すると定数式で評価できます)
 * @param[in] radians 回転角(ラジアン)
 * @return Mat4
 * @exception none
 **/
-template <class Ty>
-matrix4x4<Ty> rotate_x(Ty radians) noexcept {
+template <class Ty, class Math = std_math>
+constexpr matrix4x4<Ty> rotate_x(Ty radians) noexcept {
     constexpr Ty _0 = static_cast<Ty>(0);
     constexpr Ty _1 = static_cast<Ty>(1);
-    Ty s = std::sin(radians);
-    Ty c = std::cos(radians);
+    const Ty s = Math::sin(radians);
+    const Ty c = Math::cos(radians);
     return {
         _1, _0, _0, _0,
         _0,  c, -s, _0,
@@ -171,16 +392,17 @@ matrix4x4<Ty> rotate_x(Ty radians) noexcept {
 /**
 * @brief y軸に関する回転行列を作成します
 * @tparam Ty スカラ型のみ受付ます
+* @tparam Math 三角関数のポリシー (constexpr_mathを指定すると定数式で評価できます)
 * @param[in] radians 回転角(ラジアン)
 * @return Mat4
 * @exception none
 **/
-template <class Ty>
-matrix4x4<Ty> rotate_y(Ty radians) noexcept {
+template <class Ty, class Math = std_math>
+constexpr matrix4x4<Ty> rotate_y(Ty radians) noexcept {
     constexpr Ty _0 = static_cast<Ty>(0);
     constexpr Ty _1 = static_cast<Ty>(1);
-    Ty s = std::sin(radians);
-    Ty c = std::cos(radians);
+    const Ty s = Math::sin(radians);
+    const Ty c = Math::cos(radians);
     return {
          c, _0,  s, _0,
         _0, _1, _0, _0,
@@ -194,16 +416,17 @@ matrix4x4<Ty> rotate_y(Ty radians) noexcept {
 /**
 * @brief z軸に関する回転行列を作成します
 * @tparam Ty スカラ型のみ受付ます
+* @tparam Math 三角関数のポリシー (constexpr_mathを指定すると定数式で評価できます)
 * @param[in] radians 回転角(ラジアン)
 * @return Mat4
 * @exception none
 **/
-template <class Ty>
-matrix4x4<Ty> rotate_z(Ty radians) noexcept {
+template <class Ty, class Math = std_math>
+constexpr matrix4x4<Ty> rotate_z(Ty radians) noexcept {
     constexpr Ty _0 = static_cast<Ty>(0);
     constexpr Ty _1 = static_cast<Ty>(1);
-    Ty s = std::sin(radians);
-    Ty c = std::cos(radians);
+    const Ty s = Math::sin(radians);
+    const Ty c = Math::cos(radians);
     return {
          c, -s, _0, _0,
          s,  c, _0, _0,
@@ -269,9 +492,9 @@ matrix4x4<Ty> look_at(vector3<Ty> pos, vector3<Ty> dst, vector3<Ty> up) noexcept
     vector3<Ty> x = normalize(cross(up, z));
     vector3<Ty> y = cross(z, x);
     return{
-        x.x, y.x, z.x, -dot(pos, x),
-        x.y, y.y, z.y, -dot(pos, y),
-        x.z, y.z, z.z, -dot(pos, z),
+        x.x, x.y, x.z, -dot(pos, x),
+        y.x, y.y, y.z, -dot(pos, y),
+        z.x, z.y, z.z, -dot(pos, z),
         _0, _0, _0, _1
     };
 
@@ -299,7 +522,7 @@ matrix4x4<Ty> orthogonal(Ty left, Ty right, Ty bottom, Ty top, Ty near, Ty far)
     return {
         _2 / (right - left), _0, _0, (right + left) / (left - right),
         _0, _2 / (top - bottom), _0, (top + bottom) / (bottom - top),
-        _0, _0, _1 / (near - far), _1 / (near - far),
+        _0, _0, _1 / (near - far), near / (near - far),
         _0, _0, _0, _1,
     };
 }
@@ -325,7 +548,7 @@ matrix4x4<Ty> orthogonal(Ty width, Ty height, Ty near, Ty far) noexcept {
     return {
         _2 / width, _0, _0, _0,
         _0, _2 / height, _0, _0,
-        _0, _0, _1 / (near - far), _1 / (near - far),
+        _0, _0, _1 / (near - far), near / (near - far),
         _0, _0, _0, _1,
     };
 }
@@ -406,191 +629,567 @@ matrix4x4<Ty> perspective_fov(Ty angle, Ty aspect, Ty near, Ty far) noexcept {
     };
 }
 
-} // namespace right_hand
-
-
-
-
-
-namespace left_hand {
 
 
+/**
+* @brief 透視投影行列を作成します (リバースZ)
+* @details 近くのクリップ面の深度が1、遠くのクリップ面の深度が0になります
+* @tparam Ty スカラ型のみ受付ます
+* @param[in] left   視錐台の左端
+* @param[in] right  視錐台の右端
+* @param[in] bottom 視錐台の下端
+* @param[in] top    視錐台の上端
+* @param[in] near   近くのクリップ面の奥行き
+* @param[in] far    遠くのクリップ面の奥行き
+* @return Mat4
+* @exception none
+**/
 template <class Ty>
-matrix4x4<Ty> look_at(vector3<Ty> pos, vector3<Ty> dst, vector3<Ty> up) noexcept {
+constexpr matrix4x4<Ty> perspective_reverse(Ty left, Ty right, Ty bottom, Ty top, Ty near, Ty far) noexcept {
     constexpr Ty _0 = static_cast<Ty>(0);
     constexpr Ty _1 = static_cast<Ty>(1);
-    vector3<Ty> z = normalize(dst - pos);
-    vector3<Ty> x = normalize(cross(up, z));
-    vector3<Ty> y = cross(z, x);
-    return{
-        x.x, y.x, z.x, -dot(pos, x),
-        x.y, y.y, z.y, -dot(pos, y),
-        x.z, y.z, z.z, -dot(pos, z),
-        _0, _0, _0, _1
+    constexpr Ty _2 = static_cast<Ty>(2);
+    return {
+        _2 * near / (right - left), _0, (right + left) / (right - left), _0,
+        _0, _2 * near / (bottom - top), (bottom + top) / (bottom - top), _0,
+        _0, _0, near / (far - near), far * near / (far - near),
+        _0, _0, -_1, _0,
     };
 }
 
 
+/**
+* @brief 透視投影行列を作成します (リバースZ)
+* @details 近くのクリップ面の深度が1、遠くのクリップ面の深度が0になります
+* @tparam Ty スカラ型のみ受付ます
+* @param[in] width  視錐台の幅
+* @param[in] height 視錐台の高さ
+* @param[in] near   近くのクリップ面の奥行き
+* @param[in] far    遠くのクリップ面の奥行き
+* @return Mat4
+* @exception none
+**/
 template <class Ty>
-matrix4x4<Ty> orthogonal(Ty left, Ty right, Ty bottom, Ty top, Ty near, Ty far) noexcept {
+constexpr matrix4x4<Ty> perspective_reverse(Ty width, Ty height, Ty near, Ty far) noexcept {
     constexpr Ty _0 = static_cast<Ty>(0);
     constexpr Ty _1 = static_cast<Ty>(1);
     constexpr Ty _2 = static_cast<Ty>(2);
     return {
-        _2 / (right - left), _0, _0, (right + left) / (left - right),
-        _0, _2 / (top - bottom), _0, (top + bottom) / (bottom - top),
-        _0, _0, _1 / (far - near), _1 / (near - far),
-        _0, _0, _0, _1,
+        _2 * near / width, _0, _0, _0,
+        _0, _2 * near / height, _0, _0,
+        _0, _0, near / (far - near), far * near / (far - near),
+        _0, _0, -_1, _0,
     };
 }
 
 
+/**
+* @brief 透視投影行列を作成します (リバースZ)
+* @details 近くのクリップ面の深度が1、遠くのクリップ面の深度が0になります
+* @tparam Ty スカラ型のみ受付ます
+* @param[in] angle  垂直方向の視野角 (ラジアン)
+* @param[in] aspect アスペクト比
+* @param[in] near   近くのクリップ面の奥行き
+* @param[in] far    遠くのクリップ面の奥行き
+* @return Mat4
+* @exception none
+**/
 template <class Ty>
-matrix4x4<Ty> orthogonal(Ty width, Ty height, Ty near, Ty far) noexcept {
+matrix4x4<Ty> perspective_fov_reverse(Ty angle, Ty aspect, Ty near, Ty far) noexcept {
     constexpr Ty _0 = static_cast<Ty>(0);
     constexpr Ty _1 = static_cast<Ty>(1);
-    constexpr Ty _2 = static_cast<Ty>(2);
+    const Ty f = _1 / std::tan(angle / static_cast<Ty>(2));
     return {
-        _2 / width, _0, _0, _0,
-        _0, _2 / height, _0, _0,
-        _0, _0, _1 / (far - near), _1 / (near - far),
-        _0, _0, _0, _1,
+        f / aspect, _0, _0, _0,
+        _0, f, _0, _0,
+        _0, _0, near / (far - near), far * near / (far - near),
+        _0, _0, -_1, _0,
     };
 }
 
 
+/**
+* @brief 遠くのクリップ面を無限遠に置いた透視投影行列を作成します
+* @details 無限遠の深度が1になります
+* @tparam Ty スカラ型のみ受付ます
+* @param[in] left   視錐台の左端
+* @param[in] right  視錐台の右端
+* @param[in] bottom 視錐台の下端
+* @param[in] top    視錐台の上端
+* @param[in] near   近くのクリップ面の奥行き
+* @return Mat4
+* @exception none
+**/
 template <class Ty>
-matrix4x4<Ty> perspective(Ty left, Ty right, Ty bottom, Ty top, Ty near, Ty far) noexcept {
+constexpr matrix4x4<Ty> perspective_infinite(Ty left, Ty right, Ty bottom, Ty top, Ty near) noexcept {
     constexpr Ty _0 = static_cast<Ty>(0);
     constexpr Ty _1 = static_cast<Ty>(1);
     constexpr Ty _2 = static_cast<Ty>(2);
     return {
-        _2 * near / (right - left), _0, (right + left) / (left - right), _0,
-        _0, _2 * near / (bottom - top), (bottom + top) / (top - bottom), _0,
-        _0, _0, far / (far - near), far * near / (near - far),
-        _0, _0, _1, _0,
+        _2 * near / (right - left), _0, (right + left) / (right - left), _0,
+        _0, _2 * near / (bottom - top), (bottom + top) / (bottom - top), _0,
+        _0, _0, -_1, -near,
+        _0, _0, -_1, _0,
     };
 }
 
 
+/**
+* @brief 遠くのクリップ面を無限遠に置いた透視投影行列を作成します
+* @details 無限遠の深度が1になります
+* @tparam Ty スカラ型のみ受付ます
+* @param[in] width  視錐台の幅
+* @param[in] height 視錐台の高さ
+* @param[in] near   近くのクリップ面の奥行き
+* @return Mat4
+* @exception none
+**/
 template <class Ty>
-matrix4x4<Ty> perspective(Ty width, Ty height, Ty near, Ty far) noexcept {
+constexpr matrix4x4<Ty> perspective_infinite(Ty width, Ty height, Ty near) noexcept {
     constexpr Ty _0 = static_cast<Ty>(0);
     constexpr Ty _1 = static_cast<Ty>(1);
     constexpr Ty _2 = static_cast<Ty>(2);
     return {
         _2 * near / width, _0, _0, _0,
         _0, _2 * near / height, _0, _0,
-        _0, _0, far / (far - near), far * near / (near - far),
-        _0, _0, _1, _0,
+        _0, _0, -_1, -near,
+        _0, _0, -_1, _0,
     };
 }
 
 
+/**
+* @brief 遠くのクリップ面を無限遠に置いた透視投影行列を作成します
+* @details 無限遠の深度が1になります
+* @tparam Ty スカラ型のみ受付ます
+* @param[in] angle  垂直方向の視野角 (ラジアン)
+* @param[in] aspect アスペクト比
+* @param[in] near   近くのクリップ面の奥行き
+* @return Mat4
+* @exception none
+**/
 template <class Ty>
-matrix4x4<Ty> perspective_fov(Ty angle, Ty aspect, Ty near, Ty far) noexcept {
+matrix4x4<Ty> perspective_fov_infinite(Ty angle, Ty aspect, Ty near) noexcept {
     constexpr Ty _0 = static_cast<Ty>(0);
     constexpr Ty _1 = static_cast<Ty>(1);
-    Ty f = static_cast<Ty>(_1 / std::tan(angle / static_cast<Ty>(2)));
+    const Ty f = _1 / std::tan(angle / static_cast<Ty>(2));
     return {
         f / aspect, _0, _0, _0,
         _0, f, _0, _0,
-        _0, _0, far / (far - near), far * near / (near - far),
-        _0, _0, _1, _0,
+        _0, _0, -_1, -near,
+        _0, _0, -_1, _0,
     };
 }
 
-} // namespace left_hand
-} // namespace column_major
-
-
-
-
-
-
-namespace row_major {
-
 
+/**
+* @brief 遠くのクリップ面を無限遠に置いた透視投影行列を作成します (リバースZ)
+* @details 近くのクリップ面の深度が1、無限遠の深度が0になります
+* @tparam Ty スカラ型のみ受付ます
+* @param[in] left   視錐台の左端
+* @param[in] right  視錐台の右端
+* @param[in] bottom 視錐台の下端
+* @param[in] top    視錐台の上端
+* @param[in] near   近くのクリップ面の奥行き
+* @return Mat4
+* @exception none
+**/
 template <class Ty>
-matrix4x4<Ty> scaling(Ty x, Ty y, Ty z) noexcept {
+constexpr matrix4x4<Ty> perspective_infinite_reverse(Ty left, Ty right, Ty bottom, Ty top, Ty near) noexcept {
     constexpr Ty _0 = static_cast<Ty>(0);
     constexpr Ty _1 = static_cast<Ty>(1);
+    constexpr Ty _2 = static_cast<Ty>(2);
     return {
-         x, _0, _0, _0,
-        _0,  y, _0, _0,
-        _0, _0,  z, _0,
-        _0, _0, _0, _1
+        _2 * near / (right - left), _0, (right + left) / (right - left), _0,
+        _0, _2 * near / (bottom - top), (bottom + top) / (bottom - top), _0,
+        _0, _0, _0, near,
+        _0, _0, -_1, _0,
     };
 }
 
 
-
-
+/**
+* @brief 遠くのクリップ面を無限遠に置いた透視投影行列を作成します (リバースZ)
+* @details 近くのクリップ面の深度が1、無限遠の深度が0になります
+* @tparam Ty スカラ型のみ受付ます
+* @param[in] width  視錐台の幅
+* @param[in] height 視錐台の高さ
+* @param[in] near   近くのクリップ面の奥行き
+* @return Mat4
+* @exception none
+**/
 template <class Ty>
-matrix4x4<Ty> scaling(vector3<Ty> v) noexcept {
-    return scaling(v.x, v.y, v.z);
+constexpr matrix4x4<Ty> perspective_infinite_reverse(Ty width, Ty height, Ty near) noexcept {
+    constexpr Ty _0 = static_cast<Ty>(0);
+    constexpr Ty _1 = static_cast<Ty>(1);
+    constexpr Ty _2 = static_cast<Ty>(2);
+    return {
+        _2 * near / width, _0, _0, _0,
+        _0, _2 * near / height, _0, _0,
+        _0, _0, _0, near,
+        _0, _0, -_1, _0,
+    };
 }
 
 
-
+/**
+* @brief 遠くのクリップ面を無限遠に置いた透視投影行列を作成します (リバースZ)
+* @details 近くのクリップ面の深度が1、無限遠の深度が0になります
+* @tparam Ty スカラ型のみ受付ます
+* @param[in] angle  垂直方向の視野角 (ラジアン)
+* @param[in] aspect アスペクト比
+* @param[in] near   近くのクリップ面の奥行き
+* @return Mat4
+* @exception none
+**/
 template <class Ty>
-matrix4x4<Ty> translation(Ty x, Ty y, Ty z) noexcept {
+matrix4x4<Ty> perspective_fov_infinite_reverse(Ty angle, Ty aspect, Ty near) noexcept {
     constexpr Ty _0 = static_cast<Ty>(0);
     constexpr Ty _1 = static_cast<Ty>(1);
+    const Ty f = _1 / std::tan(angle / static_cast<Ty>(2));
     return {
-        _1, _0, _0, _0,
-        _0, _1, _0, _0,
-        _0, _0, _1, _0,
-         x,  y,  z, _1
+        f / aspect, _0, _0, _0,
+        _0, f, _0, _0,
+        _0, _0, _0, near,
+        _0, _0, -_1, _0,
     };
 }
 
+} // namespace right_hand
+
+
 
 
-template <class Ty>
-matrix4x4<Ty> translation(vector3<Ty> v) noexcept {
-    return translation(v.x, v.y, v.z);
-}
 
+namespace left_hand {
 
 
 template <class Ty>
-matrix4x4<Ty> rotate_x(Ty radians) noexcept {
+matrix4x4<Ty> look_at(vector3<Ty> pos, vector3<Ty> dst, vector3<Ty> up) noexcept {
     constexpr Ty _0 = static_cast<Ty>(0);
     constexpr Ty _1 = static_cast<Ty>(1);
-    Ty s = std::sin(radians);
-    Ty c = std::cos(radians);
-    return {
-        _1, _0, _0, _0,
-        _0,  c,  s, _0,
-        _0, -s,  c, _0,
+    vector3<Ty> z = normalize(dst - pos);
+    vector3<Ty> x = normalize(cross(up, z));
+    vector3<Ty> y = cross(z, x);
+    return{
+        x.x, x.y, x.z, -dot(pos, x),
+        y.x, y.y, y.z, -dot(pos, y),
+        z.x, z.y, z.z, -dot(pos, z),
         _0, _0, _0, _1
     };
 }
 
 
-
 template <class Ty>
-matrix4x4<Ty> rotate_y(Ty radians) noexcept {
+matrix4x4<Ty> orthogonal(Ty left, Ty right, Ty bottom, Ty top, Ty near, Ty far) noexcept {
     constexpr Ty _0 = static_cast<Ty>(0);
     constexpr Ty _1 = static_cast<Ty>(1);
-    Ty s = std::sin(radians);
-    Ty c = std::cos(radians);
+    constexpr Ty _2 = static_cast<Ty>(2);
     return {
-         c, _0, -s, _0,
-        _0, _1, _0, _0,
-         s, _0,  c, _0,
-        _0, _0, _0, _1
+        _2 / (right - left), _0, _0, (right + left) / (left - right),
+        _0, _2 / (top - bottom), _0, (top + bottom) / (bottom - top),
+        _0, _0, _1 / (far - near), near / (near - far),
+        _0, _0, _0, _1,
     };
 }
 
 
 template <class Ty>
-matrix4x4<Ty> rotate_z(Ty radians) noexcept {
+matrix4x4<Ty> orthogonal(Ty width, Ty height, Ty near, Ty far) noexcept {
+    constexpr Ty _0 = static_cast<Ty>(0);
+    constexpr Ty _1 = static_cast<Ty>(1);
+    constexpr Ty _2 = static_cast<Ty>(2);
+    return {
+        _2 / width, _0, _0, _0,
+        _0, _2 / height, _0, _0,
+        _0, _0, _1 / (far - near), near / (near - far),
+        _0, _0, _0, _1,
+    };
+}
+
+
+template <class Ty>
+matrix4x4<Ty> perspective(Ty left, Ty right, Ty bottom, Ty top, Ty near, Ty far) noexcept {
+    constexpr Ty _0 = static_cast<Ty>(0);
+    constexpr Ty _1 = static_cast<Ty>(1);
+    constexpr Ty _2 = static_cast<Ty>(2);
+    return {
+        _2 * near / (right - left), _0, (right + left) / (left - right), _0,
+        _0, _2 * near / (bottom - top), (bottom + top) / (top - bottom), _0,
+        _0, _0, far / (far - near), far * near / (near - far),
+        _0, _0, _1, _0,
+    };
+}
+
+
+template <class Ty>
+matrix4x4<Ty> perspective(Ty width, Ty height, Ty near, Ty far) noexcept {
+    constexpr Ty _0 = static_cast<Ty>(0);
+    constexpr Ty _1 = static_cast<Ty>(1);
+    constexpr Ty _2 = static_cast<Ty>(2);
+    return {
+        _2 * near / width, _0, _0, _0,
+        _0, _2 * near / height, _0, _0,
+        _0, _0, far / (far - near), far * near / (near - far),
+        _0, _0, _1, _0,
+    };
+}
+
+
+template <class Ty>
+matrix4x4<Ty> perspective_fov(Ty angle, Ty aspect, Ty near, Ty far) noexcept {
+    constexpr Ty _0 = static_cast<Ty>(0);
+    constexpr Ty _1 = static_cast<Ty>(1);
+    Ty f = static_cast<Ty>(_1 / std::tan(angle / static_cast<Ty>(2)));
+    return {
+        f / aspect, _0, _0, _0,
+        _0, f, _0, _0,
+        _0, _0, far / (far - near), far * near / (near - far),
+        _0, _0, _1, _0,
+    };
+}
+
+
+
+template <class Ty>
+constexpr matrix4x4<Ty> perspective_reverse(Ty left, Ty right, Ty bottom, Ty top, Ty near, Ty far) noexcept {
+    constexpr Ty _0 = static_cast<Ty>(0);
+    constexpr Ty _1 = static_cast<Ty>(1);
+    constexpr Ty _2 = static_cast<Ty>(2);
+    return {
+        _2 * near / (right - left), _0, (right + left) / (left - right), _0,
+        _0, _2 * near / (bottom - top), (bottom + top) / (top - bottom), _0,
+        _0, _0, near / (near - far), far * near / (far - near),
+        _0, _0, _1, _0,
+    };
+}
+
+
+template <class Ty>
+constexpr matrix4x4<Ty> perspective_reverse(Ty width, Ty height, Ty near, Ty far) noexcept {
+    constexpr Ty _0 = static_cast<Ty>(0);
+    constexpr Ty _1 = static_cast<Ty>(1);
+    constexpr Ty _2 = static_cast<Ty>(2);
+    return {
+        _2 * near / width, _0, _0, _0,
+        _0, _2 * near / height, _0, _0,
+        _0, _0, near / (near - far), far * near / (far - near),
+        _0, _0, _1, _0,
+    };
+}
+
+
+template <class Ty>
+matrix4x4<Ty> perspective_fov_reverse(Ty angle, Ty aspect, Ty near, Ty far) noexcept {
     constexpr Ty _0 = static_cast<Ty>(0);
     constexpr Ty _1 = static_cast<Ty>(1);
-    Ty s = std::sin(radians);
-    Ty c = std::cos(radians);
+    const Ty f = _1 / std::tan(angle / static_cast<Ty>(2));
+    return {
+        f / aspect, _0, _0, _0,
+        _0, f, _0, _0,
+        _0, _0, near / (near - far), far * near / (far - near),
+        _0, _0, _1, _0,
+    };
+}
+
+
+template <class Ty>
+constexpr matrix4x4<Ty> perspective_infinite(Ty left, Ty right, Ty bottom, Ty top, Ty near) noexcept {
+    constexpr Ty _0 = static_cast<Ty>(0);
+    constexpr Ty _1 = static_cast<Ty>(1);
+    constexpr Ty _2 = static_cast<Ty>(2);
+    return {
+        _2 * near / (right - left), _0, (right + left) / (left - right), _0,
+        _0, _2 * near / (bottom - top), (bottom + top) / (top - bottom), _0,
+        _0, _0, _1, -near,
+        _0, _0, _1, _0,
+    };
+}
+
+
+template <class Ty>
+constexpr matrix4x4<Ty> perspective_infinite(Ty width, Ty height, Ty near) noexcept {
+    constexpr Ty _0 = static_cast<Ty>(0);
+    constexpr Ty _1 = static_cast<Ty>(1);
+    constexpr Ty _2 = static_cast<Ty>(2);
+    return {
+        _2 * near / width, _0, _0, _0,
+        _0, _2 * near / height, _0, _0,
+        _0, _0, _1, -near,
+        _0, _0, _1, _0,
+    };
+}
+
+
+template <class Ty>
+matrix4x4<Ty> perspective_fov_infinite(Ty angle, Ty aspect, Ty near) noexcept {
+    constexpr Ty _0 = static_cast<Ty>(0);
+    constexpr Ty _1 = static_cast<Ty>(1);
+    const Ty f = _1 / std::tan(angle / static_cast<Ty>(2));
+    return {
+        f / aspect, _0, _0, _0,
+        _0, f, _0, _0,
+        _0, _0, _1, -near,
+        _0, _0, _1, _0,
+    };
+}
+
+
+template <class Ty>
+constexpr matrix4x4<Ty> perspective_infinite_reverse(Ty left, Ty right, Ty bottom, Ty top, Ty near) noexcept {
+    constexpr Ty _0 = static_cast<Ty>(0);
+    constexpr Ty _1 = static_cast<Ty>(1);
+    constexpr Ty _2 = static_cast<Ty>(2);
+    return {
+        _2 * near / (right - left), _0, (right + left) / (left - right), _0,
+        _0, _2 * near / (bottom - top), (bottom + top) / (top - bottom), _0,
+        _0, _0, _0, near,
+        _0, _0, _1, _0,
+    };
+}
+
+
+template <class Ty>
+constexpr matrix4x4<Ty> perspective_infinite_reverse(Ty width, Ty height, Ty near) noexcept {
+    constexpr Ty _0 = static_cast<Ty>(0);
+    constexpr Ty _1 = static_cast<Ty>(1);
+    constexpr Ty _2 = static_cast<Ty>(2);
+    return {
+        _2 * near / width, _0, _0, _0,
+        _0, _2 * near / height, _0, _0,
+        _0, _0, _0, near,
+        _0, _0, _1, _0,
+    };
+}
+
+
+template <class Ty>
+matrix4x4<Ty> perspective_fov_infinite_reverse(Ty angle, Ty aspect, Ty near) noexcept {
+    constexpr Ty _0 = static_cast<Ty>(0);
+    constexpr Ty _1 = static_cast<Ty>(1);
+    const Ty f = _1 / std::tan(angle / static_cast<Ty>(2));
+    return {
+        f / aspect, _0, _0, _0,
+        _0, f, _0, _0,
+        _0, _0, _0, near,
+        _0, _0, _1, _0,
+    };
+}
+
+} // namespace left_hand
+} // namespace column_major
+
+
+
+
+
+
+namespace row_major {
+
+
+template <class Ty>
+constexpr matrix4x4<Ty> scaling(Ty x, Ty y, Ty z) noexcept {
+    constexpr Ty _0 = static_cast<Ty>(0);
+    constexpr Ty _1 = static_cast<Ty>(1);
+    return {
+         x, _0, _0, _0,
+        _0,  y, _0, _0,
+        _0, _0,  z, _0,
+        _0, _0, _0, _1
+    };
+}
+
+
+
+
+template <class Ty>
+constexpr matrix4x4<Ty> scaling(vector3<Ty> v) noexcept {
+    return scaling(v.x, v.y, v.z);
+}
+
+
+
+template <class Ty>
+constexpr matrix4x4<Ty> translation(Ty x, Ty y, Ty z) noexcept {
+    constexpr Ty _0 = static_cast<Ty>(0);
+    constexpr Ty _1 = static_cast<Ty>(1);
+    return {
+        _1, _0, _0, _0,
+        _0, _1, _0, _0,
+        _0, _0, _1, _0,
+         x,  y,  z, _1
+    };
+}
+
+
+
+template <class Ty>
+constexpr matrix4x4<Ty> translation(vector3<Ty> v) noexcept {
+    return translation(v.x, v.y, v.z);
+}
+
+
+
+template <class Ty>
+matrix4x4<Ty> affine_inverse(const matrix4x4<Ty> &m) noexcept {
+    constexpr Ty _0 = static_cast<Ty>(0);
+    constexpr Ty _1 = static_cast<Ty>(1);
+    const matrix3x3<Ty> a = inverse(matrix3x3<Ty>{
+        m.m[0], m.m[1], m.m[ 2],
+        m.m[4], m.m[5], m.m[ 6],
+        m.m[8], m.m[9], m.m[10]
+    });
+    const Ty x = m.m[12], y = m.m[13], z = m.m[14];
+    return {
+        a.m[0], a.m[1], a.m[2], _0,
+        a.m[3], a.m[4], a.m[5], _0,
+        a.m[6], a.m[7], a.m[8], _0,
+        -(x * a.m[0] + y * a.m[3] + z * a.m[6]),
+        -(x * a.m[1] + y * a.m[4] + z * a.m[7]),
+        -(x * a.m[2] + y * a.m[5] + z * a.m[8]),
+        _1
+    };
+}
+
+
+
+template <class Ty, class Math = std_math>
+constexpr matrix4x4<Ty> rotate_x(Ty radians) noexcept {
+    constexpr Ty _0 = static_cast<Ty>(0);
+    constexpr Ty _1 = static_cast<Ty>(1);
+    const Ty s = Math::sin(radians);
+    const Ty c = Math::cos(radians);
+    return {
+        _1, _0, _0, _0,
+        _0,  c,  s, _0,
+        _0, -s,  c, _0,
+        _0, _0, _0, _1
+    };
+}
+
+
+
+template <class Ty, class Math = std_math>
+constexpr matrix4x4<Ty> rotate_y(Ty radians) noexcept {
+    constexpr Ty _0 = static_cast<Ty>(0);
+    constexpr Ty _1 = static_cast<Ty>(1);
+    const Ty s = Math::sin(radians);
+    const Ty c = Math::cos(radians);
+    return {
+         c, _0, -s, _0,
+        _0, _1, _0, _0,
+         s, _0,  c, _0,
+        _0, _0, _0, _1
+    };
+}
+
+
+template <class Ty, class Math = std_math>
+constexpr matrix4x4<Ty> rotate_z(Ty radians) noexcept {
+    constexpr Ty _0 = static_cast<Ty>(0);
+    constexpr Ty _1 = static_cast<Ty>(1);
+    const Ty s = Math::sin(radians);
+    const Ty c = Math::cos(radians);
     return {
          c,  s, _0, _0,
         -s,  c, _0, _0,
@@ -636,9 +1235,9 @@ matrix4x4<Ty> look_at(vector3<Ty> pos, vector3<Ty> dst, vector3<Ty> up) noexcept
     vector3<Ty> x = normalize(cross(up, z));
     vector3<Ty> y = cross(z, x);
     return{
-        x.x, x.y, x.z, _0,
-        y.x, y.y, y.z, _0,
-        z.x, z.y, z.z, _0,
+        x.x, y.x, z.x, _0,
+        x.y, y.y, z.y, _0,
+        x.z, y.z, z.z, _0,
         -dot(pos, x), -dot(pos, y), -dot(pos, z), _1
     };
 }
@@ -653,7 +1252,7 @@ matrix4x4<Ty> orthogonal(Ty left, Ty right, Ty bottom, Ty top, Ty near, Ty far)
         _2 / (right - left), _0, _0, _0,
         _0, _2 / (top - bottom), _0, _0,
         _0, _0, _1 / (near - far), _0,
-        (right + left) / (left - right), (top + bottom) / (bottom - top), _1 / (near - far), _1,
+        (right + left) / (left - right), (top + bottom) / (bottom - top), near / (near - far), _1,
     };
 }
 
@@ -667,7 +1266,7 @@ matrix4x4<Ty> orthogonal(Ty width, Ty height, Ty near, Ty far) noexcept {
         _2 / width, _0, _0, _0,
         _0, _2 / height, _0, _0,
         _0, _0, _1 / (near - far), _0,
-        _0, _0, _1 / (near - far), _1,
+        _0, _0, near / (near - far), _1,
     };
 }
 
@@ -713,6 +1312,133 @@ matrix4x4<Ty> perspective_fov(Ty angle, Ty aspect, Ty near, Ty far) noexcept {
     };
 }
 
+
+
+template <class Ty>
+constexpr matrix4x4<Ty> perspective_reverse(Ty left, Ty right, Ty bottom, Ty top, Ty near, Ty far) noexcept {
+    constexpr Ty _0 = static_cast<Ty>(0);
+    constexpr Ty _1 = static_cast<Ty>(1);
+    constexpr Ty _2 = static_cast<Ty>(2);
+    return {
+        _2 * near / (right - left), _0, _0, _0,
+        _0, _2 * near / (top - bottom), _0, _0,
+        (right + left) / (right - left), (bottom + top) / (top - bottom), near / (far - near), -_1,
+        _0, _0, far * near / (far - near), _0,
+    };
+}
+
+
+template <class Ty>
+constexpr matrix4x4<Ty> perspective_reverse(Ty width, Ty height, Ty near, Ty far) noexcept {
+    constexpr Ty _0 = static_cast<Ty>(0);
+    constexpr Ty _1 = static_cast<Ty>(1);
+    constexpr Ty _2 = static_cast<Ty>(2);
+    return {
+        _2 * near / width, _0, _0, _0,
+        _0, _2 * near / height, _0, _0,
+        _0, _0, near / (far - near), -_1,
+        _0, _0, far * near / (far - near), _0,
+    };
+}
+
+
+template <class Ty>
+matrix4x4<Ty> perspective_fov_reverse(Ty angle, Ty aspect, Ty near, Ty far) noexcept {
+    constexpr Ty _0 = static_cast<Ty>(0);
+    constexpr Ty _1 = static_cast<Ty>(1);
+    const Ty f = _1 / std::tan(angle / static_cast<Ty>(2));
+    return {
+        f / aspect, _0, _0, _0,
+        _0, f, _0, _0,
+        _0, _0, near / (far - near), -_1,
+        _0, _0, far * near / (far - near), _0,
+    };
+}
+
+
+template <class Ty>
+constexpr matrix4x4<Ty> perspective_infinite(Ty left, Ty right, Ty bottom, Ty top, Ty near) noexcept {
+    constexpr Ty _0 = static_cast<Ty>(0);
+    constexpr Ty _1 = static_cast<Ty>(1);
+    constexpr Ty _2 = static_cast<Ty>(2);
+    return {
+        _2 * near / (right - left), _0, _0, _0,
+        _0, _2 * near / (top - bottom), _0, _0,
+        (right + left) / (right - left), (bottom + top) / (top - bottom), -_1, -_1,
+        _0, _0, -near, _0,
+    };
+}
+
+
+template <class Ty>
+constexpr matrix4x4<Ty> perspective_infinite(Ty width, Ty height, Ty near) noexcept {
+    constexpr Ty _0 = static_cast<Ty>(0);
+    constexpr Ty _1 = static_cast<Ty>(1);
+    constexpr Ty _2 = static_cast<Ty>(2);
+    return {
+        _2 * near / width, _0, _0, _0,
+        _0, _2 * near / height, _0, _0,
+        _0, _0, -_1, -_1,
+        _0, _0, -near, _0,
+    };
+}
+
+
+template <class Ty>
+matrix4x4<Ty> perspective_fov_infinite(Ty angle, Ty aspect, Ty near) noexcept {
+    constexpr Ty _0 = static_cast<Ty>(0);
+    constexpr Ty _1 = static_cast<Ty>(1);
+    const Ty f = _1 / std::tan(angle / static_cast<Ty>(2));
+    return {
+        f / aspect, _0, _0, _0,
+        _0, f, _0, _0,
+        _0, _0, -_1, -_1,
+        _0, _0, -near, _0,
+    };
+}
+
+
+template <class Ty>
+constexpr matrix4x4<Ty> perspective_infinite_reverse(Ty left, Ty right, Ty bottom, Ty top, Ty near) noexcept {
+    constexpr Ty _0 = static_cast<Ty>(0);
+    constexpr Ty _1 = static_cast<Ty>(1);
+    constexpr Ty _2 = static_cast<Ty>(2);
+    return {
+        _2 * near / (right - left), _0, _0, _0,
+        _0, _2 * near / (top - bottom), _0, _0,
+        (right + left) / (right - left), (bottom + top) / (top - bottom), _0, -_1,
+        _0, _0, near, _0,
+    };
+}
+
+
+template <class Ty>
+constexpr matrix4x4<Ty> perspective_infinite_reverse(Ty width, Ty height, Ty near) noexcept {
+    constexpr Ty _0 = static_cast<Ty>(0);
+    constexpr Ty _1 = static_cast<Ty>(1);
+    constexpr Ty _2 = static_cast<Ty>(2);
+    return {
+        _2 * near / width, _0, _0, _0,
+        _0, _2 * near / height, _0, _0,
+        _0, _0, _0, -_1,
+        _0, _0, near, _0,
+    };
+}
+
+
+template <class Ty>
+matrix4x4<Ty> perspective_fov_infinite_reverse(Ty angle, Ty aspect, Ty near) noexcept {
+    constexpr Ty _0 = static_cast<Ty>(0);
+    constexpr Ty _1 = static_cast<Ty>(1);
+    const Ty f = _1 / std::tan(angle / static_cast<Ty>(2));
+    return {
+        f / aspect, _0, _0, _0,
+        _0, f, _0, _0,
+        _0, _0, _0, -_1,
+        _0, _0, near, _0,
+    };
+}
+
 } // namespace right_hand
 
 
@@ -729,9 +1455,9 @@ matrix4x4<Ty> look_at(vector3<Ty> pos, vector3<Ty> dst, vector3<Ty> up) noexcept
     vector3<Ty> x = normalize(cross(up, z));
     vector3<Ty> y = cross(z, x);
     return{
-        x.x, x.y, x.z, _0,
-        y.x, y.y, y.z, _0,
-        z.x, z.y, z.z, _0,
+        x.x, y.x, z.x, _0,
+        x.y, y.y, z.y, _0,
+        x.z, y.z, z.z, _0,
         -dot(pos, x), -dot(pos, y), -dot(pos, z), _1
     };
 }
@@ -746,7 +1472,7 @@ matrix4x4<Ty> orthogonal(Ty left, Ty right, Ty bottom, Ty top, Ty near, Ty far)
         _2 / (right - left), _0, _0, _0,
         _0, _2 / (top - bottom), _0, _0,
         _0, _0, _1 / (far - near), _0,
-        (right + left) / (left - right), (top + bottom) / (bottom - top), _1 / (near - far), _1,
+        (right + left) / (left - right), (top + bottom) / (bottom - top), near / (near - far), _1,
     };
 }
 
@@ -760,7 +1486,7 @@ matrix4x4<Ty> orthogonal(Ty width, Ty height, Ty near, Ty far) noexcept {
         _2 / width, _0, _0, _0,
         _0, _2 / height, _0, _0,
         _0, _0, _1 / (far - near), _0,
-        _0, _0, _1 / (near - far), _1,
+        _0, _0, near / (near - far), _1,
     };
 }
 
@@ -806,6 +1532,133 @@ matrix4x4<Ty> perspective_fov(Ty angle, Ty aspect, Ty near, Ty far) noexcept {
     };
 }
 
+
+
+template <class Ty>
+constexpr matrix4x4<Ty> perspective_reverse(Ty left, Ty right, Ty bottom, Ty top, Ty near, Ty far) noexcept {
+    constexpr Ty _0 = static_cast<Ty>(0);
+    constexpr Ty _1 = static_cast<Ty>(1);
+    constexpr Ty _2 = static_cast<Ty>(2);
+    return {
+        _2 * near / (right - left), _0, _0, _0,
+        _0, _2 * near / (bottom - top), _0, _0,
+        (right + left) / (left - right), (bottom + top) / (top - bottom), near / (near - far), _1,
+        _0, _0, far * near / (far - near), _0,
+    };
+}
+
+
+template <class Ty>
+constexpr matrix4x4<Ty> perspective_reverse(Ty width, Ty height, Ty near, Ty far) noexcept {
+    constexpr Ty _0 = static_cast<Ty>(0);
+    constexpr Ty _1 = static_cast<Ty>(1);
+    constexpr Ty _2 = static_cast<Ty>(2);
+    return {
+        _2 * near / width, _0, _0, _0,
+        _0, _2 * near / height, _0, _0,
+        _0, _0, near / (near - far), _1,
+        _0, _0, far * near / (far - near), _0,
+    };
+}
+
+
+template <class Ty>
+matrix4x4<Ty> perspective_fov_reverse(Ty angle, Ty aspect, Ty near, Ty far) noexcept {
+    constexpr Ty _0 = static_cast<Ty>(0);
+    constexpr Ty _1 = static_cast<Ty>(1);
+    const Ty f = _1 / std::tan(angle / static_cast<Ty>(2));
+    return {
+        f / aspect, _0, _0, _0,
+        _0, f, _0, _0,
+        _0, _0, near / (near - far), _1,
+        _0, _0, far * near / (far - near), _0,
+    };
+}
+
+
+template <class Ty>
+constexpr matrix4x4<Ty> perspective_infinite(Ty left, Ty right, Ty bottom, Ty top, Ty near) noexcept {
+    constexpr Ty _0 = static_cast<Ty>(0);
+    constexpr Ty _1 = static_cast<Ty>(1);
+    constexpr Ty _2 = static_cast<Ty>(2);
+    return {
+        _2 * near / (right - left), _0, _0, _0,
+        _0, _2 * near / (bottom - top), _0, _0,
+        (right + left) / (left - right), (bottom + top) / (top - bottom), _1, _1,
+        _0, _0, -near, _0,
+    };
+}
+
+
+template <class Ty>
+constexpr matrix4x4<Ty> perspective_infinite(Ty width, Ty height, Ty near) noexcept {
+    constexpr Ty _0 = static_cast<Ty>(0);
+    constexpr Ty _1 = static_cast<Ty>(1);
+    constexpr Ty _2 = static_cast<Ty>(2);
+    return {
+        _2 * near / width, _0, _0, _0,
+        _0, _2 * near / height, _0, _0,
+        _0, _0, _1, _1,
+        _0, _0, -near, _0,
+    };
+}
+
+
+template <class Ty>
+matrix4x4<Ty> perspective_fov_infinite(Ty angle, Ty aspect, Ty near) noexcept {
+    constexpr Ty _0 = static_cast<Ty>(0);
+    constexpr Ty _1 = static_cast<Ty>(1);
+    const Ty f = _1 / std::tan(angle / static_cast<Ty>(2));
+    return {
+        f / aspect, _0, _0, _0,
+        _0, f, _0, _0,
+        _0, _0, _1, _1,
+        _0, _0, -near, _0,
+    };
+}
+
+
+template <class Ty>
+constexpr matrix4x4<Ty> perspective_infinite_reverse(Ty left, Ty right, Ty bottom, Ty top, Ty near) noexcept {
+    constexpr Ty _0 = static_cast<Ty>(0);
+    constexpr Ty _1 = static_cast<Ty>(1);
+    constexpr Ty _2 = static_cast<Ty>(2);
+    return {
+        _2 * near / (right - left), _0, _0, _0,
+        _0, _2 * near / (bottom - top), _0, _0,
+        (right + left) / (left - right), (bottom + top) / (top - bottom), _0, _1,
+        _0, _0, near, _0,
+    };
+}
+
+
+template <class Ty>
+constexpr matrix4x4<Ty> perspective_infinite_reverse(Ty width, Ty height, Ty near) noexcept {
+    constexpr Ty _0 = static_cast<Ty>(0);
+    constexpr Ty _1 = static_cast<Ty>(1);
+    constexpr Ty _2 = static_cast<Ty>(2);
+    return {
+        _2 * near / width, _0, _0, _0,
+        _0, _2 * near / height, _0, _0,
+        _0, _0, _0, _1,
+        _0, _0, near, _0,
+    };
+}
+
+
+template <class Ty>
+matrix4x4<Ty> perspective_fov_infinite_reverse(Ty angle, Ty aspect, Ty near) noexcept {
+    constexpr Ty _0 = static_cast<Ty>(0);
+    constexpr Ty _1 = static_cast<Ty>(1);
+    const Ty f = _1 / std::tan(angle / static_cast<Ty>(2));
+    return {
+        f / aspect, _0, _0, _0,
+        _0, f, _0, _0,
+        _0, _0, _0, _1,
+        _0, _0, near, _0,
+    };
+}
+
 } // namespace row_major
 } // namespace left_hand
 } // namespace gdv
@@ -40,7 +40,7 @@ public:
 
 
 template<class Ty>
-matrix3x3<Ty> operator+(const matrix3x3<Ty> &m1, const matrix3x3<Ty> &m2) noexcept {
+constexpr matrix3x3<Ty> operator+(const matrix3x3<Ty> &m1, const matrix3x3<Ty> &m2) noexcept {
     return {
         m1.m[0] + m2.m[0],
         m1.m[1] + m2.m[1],
@@ -55,7 +55,7 @@ matrix3x3<Ty> operator+(const matrix3x3<Ty> &m1, const matrix3x3<Ty> &m2) noexce
 }
 
 template<class Ty>
-matrix3x3<Ty> operator-(const matrix3x3<Ty> &m1, const matrix3x3<Ty> &m2) noexcept {
+constexpr matrix3x3<Ty> operator-(const matrix3x3<Ty> &m1, const matrix3x3<Ty> &m2) noexcept {
     return {
         m1.m[0] - m2.m[0],
         m1.m[1] - m2.m[1],
@@ -71,7 +71,7 @@ matrix3x3<Ty> operator-(const matrix3x3<Ty> &m1, const matrix3x3<Ty> &m2) noexce
 
 
 template<class Ty>
-matrix3x3<Ty> operator*(const matrix3x3<Ty> &m1, const matrix3x3<Ty> &m2) noexcept {
+constexpr matrix3x3<Ty> operator*(const matrix3x3<Ty> &m1, const matrix3x3<Ty> &m2) noexcept {
     return{
         m1.m[0] * m2.m[0] + m1.m[1] * m2.m[3] + m1.m[2] * m2.m[6],
         m1.m[0] * m2.m[1] + m1.m[1] * m2.m[4] + m1.m[2] * m2.m[7],
@@ -90,7 +90,7 @@ matrix3x3<Ty> operator*(const matrix3x3<Ty> &m1, const matrix3x3<Ty> &m2) noexce
 
 
 template<class Ty>
-matrix3x3<Ty>& operator+=(matrix3x3<Ty> &m1, const matrix3x3<Ty> &m2) noexcept {
+constexpr matrix3x3<Ty>& operator+=(matrix3x3<Ty> &m1, const matrix3x3<Ty> &m2) noexcept {
     m1.m[0] += m2.m[0];
     m1.m[1] += m2.m[1];
     m1.m[2] += m2.m[2];
@@ -104,7 +104,7 @@ matrix3x3<Ty>& operator+=(matrix3x3<Ty> &m1, const matrix3x3<Ty> &m2) noexcept {
 }
 
 template<class Ty>
-matrix3x3<Ty>& operator-=(matrix3x3<Ty> &m1, const matrix3x3<Ty> &m2) noexcept {
+constexpr matrix3x3<Ty>& operator-=(matrix3x3<Ty> &m1, const matrix3x3<Ty> &m2) noexcept {
     m1.m[0] -= m2.m[0];
     m1.m[1] -= m2.m[1];
     m1.m[2] -= m2.m[2];
@@ -119,7 +119,7 @@ matrix3x3<Ty>& operator-=(matrix3x3<Ty> &m1, const matrix3x3<Ty> &m2) noexcept {
 
 
 template<class Ty>
-matrix3x3<Ty>& operator*=(matrix3x3<Ty> &m1, const matrix3x3<Ty> &m2) noexcept {
+constexpr matrix3x3<Ty>& operator*=(matrix3x3<Ty> &m1, const matrix3x3<Ty> &m2) noexcept {
     matrix3x3<Ty> m{
         m1.m[0] * m2.m[0] + m1.m[1] * m2.m[3] + m1.m[2] * m2.m[6],
         m1.m[0] * m2.m[1] + m1.m[1] * m2.m[4] + m1.m[2] * m2.m[7],
@@ -139,7 +139,7 @@ matrix3x3<Ty>& operator*=(matrix3x3<Ty> &m1, const matrix3x3<Ty> &m2) noexcept {
 
 
 template<class Ty>
-vector4<Ty> operator*(const vector4<Ty> &v, const matrix3x3<Ty> &m) noexcept {
+constexpr vector4<Ty> operator*(const vector4<Ty> &v, const matrix3x3<Ty> &m) noexcept {
     return{
         m.m[0] * v.x + m.m[3] * v.y + m.m[6] * v.z,
         m.m[1] * v.x + m.m[4] * v.y + m.m[7] * v.z,
@@ -148,7 +148,7 @@ vector4<Ty> operator*(const vector4<Ty> &v, const matrix3x3<Ty> &m) noexcept {
 }
 
 template<class Ty>
-vector4<Ty> operator*(const matrix3x3<Ty> &m, const vector4<Ty> &v) noexcept {
+constexpr vector4<Ty> operator*(const matrix3x3<Ty> &m, const vector4<Ty> &v) noexcept {
     return{
         m.m[0] * v.x + m.m[1] * v.y + m.m[2] * v.z,
         m.m[3] * v.x + m.m[4] * v.y + m.m[5] * v.z,
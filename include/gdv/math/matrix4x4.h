@@ -3,11 +3,12 @@
 
 #include <type_traits>
 #include <gdv/math/vector4.h>
+#include <gdv/math/simd.h>
 
 namespace gdv {
 
 template<class Ty>
-class matrix4x4 {
+class alignas(simd_alignment<Ty>) matrix4x4 {
     static_assert(std::is_integral<Ty>::value || std::is_floating_point<Ty>::value, "invalid template parameter.");
 
 public:
@@ -42,7 +43,7 @@ public:
 
 
 template<class Ty>
-matrix4x4<Ty> operator+(const matrix4x4<Ty> &m1, const matrix4x4<Ty> &m2) noexcept {
+constexpr matrix4x4<Ty> operator+(const matrix4x4<Ty> &m1, const matrix4x4<Ty> &m2) noexcept {
     return {
         m1.m[ 0] + m2.m[ 0],
         m1.m[ 1] + m2.m[ 1],
@@ -64,7 +65,7 @@ matrix4x4<Ty> operator+(const matrix4x4<Ty> &m1, const matrix4x4<Ty> &m2) noexce
 }
 
 template<class Ty>
-matrix4x4<Ty> operator-(const matrix4x4<Ty> &m1, const matrix4x4<Ty> &m2) noexcept {
+constexpr matrix4x4<Ty> operator-(const matrix4x4<Ty> &m1, const matrix4x4<Ty> &m2) noexcept {
     return {
         m1.m[ 0] - m2.m[ 0],
         m1.m[ 1] - m2.m[ 1],
@@ -87,7 +88,7 @@ matrix4x4<Ty> operator-(const matrix4x4<Ty> &m1, const matrix4x4<Ty> &m2) noexce
 
 
 template<class Ty>
-matrix4x4<Ty> operator*(const matrix4x4<Ty> &m1, const matrix4x4<Ty> &m2) noexcept {
+constexpr matrix4x4<Ty> operator*(const matrix4x4<Ty> &m1, const matrix4x4<Ty> &m2) noexcept {
     return{
         m1.m[ 0] * m2.m[ 0] + m1.m[ 1] * m2.m[ 4] + m1.m[ 2] * m2.m[ 8] + m1.m[ 3] * m2.m[12],
         m1.m[ 0] * m2.m[ 1] + m1.m[ 1] * m2.m[ 5] + m1.m[ 2] * m2.m[ 9] + m1.m[ 3] * m2.m[13],
@@ -114,7 +115,7 @@ matrix4x4<Ty> operator*(const matrix4x4<Ty> &m1, const matrix4x4<Ty> &m2) noexce
 
 
 template<class Ty>
-matrix4x4<Ty>& operator+=(matrix4x4<Ty> &m1, const matrix4x4<Ty> &m2) noexcept {
+constexpr matrix4x4<Ty>& operator+=(matrix4x4<Ty> &m1, const matrix4x4<Ty> &m2) noexcept {
     m1.m[ 0] += m2.m[ 0];
     m1.m[ 1] += m2.m[ 1];
     m1.m[ 2] += m2.m[ 2];
@@ -135,7 +136,7 @@ matrix4x4<Ty>& operator+=(matrix4x4<Ty> &m1, const matrix4x4<Ty> &m2) noexcept {
 }
 
 template<class Ty>
-matrix4x4<Ty>& operator-=(matrix4x4<Ty> &m1, const matrix4x4<Ty> &m2) noexcept {
+constexpr matrix4x4<Ty>& operator-=(matrix4x4<Ty> &m1, const matrix4x4<Ty> &m2) noexcept {
     m1.m[ 0] -= m2.m[ 0];
     m1.m[ 1] -= m2.m[ 1];
     m1.m[ 2] -= m2.m[ 2];
@@ -157,7 +158,7 @@ matrix4x4<Ty>& operator-=(matrix4x4<Ty> &m1, const matrix4x4<Ty> &m2) noexcept {
 
 
 template<class Ty>
-matrix4x4<Ty>& operator*=(matrix4x4<Ty> &m1, const matrix4x4<Ty> &m2) noexcept {
+constexpr matrix4x4<Ty>& operator*=(matrix4x4<Ty> &m1, const matrix4x4<Ty> &m2) noexcept {
     matrix4x4<Ty> m{
         m1.m[ 0] * m2.m[ 0] + m1.m[ 1] * m2.m[ 4] + m1.m[ 2] * m2.m[ 8] + m1.m[ 3] * m2.m[12],
         m1.m[ 0] * m2.m[ 1] + m1.m[ 1] * m2.m[ 5] + m1.m[ 2] * m2.m[ 9] + m1.m[ 3] * m2.m[13],
@@ -185,7 +186,7 @@ matrix4x4<Ty>& operator*=(matrix4x4<Ty> &m1, const matrix4x4<Ty> &m2) noexcept {
 
 
 template<class Ty>
-vector4<Ty> operator*(const vector4<Ty> &v, const matrix4x4<Ty> &m) noexcept {
+constexpr vector4<Ty> operator*(const vector4<Ty> &v, const matrix4x4<Ty> &m) noexcept {
     return{
         m.m[ 0] * v.x + m.m[ 4] * v.y + m.m[ 8] * v.z + m.m[12] * v.w,
         m.m[ 1] * v.x + m.m[ 5] * v.y + m.m[ 9] * v.z + m.m[13] * v.w,
@@ -195,7 +196,7 @@ vector4<Ty> operator*(const vector4<Ty> &v, const matrix4x4<Ty> &m) noexcept {
 }
 
 template<class Ty>
-vector4<Ty> operator*(const matrix4x4<Ty> &m, const vector4<Ty> &v) noexcept {
+constexpr vector4<Ty> operator*(const matrix4x4<Ty> &m, const vector4<Ty> &v) noexcept {
     return{
         m.m[ 0] * v.x + m.m[ 1] * v.y + m.m[ 2] * v.z + m.m[ 3] * v.w,
         m.m[ 4] * v.x + m.m[ 5] * v.y + m.m[ 6] * v.z + m.m[ 7] * v.w,
@@ -206,7 +207,7 @@ vector4<Ty> operator*(const matrix4x4<Ty> &m, const vector4<Ty> &v) noexcept {
 
 
 template<class Ty>
-vector4<Ty> operator*(const vector3<Ty> &v, const matrix4x4<Ty> &m) noexcept {
+constexpr vector4<Ty> operator*(const vector3<Ty> &v, const matrix4x4<Ty> &m) noexcept {
     return{
         m.m[ 0] * v.x + m.m[ 4] * v.y + m.m[ 8] * v.z + m.m[12],
         m.m[ 1] * v.x + m.m[ 5] * v.y + m.m[ 9] * v.z + m.m[13],
@@ -216,15 +217,105 @@ vector4<Ty> operator*(const vector3<Ty> &v, const matrix4x4<Ty> &m) noexcept {
 }
 
 template<class Ty>
-vector4<Ty> operator*(const matrix4x4<Ty> &m, const vector3<Ty> &v) noexcept {
+constexpr vector4<Ty> operator*(const matrix4x4<Ty> &m, const vector3<Ty> &v) noexcept {
     return{
         m.m[ 0] * v.x + m.m[ 1] * v.y + m.m[ 2] * v.z + m.m[ 3],
         m.m[ 4] * v.x + m.m[ 5] * v.y + m.m[ 6] * v.z + m.m[ 7],
         m.m[ 8] * v.x + m.m[ 9] * v.y + m.m[10] * v.z + m.m[11],
-        m.m[12] * v.x + m.m[12] * v.y + m.m[14] * v.z + m.m[15]
+        m.m[12] * v.x + m.m[13] * v.y + m.m[14] * v.z + m.m[15]
     };
 }
 
+
+
+// floatの多重定義 --------------------------------------------------------------
+// 非テンプレートの多重定義はテンプレートより優先されるため、APIを変えずにSIMD実装へ切り替わります
+// 定数式の中ではSIMDを使えないため、テンプレート版で計算します (判定できないコンパイラではconstexprになりません)
+
+namespace detail {
+
+inline matrix4x4<float> add_simd(const matrix4x4<float> &m1, const matrix4x4<float> &m2) noexcept {
+    matrix4x4<float> m;
+    for (int i = 0; i < 16; i += 4) {
+        simd::store(&m.m[i], simd::add(simd::load(&m1.m[i]), simd::load(&m2.m[i])));
+    }
+    return m;
+}
+
+inline matrix4x4<float> sub_simd(const matrix4x4<float> &m1, const matrix4x4<float> &m2) noexcept {
+    matrix4x4<float> m;
+    for (int i = 0; i < 16; i += 4) {
+        simd::store(&m.m[i], simd::sub(simd::load(&m1.m[i]), simd::load(&m2.m[i])));
+    }
+    return m;
+}
+
+inline matrix4x4<float> mul_simd(const matrix4x4<float> &m1, const matrix4x4<float> &m2) noexcept {
+    const simd::float4 r0 = simd::load(&m2.m[ 0]);
+    const simd::float4 r1 = simd::load(&m2.m[ 4]);
+    const simd::float4 r2 = simd::load(&m2.m[ 8]);
+    const simd::float4 r3 = simd::load(&m2.m[12]);
+    matrix4x4<float> m;
+    for (int i = 0; i < 16; i += 4) {
+        simd::store(&m.m[i], simd::combine(simd::load(&m1.m[i]), r0, r1, r2, r3));
+    }
+    return m;
+}
+
+inline vector4<float> mul_simd(const vector4<float> &v, const matrix4x4<float> &m) noexcept {
+    vector4<float> r;
+    simd::store(&r.x, simd::combine(simd::load(&v.x),
+        simd::load(&m.m[0]), simd::load(&m.m[4]), simd::load(&m.m[8]), simd::load(&m.m[12])));
+    return r;
+}
+
+inline vector4<float> mul_simd(const matrix4x4<float> &m, const vector4<float> &v) noexcept {
+    simd::float4 c0 = simd::load(&m.m[ 0]);
+    simd::float4 c1 = simd::load(&m.m[ 4]);
+    simd::float4 c2 = simd::load(&m.m[ 8]);
+    simd::float4 c3 = simd::load(&m.m[12]);
+    simd::transpose(c0, c1, c2, c3);
+    vector4<float> r;
+    simd::store(&r.x, simd::combine(simd::load(&v.x), c0, c1, c2, c3));
+    return r;
+}
+
+} // namespace detail
+
+
+inline GDV_SIMD_CONSTEXPR matrix4x4<float> operator+(const matrix4x4<float> &m1, const matrix4x4<float> &m2) noexcept {
+    return detail::is_constant_evaluated() ? operator+<float>(m1, m2) : detail::add_simd(m1, m2);
+}
+
+inline GDV_SIMD_CONSTEXPR matrix4x4<float> operator-(const matrix4x4<float> &m1, const matrix4x4<float> &m2) noexcept {
+    return detail::is_constant_evaluated() ? operator-<float>(m1, m2) : detail::sub_simd(m1, m2);
+}
+
+inline GDV_SIMD_CONSTEXPR matrix4x4<float> operator*(const matrix4x4<float> &m1, const matrix4x4<float> &m2) noexcept {
+    return detail::is_constant_evaluated() ? operator*<float>(m1, m2) : detail::mul_simd(m1, m2);
+}
+
+inline GDV_SIMD_CONSTEXPR matrix4x4<float>& operator+=(matrix4x4<float> &m1, const matrix4x4<float> &m2) noexcept {
+    return m1 = m1 + m2;
+}
+
+inline GDV_SIMD_CONSTEXPR matrix4x4<float>& operator-=(matrix4x4<float> &m1, const matrix4x4<float> &m2) noexcept {
+    return m1 = m1 - m2;
+}
+
+inline GDV_SIMD_CONSTEXPR matrix4x4<float>& operator*=(matrix4x4<float> &m1, const matrix4x4<float> &m2) noexcept {
+    return m1 = m1 * m2;
+}
+
+inline GDV_SIMD_CONSTEXPR vector4<float> operator*(const vector4<float> &v, const matrix4x4<float> &m) noexcept {
+    return detail::is_constant_evaluated() ? operator*<float>(v, m) : detail::mul_simd(v, m);
+}
+
+inline GDV_SIMD_CONSTEXPR vector4<float> operator*(const matrix4x4<float> &m, const vector4<float> &v) noexcept {
+    return detail::is_constant_evaluated() ? operator*<float>(m, v) : detail::mul_simd(m, v);
+}
+
+
 using mat4 = matrix4x4<float>;
 
 } // namespace gdv
@@ -2,10 +2,12 @@
 #define GDV_QUATERNION_H_
 
 
+#include <cmath>
 #include <type_traits>
 #include <gdv/math/vector3.h>
 #include <gdv/math/matrix4x4.h>
 #include <gdv/math/euler.h>
+#include <gdv/math/fast_math.h>
 
 namespace gdv {
 
@@ -38,14 +40,18 @@ public:
 
 
     quaternion(euler<Ty> e) noexcept :
+        quaternion{e, std_math{}} {}
+
+
+    // Math に fast_math を渡すと、三角関数を近似関数で計算します
+    template <class Math>
+    quaternion(euler<Ty> e, Math) noexcept :
         t{},x{},y{},z{} {
         constexpr Ty half = static_cast<Ty>(0.5);
-        Ty t0 = std::cos(e.z * half);
-        Ty t1 = std::sin(e.z * half);
-        Ty t2 = std::cos(e.x * half);
-        Ty t3 = std::sin(e.x * half);
-        Ty t4 = std::cos(e.y * half);
-        Ty t5 = std::sin(e.y * half);
+        Ty t0, t1, t2, t3, t4, t5;
+        Math::sincos(e.z * half, t1, t0);
+        Math::sincos(e.x * half, t3, t2);
+        Math::sincos(e.y * half, t5, t4);
 
         t = t0 * t2 * t4 + t1 * t3 * t5;
         x = t0 * t3 * t4 - t1 * t2 * t5;
@@ -71,21 +77,28 @@ public:
 
 
     operator euler<Ty>() noexcept {
+        return to_euler();
+    }
+
+
+    // Math に fast_math を指定すると、逆三角関数を近似関数で計算します
+    template <class Math = std_math>
+    euler<Ty> to_euler() const noexcept {
         constexpr Ty _1 = static_cast<Ty>(1);
         constexpr Ty _2 = static_cast<Ty>(2);
         euler<Ty> e;
         Ty t0 = _2 * (t * x + y * z);
         Ty t1 = _1 - _2 * (x * x + y * y);
-        e.x = std::atan2(t0, t1);
+        e.x = Math::atan2(t0, t1);
 
         t0 = _2 * (t * y - z * x);
         t0 = t0 > _1  ? _1  : t0;
         t0 = t0 < -_1 ? -_1 : t0;
-        e.y = std::asin(t0);
+        e.y = Math::asin(t0);
 
         t0 = _2 * (t * z + x * y);
         t1 = _1 - _2 * (y * y + z * z);
-        e.z = std::atan2(t0, t1);
+        e.z = Math::atan2(t0, t1);
         return e;
     }
 
@@ -98,6 +111,157 @@ public:
 };
 
 
+
+/**
+* @brief 内積を求めます
+**/
+template <class Ty>
+Ty dot(quaternion<Ty> q1, quaternion<Ty> q2) noexcept {
+    return q1.t * q2.t + q1.x * q2.x + q1.y * q2.y + q1.z * q2.z;
+}
+
+
+
+/**
+* @brief 長さを1にします
+**/
+template <class Ty>
+quaternion<Ty> normalize(quaternion<Ty> q) noexcept {
+    const Ty r = static_cast<Ty>(1) / std::sqrt(dot(q, q));
+    return {q.t * r, q.x * r, q.y * r, q.z * r};
+}
+
+
+
+namespace detail {
+
+// q1 * w1 + q2 * w2 を正規化して返します
+template <class Ty>
+quaternion<Ty> blend(quaternion<Ty> q1, Ty w1, quaternion<Ty> q2, Ty w2) noexcept {
+    return normalize(quaternion<Ty>{
+        q1.t * w1 + q2.t * w2,
+        q1.x * w1 + q2.x * w2,
+        q1.y * w1 + q2.y * w2,
+        q1.z * w1 + q2.z * w2});
+}
+
+} // namespace detail
+
+
+
+/**
+* @brief 線形補間した結果を正規化します
+* @tparam Ty 浮動小数点型のみ受付ます
+* @param[in] q1 始点 (単位クォータニオン)
+* @param[in] q2 終点 (単位クォータニオン)
+* @param[in] t  補間係数 [0, 1]
+* @return quaternion<Ty>
+* @exception none
+* @details 最短経路で補間します。角速度は一定になりません
+**/
+template <class Ty>
+quaternion<Ty> nlerp(quaternion<Ty> q1, quaternion<Ty> q2, Ty t) noexcept {
+    constexpr Ty _0 = static_cast<Ty>(0);
+    constexpr Ty _1 = static_cast<Ty>(1);
+    return detail::blend(q1, _1 - t, q2, dot(q1, q2) < _0 ? -t : t);
+}
+
+
+
+/**
+* @brief 球面線形補間します
+* @tparam Ty 浮動小数点型のみ受付ます
+* @param[in] q1 始点 (単位クォータニオン)
+* @param[in] q2 終点 (単位クォータニオン)
+* @param[in] t  補間係数 [0, 1]
+* @return quaternion<Ty>
+* @exception none
+* @details 最短経路で補間します。q1とq2がほぼ同じ向きの場合はnlerpになります
+**/
+template <class Ty>
+quaternion<Ty> slerp(quaternion<Ty> q1, quaternion<Ty> q2, Ty t) noexcept {
+    constexpr Ty _0 = static_cast<Ty>(0);
+    constexpr Ty _1 = static_cast<Ty>(1);
+    constexpr Ty threshold = static_cast<Ty>(0.9995);
+    const Ty d = dot(q1, q2);
+    const Ty c = std::fabs(d);
+    Ty w1 = _1 - t;
+    Ty w2 = t;
+    if (c < threshold) {
+        const Ty a = std::acos(c);
+        const Ty r = _1 / std::sin(a);
+        w1 = std::sin(w1 * a) * r;
+        w2 = std::sin(w2 * a) * r;
+    }
+    return detail::blend(q1, w1, q2, d < _0 ? -w2 : w2);
+}
+
+
+
+/**
+* @brief 補間係数を多項式で補正したnlerpでslerpを近似します
+* @tparam Ty 浮動小数点型のみ受付ます
+* @param[in] q1 始点 (単位クォータニオン)
+* @param[in] q2 終点 (単位クォータニオン)
+* @param[in] t  補間係数 [0, 1]
+* @return quaternion<Ty>
+* @exception none
+* @details 三角関数を使わずに、slerpとの角度の誤差を1e-3ラジアン程度に抑えます
+**/
+template <class Ty>
+quaternion<Ty> fast_slerp(quaternion<Ty> q1, quaternion<Ty> q2, Ty t) noexcept {
+    constexpr Ty _0 = static_cast<Ty>(0);
+    constexpr Ty _1 = static_cast<Ty>(1);
+    constexpr Ty half = static_cast<Ty>(0.5);
+    const Ty d = dot(q1, q2);
+    const Ty c = std::fabs(d);
+    const Ty a = static_cast<Ty>(1.0904) + c * (static_cast<Ty>(-3.2452) + c * (static_cast<Ty>(3.55645) - c * static_cast<Ty>(1.43519)));
+    const Ty b = static_cast<Ty>(0.848013) + c * (static_cast<Ty>(-1.06021) + c * static_cast<Ty>(0.215638));
+    const Ty k = a * (t - half) * (t - half) + b;
+    const Ty u = t + t * (t - half) * (t - _1) * k;
+    return detail::blend(q1, _1 - u, q2, d < _0 ? -u : u);
+}
+
+
+
+
+namespace detail {
+
+/**
+* @brief 回転行列 (v' = R * v の形式、mijはi行j列) の要素からクォータニオンを取り出します
+* @details 対角要素の大きさで4通りに場合分けし、除算の分母が最大になる成分から求めます
+**/
+template <class Ty>
+quaternion<Ty> to_quaternion(Ty m00, Ty m01, Ty m02,
+                             Ty m10, Ty m11, Ty m12,
+                             Ty m20, Ty m21, Ty m22) noexcept {
+    constexpr Ty _0 = static_cast<Ty>(0);
+    constexpr Ty _1 = static_cast<Ty>(1);
+    constexpr Ty half = static_cast<Ty>(0.5);
+    const Ty tr = m00 + m11 + m22;
+    if (_0 < tr) {
+        const Ty r = std::sqrt(_1 + tr);
+        const Ty f = half / r;
+        return {half * r, (m21 - m12) * f, (m02 - m20) * f, (m10 - m01) * f};
+    }
+    if (m00 < (m11 < m22 ? m22 : m11)) {
+        if (m11 < m22) {
+            const Ty r = std::sqrt(_1 - m00 - m11 + m22);
+            const Ty f = half / r;
+            return {(m10 - m01) * f, (m02 + m20) * f, (m12 + m21) * f, half * r};
+        }
+        const Ty r = std::sqrt(_1 - m00 + m11 - m22);
+        const Ty f = half / r;
+        return {(m02 - m20) * f, (m01 + m10) * f, half * r, (m12 + m21) * f};
+    }
+    const Ty r = std::sqrt(_1 + m00 - m11 - m22);
+    const Ty f = half / r;
+    return {(m21 - m12) * f, half * r, (m01 + m10) * f, (m02 + m20) * f};
+}
+
+} // namespace detail
+
+
 namespace column_major {
 namespace right_hand {
 
@@ -126,6 +290,22 @@ matrix4x4<Ty> to_matrix(quaternion<Ty> q) noexcept {
     };
 }
 
+
+/**
+* @brief 回転行列からクォータニオンを取り出します
+* @tparam Ty 浮動小数点型のみ受付ます
+* @param[in] m to_matrix()で作成した行列 (拡大縮小を含まない回転行列)
+* @return quaternion<Ty>
+* @exception none
+* @details qと-qは同じ回転を表すため、符号はto_matrix()に渡した値と一致するとは限りません
+**/
+template <class Ty>
+quaternion<Ty> to_quaternion(const matrix4x4<Ty> &m) noexcept {
+    return detail::to_quaternion(m.m[0], m.m[4], m.m[ 8],
+                                 m.m[1], m.m[5], m.m[ 9],
+                                 m.m[2], m.m[6], m.m[10]);
+}
+
 template <class Ty>
 quaternion<Ty> operator * (quaternion<Ty> q1, quaternion<Ty> q2) noexcept {
     quaternion<Ty> q{};
@@ -200,6 +380,14 @@ matrix4x4<Ty> to_matrix(quaternion<Ty> q) noexcept {
     };
 }
 
+
+template <class Ty>
+quaternion<Ty> to_quaternion(const matrix4x4<Ty> &m) noexcept {
+    return detail::to_quaternion(m.m[0], m.m[1], m.m[ 2],
+                                 m.m[4], m.m[5], m.m[ 6],
+                                 m.m[8], m.m[9], m.m[10]);
+}
+
 template <class Ty>
 quaternion<Ty> operator * (quaternion<Ty> q1, quaternion<Ty> q2) noexcept {
     quaternion<Ty> q{};
@@ -278,6 +466,14 @@ matrix4x4<Ty> to_matrix(quaternion<Ty> q) noexcept {
     };
 }
 
+
+template <class Ty>
+quaternion<Ty> to_quaternion(const matrix4x4<Ty> &m) noexcept {
+    return detail::to_quaternion(m.m[0], m.m[1], m.m[ 2],
+                                 m.m[4], m.m[5], m.m[ 6],
+                                 m.m[8], m.m[9], m.m[10]);
+}
+
 template <class Ty>
 quaternion<Ty> operator * (quaternion<Ty> q1, quaternion<Ty> q2) noexcept {
     quaternion<Ty> q{};
@@ -356,6 +552,14 @@ matrix4x4<Ty> to_matrix(quaternion<Ty> q) noexcept {
 }
 
 
+template <class Ty>
+quaternion<Ty> to_quaternion(const matrix4x4<Ty> &m) noexcept {
+    return detail::to_quaternion(m.m[0], m.m[4], m.m[ 8],
+                                 m.m[1], m.m[5], m.m[ 9],
+                                 m.m[2], m.m[6], m.m[10]);
+}
+
+
 template <class Ty>
 quaternion<Ty> operator * (quaternion<Ty> q1, quaternion<Ty> q2) noexcept {
     quaternion<Ty> q{};
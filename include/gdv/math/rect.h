@@ -36,8 +36,8 @@ public:
 
 
 public:
-    Ty width() const noexcept {return right - left;}
-    Ty height() const noexcept {return bottom - top;}
+    constexpr Ty width() const noexcept {return right - left;}
+    constexpr Ty height() const noexcept {return bottom - top;}
 
 
 public:
@@ -0,0 +1,296 @@
+/**
+* @file shadow_cascade.h
+* @brief カスケードシャドウマップの行列を一括で作成する関数の宣言
+* @details カメラの視錐台を奥行き方向に分割し、分割ごとに外接球を囲む平行投影行列を作成します
+*          外接球の半径はカメラの向きに依存しないため、カメラが回転しても投影範囲は変化しません
+*          さらに中心をシャドウマップのテクセル単位に丸めるため、カメラが移動しても影のちらつきが起きません
+*          丸めた分だけ外接球がはみ出さないよう、投影範囲は半径に1テクセルを加えた大きさになります
+**/
+#ifndef GDV_SHADOW_CASCADE_H_
+#define GDV_SHADOW_CASCADE_H_
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <gdv/math/vector3.h>
+#include <gdv/math/vector4.h>
+#include <gdv/math/matrix4x4.h>
+#include <gdv/math/math_function.h>
+#include <gdv/math/camera.h>
+#include <gdv/math/frustum.h>
+#include <gdv/tools/parallel.h>
+
+namespace gdv {
+
+/**
+* @brief 視錐台の分割方法です
+* @details 分割位置は lambda * 対数分割 + (1 - lambda) * 均等分割 (実用分割) で決まります
+**/
+template <class Ty>
+struct cascade_split {
+    Ty lambda;      //!< 0で均等分割、1で対数分割
+    Ty distance;    //!< 影を描画する最大距離 (0以下でカメラのfar、無限遠の投影モードでは正の値が必要です)
+};
+
+
+/**
+* @brief カスケード1段分の行列です
+* @details view、projection、view_projectionは関数を呼び出した名前空間の規約で作成されます
+*          light_frustumはライトから見た投影範囲です。near平面は外接球に接しているため、
+*          手前の遮蔽物を含める場合はnear平面を無視するか、depth clampで描画してください
+**/
+template <class Ty>
+struct shadow_cascade {
+    Ty              near;               //!< 分割の手前の距離 (カメラの視線方向)
+    Ty              far;                //!< 分割の奥の距離
+    vector3<Ty>     center;             //!< 分割した視錐台の外接球の中心
+    Ty              radius;             //!< 外接球の半径
+    matrix4x4<Ty>   view;               //!< ライトのビュー行列 (回転のみ)
+    matrix4x4<Ty>   projection;         //!< テクセル単位に丸めた平行投影行列
+    matrix4x4<Ty>   view_projection;    //!< ビュー・射影行列
+    frustum<Ty>     light_frustum;      //!< ビュー・射影行列の視錐台
+};
+
+
+
+namespace detail {
+
+/**
+* @brief count分割したときのi番目の分割位置を計算します
+* @details 対数分割はnearが正の場合のみ定義されるため、nearが0以下の場合とlambdaが0以下の場合は均等分割のみを使います
+**/
+template <class Ty>
+Ty split_distance(Ty near, Ty far, Ty lambda, size_t i, size_t count) noexcept {
+    constexpr Ty _0 = static_cast<Ty>(0);
+    constexpr Ty _1 = static_cast<Ty>(1);
+    const Ty t = static_cast<Ty>(i) / static_cast<Ty>(count);
+    const Ty un = near + (far - near) * t;
+    if (!(lambda > _0 && near > _0)) { return un; }
+    const Ty lg = near * std::pow(far / near, t);
+    return lambda * lg + (_1 - lambda) * un;
+}
+
+
+/**
+* @brief カメラのcount個のカスケードをcolumn_majorの規約で作成します
+* @param[in] sign    ビュー空間で視線方向のz成分の符号 (右手系で-1、左手系で1)
+* @param[in] look_at ビュー行列を作成する関数
+* @param[in] ortho   平行投影行列を作成する関数
+* @return 引数が不正な場合はfalse (outは変更しません)
+**/
+template <class Ty, class LookAt, class Ortho>
+bool shadow_cascades(const camera<Ty> &c, vector3<Ty> light, cascade_split<Ty> split, size_t count, size_t resolution,
+                     Ty sign, LookAt look_at, Ortho ortho, shadow_cascade<Ty> *out) noexcept {
+    constexpr Ty _0 = static_cast<Ty>(0);
+    constexpr Ty _1 = static_cast<Ty>(1);
+    constexpr Ty _2 = static_cast<Ty>(2);
+
+    const bool infinite = c.get_mode() == camera<Ty>::mode::infinite_perspective ||
+                          c.get_mode() == camera<Ty>::mode::reverse_infinite_perspective;
+    if (infinite && !(split.distance > _0)) { return false; }
+    if (resolution < 3) { return false; }
+
+    const vector3<Ty> forward = normalize(c.get_dst() - c.get_pos());
+    const Ty near = c.get_near();
+    const Ty far = split.distance > _0 ? split.distance : c.get_far();
+    const bool perspective = c.get_mode() != camera<Ty>::mode::orthogonal;
+    if (!(far > near) || (perspective && !(near > _0))) { return false; }
+
+    // 距離dの断面の対角線の半分は、透視投影ではd * k、平行投影ではk
+    const Ty hx = std::abs(c.get_width()) / _2;
+    const Ty hy = std::abs(c.get_height()) / _2;
+    const Ty k = std::sqrt(hx * hx + hy * hy) / (perspective ? near : _1);
+
+    // 全カスケードで共通のライトの回転
+    const vector3<Ty> dir = normalize(light);
+    const vector3<Ty> up = std::abs(dir.y) < static_cast<Ty>(0.99) ? vector3<Ty>{_0, _1, _0} : vector3<Ty>{_1, _0, _0};
+    const matrix4x4<Ty> view = look_at(vector3<Ty>{}, dir, up);
+
+    for (size_t i = 0; i < count; ++i) {
+        shadow_cascade<Ty> &s = out[i];
+        const Ty d0 = i == 0 ? near : out[i - 1].far;
+        const Ty d1 = split_distance(near, far, split.lambda, i + 1, count);
+        const Ty a = perspective ? d0 * k : k;
+        const Ty b = perspective ? d1 * k : k;
+
+        // 手前と奥の断面の四隅から等距離になる軸上の点を中心とします (厚さ0の分割では手前の断面の中心)
+        const Ty t = d1 > d0 ? std::min(std::max((d1 * d1 - d0 * d0 + b * b - a * a) / (_2 * (d1 - d0)), d0), d1) : d0;
+        const Ty r = std::max(std::sqrt((t - d0) * (t - d0) + a * a), std::sqrt((d1 - t) * (d1 - t) + b * b));
+        const vector3<Ty> center = c.get_pos() + forward * t;
+
+        // ライト空間の中心をテクセル単位に丸めます
+        // 丸めで中心は最大1テクセルずれるため、半径に1テクセルを加えた範囲 (resolutionテクセル) を投影します
+        const vector4<Ty> lc = view * vector4<Ty>{center.x, center.y, center.z, _1};
+        const Ty texel = _2 * r / static_cast<Ty>(resolution - 2);
+        const Ty h = r + texel;
+        const Ty x = std::floor(lc.x / texel) * texel;
+        const Ty y = std::floor(lc.y / texel) * texel;
+        const Ty z = sign * lc.z;
+
+        s.near = d0;
+        s.far = d1;
+        s.center = center;
+        s.radius = r;
+        s.view = view;
+        s.projection = ortho(x - h, x + h, y - h, y + h, z - r, z + r);
+        s.view_projection = s.projection * view;
+        s.light_frustum = column_major::to_frustum(s.view_projection);
+    }
+    return true;
+}
+
+
+template <class Ty>
+void transpose_cascades(shadow_cascade<Ty> *out, size_t count) noexcept {
+    for (size_t i = 0; i < count; ++i) {
+        out[i].view = transpose(out[i].view);
+        out[i].projection = transpose(out[i].projection);
+        out[i].view_projection = transpose(out[i].view_projection);
+    }
+}
+
+} // namespace detail
+
+
+
+
+namespace column_major {
+namespace right_hand {
+
+/**
+* @brief カメラの視錐台を分割し、カスケードシャドウマップの行列を一括で作成します
+* @param[in]  c          カメラ
+* @param[in]  light      ライトの光の進む方向
+* @param[in]  split      分割方法
+* @param[in]  count      カスケードの数
+* @param[in]  resolution シャドウマップの1辺のテクセル数 (3以上)
+* @param[out] out        count個のカスケードの出力先
+* @return 次の場合はfalseを返し、outは変更しません
+*         - 無限遠の投影モードのカメラでsplit.distanceが0以下
+*         - resolutionが3未満
+*         - 奥の距離がnear以下、または透視投影でnearが0以下
+* @exception none
+**/
+template <class Ty>
+bool shadow_cascades(const camera<Ty> &c, vector3<Ty> light, cascade_split<Ty> split, size_t count, size_t resolution,
+                     shadow_cascade<Ty> *out) noexcept {
+    return detail::shadow_cascades(c, light, split, count, resolution, static_cast<Ty>(-1),
+        [](vector3<Ty> p, vector3<Ty> d, vector3<Ty> u) noexcept {return look_at(p, d, u);},
+        [](Ty l, Ty r, Ty b, Ty t, Ty n, Ty f) noexcept {return orthogonal(l, r, b, t, n, f);},
+        out);
+}
+
+
+/**
+* @brief 複数のカメラのカスケードを一括で作成します
+* @param[in]  c       カメラの配列
+* @param[in]  n       カメラの数
+* @param[out] out     n * count個の出力先 (カメラiのカスケードは out[i * count] から並びます)
+* @param[in]  threads スレッド数
+* @return いずれかのカメラでshadow_cascadesがfalseを返した場合はfalse
+* @details その他の引数はshadow_cascadesと同じです
+**/
+template <class Ty>
+bool shadow_cascades(const camera<Ty> *c, size_t n, vector3<Ty> light, cascade_split<Ty> split, size_t count, size_t resolution,
+                     shadow_cascade<Ty> *out, size_t threads = 1) {
+    std::atomic<bool> ok{true};
+    parallel_for(n, threads, [&](size_t first, size_t last) {
+        for (size_t i = first; i < last; ++i) {
+            if (!shadow_cascades(c[i], light, split, count, resolution, out + i * count)) { ok = false; }
+        }
+    }, 16);
+    return ok;
+}
+
+} // namespace right_hand
+
+
+namespace left_hand {
+
+template <class Ty>
+bool shadow_cascades(const camera<Ty> &c, vector3<Ty> light, cascade_split<Ty> split, size_t count, size_t resolution,
+                     shadow_cascade<Ty> *out) noexcept {
+    return detail::shadow_cascades(c, light, split, count, resolution, static_cast<Ty>(1),
+        [](vector3<Ty> p, vector3<Ty> d, vector3<Ty> u) noexcept {return look_at(p, d, u);},
+        [](Ty l, Ty r, Ty b, Ty t, Ty n, Ty f) noexcept {return orthogonal(l, r, b, t, n, f);},
+        out);
+}
+
+
+template <class Ty>
+bool shadow_cascades(const camera<Ty> *c, size_t n, vector3<Ty> light, cascade_split<Ty> split, size_t count, size_t resolution,
+                     shadow_cascade<Ty> *out, size_t threads = 1) {
+    std::atomic<bool> ok{true};
+    parallel_for(n, threads, [&](size_t first, size_t last) {
+        for (size_t i = first; i < last; ++i) {
+            if (!shadow_cascades(c[i], light, split, count, resolution, out + i * count)) { ok = false; }
+        }
+    }, 16);
+    return ok;
+}
+
+} // namespace left_hand
+} // namespace column_major
+
+
+
+
+namespace row_major {
+namespace right_hand {
+
+/**
+* @brief カメラの視錐台を分割し、カスケードシャドウマップの行列を一括で作成します
+* @details 引数はcolumn_major::right_hand::shadow_cascadesと同じです
+**/
+template <class Ty>
+bool shadow_cascades(const camera<Ty> &c, vector3<Ty> light, cascade_split<Ty> split, size_t count, size_t resolution,
+                     shadow_cascade<Ty> *out) noexcept {
+    if (!column_major::right_hand::shadow_cascades(c, light, split, count, resolution, out)) { return false; }
+    detail::transpose_cascades(out, count);
+    return true;
+}
+
+
+template <class Ty>
+bool shadow_cascades(const camera<Ty> *c, size_t n, vector3<Ty> light, cascade_split<Ty> split, size_t count, size_t resolution,
+                     shadow_cascade<Ty> *out, size_t threads = 1) {
+    std::atomic<bool> ok{true};
+    parallel_for(n, threads, [&](size_t first, size_t last) {
+        for (size_t i = first; i < last; ++i) {
+            if (!shadow_cascades(c[i], light, split, count, resolution, out + i * count)) { ok = false; }
+        }
+    }, 16);
+    return ok;
+}
+
+} // namespace right_hand
+
+
+namespace left_hand {
+
+template <class Ty>
+bool shadow_cascades(const camera<Ty> &c, vector3<Ty> light, cascade_split<Ty> split, size_t count, size_t resolution,
+                     shadow_cascade<Ty> *out) noexcept {
+    if (!column_major::left_hand::shadow_cascades(c, light, split, count, resolution, out)) { return false; }
+    detail::transpose_cascades(out, count);
+    return true;
+}
+
+
+template <class Ty>
+bool shadow_cascades(const camera<Ty> *c, size_t n, vector3<Ty> light, cascade_split<Ty> split, size_t count, size_t resolution,
+                     shadow_cascade<Ty> *out, size_t threads = 1) {
+    std::atomic<bool> ok{true};
+    parallel_for(n, threads, [&](size_t first, size_t last) {
+        for (size_t i = first; i < last; ++i) {
+            if (!shadow_cascades(c[i], light, split, count, resolution, out + i * count)) { ok = false; }
+        }
+    }, 16);
+    return ok;
+}
+
+} // namespace left_hand
+} // namespace row_major
+} // namespace gdv
+
+#endif
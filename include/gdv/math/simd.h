@@ -0,0 +1,320 @@
+/**
+* @file simd.h
+* @brief 4要素のfloatベクトル演算を抽象化するSIMDラッパーです
+* @details SSE、NEON、スカラのいずれかをコンパイル時に選択します
+*          GDV_NO_SIMDを定義するとスカラ実装が強制されます
+**/
+#ifndef GDV_SIMD_H_
+#define GDV_SIMD_H_
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+#if !defined(GDV_NO_SIMD) && (defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1))
+#define GDV_SIMD_SSE 1
+#include <xmmintrin.h>
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define GDV_SIMD_SSE2 1
+#include <emmintrin.h>
+#endif
+#elif !defined(GDV_NO_SIMD) && (defined(__ARM_NEON) || defined(__ARM_NEON__))
+#define GDV_SIMD_NEON 1
+#include <arm_neon.h>
+#else
+#define GDV_SIMD_SCALAR 1
+#endif
+
+#if defined(__has_builtin)
+#if __has_builtin(__builtin_is_constant_evaluated)
+#define GDV_HAS_CONSTANT_EVALUATED 1
+#endif
+#endif
+#if !defined(GDV_HAS_CONSTANT_EVALUATED) && ((defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 9) || (defined(_MSC_VER) && _MSC_VER >= 1925))
+#define GDV_HAS_CONSTANT_EVALUATED 1
+#endif
+
+// SIMD実装へ切り替える関数は、定数式の評価中を判定できる場合のみconstexprにします
+#if defined(GDV_HAS_CONSTANT_EVALUATED)
+#define GDV_SIMD_CONSTEXPR constexpr
+#else
+#define GDV_SIMD_CONSTEXPR
+#endif
+
+namespace gdv {
+namespace detail {
+
+/**
+* @brief 定数式の評価中かどうかを返します (C++20のstd::is_constant_evaluated相当)
+* @details コンパイラが対応していない場合は常にfalseとなり、floatの行列演算はconstexprになりません
+**/
+constexpr bool is_constant_evaluated() noexcept {
+#if defined(GDV_HAS_CONSTANT_EVALUATED)
+    return __builtin_is_constant_evaluated();
+#else
+    return false;
+#endif
+}
+
+} // namespace detail
+
+
+namespace simd {
+
+/**
+* @class float4
+* @brief 4要素のfloatを1レジスタとして扱います
+* @details 積和は乗算と加算に分けて行うため、スカラ実装と同じ丸め結果になります
+*          mask4は比較結果を表し、select()でレーンごとに値を選択します
+*          exp2i()は整数値のkについて2^kを求めます (kは[-126, 127]の範囲である必要があります)
+*          sub_cvt()は4要素のdouble配列の差をdoubleで計算してからfloatに丸めます (アライメントは不要です)
+**/
+#if defined(GDV_SIMD_SSE)
+
+struct float4 {
+    __m128 v;
+};
+
+struct mask4 {
+    __m128 v;
+};
+
+inline float4 load(const float *p) noexcept {return {_mm_load_ps(p)};}
+inline float4 loadu(const float *p) noexcept {return {_mm_loadu_ps(p)};}
+inline void store(float *p, float4 a) noexcept {_mm_store_ps(p, a.v);}
+inline void storeu(float *p, float4 a) noexcept {_mm_storeu_ps(p, a.v);}
+inline float4 set(float x, float y, float z, float w) noexcept {return {_mm_setr_ps(x, y, z, w)};}
+inline float4 splat(float x) noexcept {return {_mm_set1_ps(x)};}
+inline float4 zero() noexcept {return {_mm_setzero_ps()};}
+inline float4 add(float4 a, float4 b) noexcept {return {_mm_add_ps(a.v, b.v)};}
+inline float4 sub(float4 a, float4 b) noexcept {return {_mm_sub_ps(a.v, b.v)};}
+inline float4 mul(float4 a, float4 b) noexcept {return {_mm_mul_ps(a.v, b.v)};}
+inline float4 div(float4 a, float4 b) noexcept {return {_mm_div_ps(a.v, b.v)};}
+inline float4 min(float4 a, float4 b) noexcept {return {_mm_min_ps(a.v, b.v)};}
+inline float4 max(float4 a, float4 b) noexcept {return {_mm_max_ps(a.v, b.v)};}
+inline float4 sqrt(float4 a) noexcept {return {_mm_sqrt_ps(a.v)};}
+inline float4 abs(float4 a) noexcept {return {_mm_andnot_ps(_mm_set1_ps(-0.0f), a.v)};}
+inline float4 copysign(float4 a, float4 b) noexcept {
+    const __m128 s = _mm_set1_ps(-0.0f);
+    return {_mm_or_ps(_mm_andnot_ps(s, a.v), _mm_and_ps(s, b.v))};
+}
+inline mask4 less(float4 a, float4 b) noexcept {return {_mm_cmplt_ps(a.v, b.v)};}
+inline float4 select(mask4 m, float4 a, float4 b) noexcept {return {_mm_or_ps(_mm_and_ps(m.v, a.v), _mm_andnot_ps(m.v, b.v))};}
+#if defined(GDV_SIMD_SSE2)
+inline float4 exp2i(float4 k) noexcept {
+    return {_mm_castsi128_ps(_mm_slli_epi32(_mm_add_epi32(_mm_cvtps_epi32(k.v), _mm_set1_epi32(127)), 23))};
+}
+#else
+inline float4 exp2i(float4 k) noexcept {
+    float x[4];
+    _mm_storeu_ps(x, k.v);
+    for (int i = 0; i < 4; ++i) {
+        const uint32_t b = static_cast<uint32_t>(static_cast<int32_t>(x[i]) + 127) << 23;
+        std::memcpy(&x[i], &b, sizeof(b));
+    }
+    return {_mm_loadu_ps(x)};
+}
+#endif
+
+#if defined(GDV_SIMD_SSE2)
+inline float4 sub_cvt(const double *a, const double *b) noexcept {
+    const __m128 lo = _mm_cvtpd_ps(_mm_sub_pd(_mm_loadu_pd(a), _mm_loadu_pd(b)));
+    const __m128 hi = _mm_cvtpd_ps(_mm_sub_pd(_mm_loadu_pd(a + 2), _mm_loadu_pd(b + 2)));
+    return {_mm_movelh_ps(lo, hi)};
+}
+#else
+inline float4 sub_cvt(const double *a, const double *b) noexcept {
+    return set(static_cast<float>(a[0] - b[0]), static_cast<float>(a[1] - b[1]),
+               static_cast<float>(a[2] - b[2]), static_cast<float>(a[3] - b[3]));
+}
+#endif
+
+template <int I>
+inline float4 broadcast(float4 a) noexcept {return {_mm_shuffle_ps(a.v, a.v, _MM_SHUFFLE(I, I, I, I))};}
+
+// (a[X], a[Y], b[Z], b[W]) を返します
+template <int X, int Y, int Z, int W>
+inline float4 shuffle(float4 a, float4 b) noexcept {return {_mm_shuffle_ps(a.v, b.v, _MM_SHUFFLE(W, Z, Y, X))};}
+
+inline void transpose(float4 &a, float4 &b, float4 &c, float4 &d) noexcept {
+    _MM_TRANSPOSE4_PS(a.v, b.v, c.v, d.v);
+}
+
+#elif defined(GDV_SIMD_NEON)
+
+struct float4 {
+    float32x4_t v;
+};
+
+struct mask4 {
+    uint32x4_t v;
+};
+
+inline float4 load(const float *p) noexcept {return {vld1q_f32(p)};}
+inline float4 loadu(const float *p) noexcept {return {vld1q_f32(p)};}
+inline void store(float *p, float4 a) noexcept {vst1q_f32(p, a.v);}
+inline void storeu(float *p, float4 a) noexcept {vst1q_f32(p, a.v);}
+inline float4 set(float x, float y, float z, float w) noexcept {
+    const float t[4] = {x, y, z, w};
+    return {vld1q_f32(t)};
+}
+inline float4 splat(float x) noexcept {return {vdupq_n_f32(x)};}
+inline float4 zero() noexcept {return {vdupq_n_f32(0.0f)};}
+inline float4 add(float4 a, float4 b) noexcept {return {vaddq_f32(a.v, b.v)};}
+inline float4 sub(float4 a, float4 b) noexcept {return {vsubq_f32(a.v, b.v)};}
+inline float4 mul(float4 a, float4 b) noexcept {return {vmulq_f32(a.v, b.v)};}
+#if defined(__aarch64__)
+inline float4 div(float4 a, float4 b) noexcept {return {vdivq_f32(a.v, b.v)};}
+inline float4 sqrt(float4 a) noexcept {return {vsqrtq_f32(a.v)};}
+#else
+inline float4 div(float4 a, float4 b) noexcept {
+    float x[4], y[4];
+    vst1q_f32(x, a.v);
+    vst1q_f32(y, b.v);
+    return set(x[0] / y[0], x[1] / y[1], x[2] / y[2], x[3] / y[3]);
+}
+inline float4 sqrt(float4 a) noexcept {
+    float x[4];
+    vst1q_f32(x, a.v);
+    return set(std::sqrt(x[0]), std::sqrt(x[1]), std::sqrt(x[2]), std::sqrt(x[3]));
+}
+#endif
+inline float4 min(float4 a, float4 b) noexcept {return {vminq_f32(a.v, b.v)};}
+inline float4 max(float4 a, float4 b) noexcept {return {vmaxq_f32(a.v, b.v)};}
+inline float4 abs(float4 a) noexcept {return {vabsq_f32(a.v)};}
+inline float4 copysign(float4 a, float4 b) noexcept {return {vbslq_f32(vdupq_n_u32(0x80000000u), b.v, a.v)};}
+inline mask4 less(float4 a, float4 b) noexcept {return {vcltq_f32(a.v, b.v)};}
+inline float4 select(mask4 m, float4 a, float4 b) noexcept {return {vbslq_f32(m.v, a.v, b.v)};}
+inline float4 exp2i(float4 k) noexcept {
+    return {vreinterpretq_f32_s32(vshlq_n_s32(vaddq_s32(vcvtq_s32_f32(k.v), vdupq_n_s32(127)), 23))};
+}
+
+#if defined(__aarch64__)
+inline float4 sub_cvt(const double *a, const double *b) noexcept {
+    const float32x2_t lo = vcvt_f32_f64(vsubq_f64(vld1q_f64(a), vld1q_f64(b)));
+    const float32x2_t hi = vcvt_f32_f64(vsubq_f64(vld1q_f64(a + 2), vld1q_f64(b + 2)));
+    return {vcombine_f32(lo, hi)};
+}
+#else
+inline float4 sub_cvt(const double *a, const double *b) noexcept {
+    return set(static_cast<float>(a[0] - b[0]), static_cast<float>(a[1] - b[1]),
+               static_cast<float>(a[2] - b[2]), static_cast<float>(a[3] - b[3]));
+}
+#endif
+
+template <int I>
+inline float4 broadcast(float4 a) noexcept {return {vdupq_n_f32(vgetq_lane_f32(a.v, I))};}
+
+template <int X, int Y, int Z, int W>
+inline float4 shuffle(float4 a, float4 b) noexcept {
+    return set(vgetq_lane_f32(a.v, X), vgetq_lane_f32(a.v, Y), vgetq_lane_f32(b.v, Z), vgetq_lane_f32(b.v, W));
+}
+
+inline void transpose(float4 &a, float4 &b, float4 &c, float4 &d) noexcept {
+    float32x4x2_t ab = vtrnq_f32(a.v, b.v);
+    float32x4x2_t cd = vtrnq_f32(c.v, d.v);
+    a.v = vcombine_f32(vget_low_f32(ab.val[0]), vget_low_f32(cd.val[0]));
+    b.v = vcombine_f32(vget_low_f32(ab.val[1]), vget_low_f32(cd.val[1]));
+    c.v = vcombine_f32(vget_high_f32(ab.val[0]), vget_high_f32(cd.val[0]));
+    d.v = vcombine_f32(vget_high_f32(ab.val[1]), vget_high_f32(cd.val[1]));
+}
+
+#else
+
+struct float4 {
+    float v[4];
+};
+
+struct mask4 {
+    bool v[4];
+};
+
+inline float4 load(const float *p) noexcept {return {{p[0], p[1], p[2], p[3]}};}
+inline float4 loadu(const float *p) noexcept {return load(p);}
+inline void store(float *p, float4 a) noexcept {
+    p[0] = a.v[0];
+    p[1] = a.v[1];
+    p[2] = a.v[2];
+    p[3] = a.v[3];
+}
+inline void storeu(float *p, float4 a) noexcept {store(p, a);}
+inline float4 set(float x, float y, float z, float w) noexcept {return {{x, y, z, w}};}
+inline float4 splat(float x) noexcept {return {{x, x, x, x}};}
+inline float4 zero() noexcept {return {{0.0f, 0.0f, 0.0f, 0.0f}};}
+inline float4 add(float4 a, float4 b) noexcept {return {{a.v[0] + b.v[0], a.v[1] + b.v[1], a.v[2] + b.v[2], a.v[3] + b.v[3]}};}
+inline float4 sub(float4 a, float4 b) noexcept {return {{a.v[0] - b.v[0], a.v[1] - b.v[1], a.v[2] - b.v[2], a.v[3] - b.v[3]}};}
+inline float4 mul(float4 a, float4 b) noexcept {return {{a.v[0] * b.v[0], a.v[1] * b.v[1], a.v[2] * b.v[2], a.v[3] * b.v[3]}};}
+inline float4 div(float4 a, float4 b) noexcept {return {{a.v[0] / b.v[0], a.v[1] / b.v[1], a.v[2] / b.v[2], a.v[3] / b.v[3]}};}
+inline float4 min(float4 a, float4 b) noexcept {
+    return {{b.v[0] < a.v[0] ? b.v[0] : a.v[0], b.v[1] < a.v[1] ? b.v[1] : a.v[1],
+             b.v[2] < a.v[2] ? b.v[2] : a.v[2], b.v[3] < a.v[3] ? b.v[3] : a.v[3]}};
+}
+inline float4 max(float4 a, float4 b) noexcept {
+    return {{a.v[0] < b.v[0] ? b.v[0] : a.v[0], a.v[1] < b.v[1] ? b.v[1] : a.v[1],
+             a.v[2] < b.v[2] ? b.v[2] : a.v[2], a.v[3] < b.v[3] ? b.v[3] : a.v[3]}};
+}
+inline float4 sqrt(float4 a) noexcept {
+    return {{std::sqrt(a.v[0]), std::sqrt(a.v[1]), std::sqrt(a.v[2]), std::sqrt(a.v[3])}};
+}
+inline float4 abs(float4 a) noexcept {
+    return {{std::fabs(a.v[0]), std::fabs(a.v[1]), std::fabs(a.v[2]), std::fabs(a.v[3])}};
+}
+inline float4 copysign(float4 a, float4 b) noexcept {
+    return {{std::copysign(a.v[0], b.v[0]), std::copysign(a.v[1], b.v[1]),
+             std::copysign(a.v[2], b.v[2]), std::copysign(a.v[3], b.v[3])}};
+}
+inline mask4 less(float4 a, float4 b) noexcept {return {{a.v[0] < b.v[0], a.v[1] < b.v[1], a.v[2] < b.v[2], a.v[3] < b.v[3]}};}
+inline float4 select(mask4 m, float4 a, float4 b) noexcept {
+    return {{m.v[0] ? a.v[0] : b.v[0], m.v[1] ? a.v[1] : b.v[1], m.v[2] ? a.v[2] : b.v[2], m.v[3] ? a.v[3] : b.v[3]}};
+}
+inline float4 exp2i(float4 k) noexcept {
+    float4 r;
+    for (int i = 0; i < 4; ++i) {
+        const uint32_t b = static_cast<uint32_t>(static_cast<int32_t>(k.v[i]) + 127) << 23;
+        std::memcpy(&r.v[i], &b, sizeof(b));
+    }
+    return r;
+}
+
+inline float4 sub_cvt(const double *a, const double *b) noexcept {
+    return {{static_cast<float>(a[0] - b[0]), static_cast<float>(a[1] - b[1]),
+             static_cast<float>(a[2] - b[2]), static_cast<float>(a[3] - b[3])}};
+}
+
+template <int I>
+inline float4 broadcast(float4 a) noexcept {return splat(a.v[I]);}
+
+template <int X, int Y, int Z, int W>
+inline float4 shuffle(float4 a, float4 b) noexcept {return {{a.v[X], a.v[Y], b.v[Z], b.v[W]}};}
+
+inline void transpose(float4 &a, float4 &b, float4 &c, float4 &d) noexcept {
+    float4 t[4] = {a, b, c, d};
+    a = {{t[0].v[0], t[1].v[0], t[2].v[0], t[3].v[0]}};
+    b = {{t[0].v[1], t[1].v[1], t[2].v[1], t[3].v[1]}};
+    c = {{t[0].v[2], t[1].v[2], t[2].v[2], t[3].v[2]}};
+    d = {{t[0].v[3], t[1].v[3], t[2].v[3], t[3].v[3]}};
+}
+
+#endif
+
+
+/**
+* @brief a * b + c を計算します
+**/
+inline float4 madd(float4 a, float4 b, float4 c) noexcept {return add(mul(a, b), c);}
+
+
+/**
+* @brief 4x4行列の行ベクトルの線形結合 (x * r0 + y * r1 + z * r2 + w * r3) を計算します
+**/
+inline float4 combine(float4 v, float4 r0, float4 r1, float4 r2, float4 r3) noexcept {
+    float4 a = mul(broadcast<0>(v), r0);
+    a = madd(broadcast<1>(v), r1, a);
+    a = madd(broadcast<2>(v), r2, a);
+    return madd(broadcast<3>(v), r3, a);
+}
+
+} // namespace simd
+} // namespace gdv
+
+#endif
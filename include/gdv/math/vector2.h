@@ -26,7 +26,7 @@ public:
 
 
 
-    vector2<Ty>& operator = (const vector2<Ty> &v) noexcept {
+    constexpr vector2<Ty>& operator = (const vector2<Ty> &v) noexcept {
         x = v.x;
         y = v.y;
         return *this;
@@ -42,84 +42,84 @@ public:
 
 
 template<class Ty>
-bool operator == (vector2<Ty> v1, vector2<Ty> v2) noexcept {
+constexpr bool operator == (vector2<Ty> v1, vector2<Ty> v2) noexcept {
     return v1.x == v2.x && v1.y == v2.y;
 }
 
 template<class Ty>
-bool operator != (vector2<Ty> v1, vector2<Ty> v2) noexcept {
+constexpr bool operator != (vector2<Ty> v1, vector2<Ty> v2) noexcept {
     return v1.x != v2.x || v1.y != v2.y;
 }
 
 template<class Ty>
-vector2<Ty>& operator += (vector2<Ty> &v1, vector2<Ty> v2) noexcept {
+constexpr vector2<Ty>& operator += (vector2<Ty> &v1, vector2<Ty> v2) noexcept {
     v1.x += v2.x;
     v1.y += v2.y;
     return v1;
 }
 
 template<class Ty>
-vector2<Ty>& operator += (vector2<Ty> &v, Ty val) noexcept {
+constexpr vector2<Ty>& operator += (vector2<Ty> &v, Ty val) noexcept {
     v.x += val;
     v.y += val;
     return v;
 }
 
 template<class Ty>
-vector2<Ty>& operator -= (vector2<Ty> &v1, vector2<Ty> v2) noexcept {
+constexpr vector2<Ty>& operator -= (vector2<Ty> &v1, vector2<Ty> v2) noexcept {
     v1.x -= v2.x;
     v1.y -= v2.y;
     return v1;
 }
 
 template<class Ty>
-vector2<Ty>& operator *= (vector2<Ty> &v, Ty val) noexcept {
+constexpr vector2<Ty>& operator *= (vector2<Ty> &v, Ty val) noexcept {
     v.x *= val;
     v.y *= val;
     return v;
 }
 
 template<class Ty>
-vector2<Ty>& operator /= (vector2<Ty> &v, Ty val) noexcept {
+constexpr vector2<Ty>& operator /= (vector2<Ty> &v, Ty val) noexcept {
     v.x /= val;
     v.y /= val;
     return v;
 }
 
 template<class Ty>
-vector2<Ty>& operator -= (vector2<Ty> &v, Ty val) noexcept {
+constexpr vector2<Ty>& operator -= (vector2<Ty> &v, Ty val) noexcept {
     v.x -= val;
     v.y -= val;
     return v;
 }
 
 template<class Ty>
-vector2<Ty> operator + (vector2<Ty> v1, vector2<Ty> v2) noexcept {
+constexpr vector2<Ty> operator + (vector2<Ty> v1, vector2<Ty> v2) noexcept {
     return {v1.x + v2.x, v1.y + v2.y};
 }
 
 template<class Ty>
-vector2<Ty> operator + (vector2<Ty> v, Ty val) noexcept {
+constexpr vector2<Ty> operator + (vector2<Ty> v, Ty val) noexcept {
     return {v.x + val, v.y + val};
 }
 
 template<class Ty>
-vector2<Ty> operator - (vector2<Ty> v1, vector2<Ty> v2) noexcept {
+constexpr vector2<Ty> operator - (vector2<Ty> v1, vector2<Ty> v2) noexcept {
     return {v1.x - v2.x, v1.y - v2.y};
 }
 
 template<class Ty>
-vector2<Ty> operator - (vector2<Ty> v, Ty val) noexcept {
+constexpr vector2<Ty> operator - (vector2<Ty> v, Ty val) noexcept {
     return {v.x - val, v.y - val};
 }
 
 template<class Ty>
-vector2<Ty> operator * (vector2<Ty> v, Ty val) noexcept {
+constexpr vector2<Ty> operator * (vector2<Ty> v, Ty val) noexcept {
     return {v.x * val, v.y * val};
 }
 
 template<class Ty>
-vector2<Ty> operator / (vector2<Ty> v, Ty val) noexcept {
+constexpr vector2<Ty> operator / (vector2<Ty> v, Ty val) noexcept {
     return {v.x / val, v.y / val};
 }
 
@@ -128,14 +128,14 @@ vector2<Ty> operator / (vector2<Ty> v, Ty val) noexcept {
 
 
 template<class Ty>
-Ty dot(vector2<Ty> v1, vector2<Ty> v2) noexcept {
+constexpr Ty dot(vector2<Ty> v1, vector2<Ty> v2) noexcept {
     static_assert(std::is_floating_point<Ty>::value, "Template parameters require floating point type.");
     return v1.x * v2.x + v1.y * v2.y;
 }
 
 
 template<class Ty>
-Ty cross(vector2<Ty> v1, vector2<Ty> v2) noexcept {
+constexpr Ty cross(vector2<Ty> v1, vector2<Ty> v2) noexcept {
     static_assert(std::is_floating_point<Ty>::value, "Template parameters require floating point type.");
     return v1.x * v2.y - v1.y * v2.x;
 }
@@ -32,7 +32,7 @@ public:
 
 
 
-    vector3<Ty>& operator = (const vector3<Ty> &v) noexcept {
+    constexpr vector3<Ty>& operator = (const vector3<Ty> &v) noexcept {
         x = v.x;
         y = v.y;
         z = v.z;
@@ -52,17 +52,17 @@ public:
 
 
 template<class Ty>
-bool operator == (vector3<Ty> v1, vector3<Ty> v2) noexcept {
+constexpr bool operator == (vector3<Ty> v1, vector3<Ty> v2) noexcept {
     return v1.x == v2.x && v1.y == v2.y && v1.z == v2.z;
 }
 
 template<class Ty>
-bool operator != (vector3<Ty> v1, vector3<Ty> v2) noexcept {
+constexpr bool operator != (vector3<Ty> v1, vector3<Ty> v2) noexcept {
     return v1.x != v2.x || v1.y != v2.y || v1.z != v2.z;
 }
 
 template<class Ty>
-vector3<Ty>& operator += (vector3<Ty> &v1, vector3<Ty> v2) noexcept {
+constexpr vector3<Ty>& operator += (vector3<Ty> &v1, vector3<Ty> v2) noexcept {
     v1.x += v2.x;
     v1.y += v2.y;
     v1.z += v2.z;
@@ -70,7 +70,7 @@ vector3<Ty>& operator += (vector3<Ty> &v1, vector3<Ty> v2) noexcept {
 }
 
 template<class Ty>
-vector3<Ty>& operator += (vector3<Ty> &pt, Ty val) noexcept {
+constexpr vector3<Ty>& operator += (vector3<Ty> &pt, Ty val) noexcept {
     pt.x += val;
     pt.y += val;
     pt.z += val;
@@ -78,7 +78,7 @@ vector3<Ty>& operator += (vector3<Ty> &pt, Ty val) noexcept {
 }
 
 template<class Ty>
-vector3<Ty>& operator -= (vector3<Ty> &v1, vector3<Ty> v2) noexcept {
+constexpr vector3<Ty>& operator -= (vector3<Ty> &v1, vector3<Ty> v2) noexcept {
     v1.x -= v2.x;
     v1.y -= v2.y;
     v1.z -= v2.z;
@@ -86,7 +86,7 @@ vector3<Ty>& operator -= (vector3<Ty> &v1, vector3<Ty> v2) noexcept {
 }
 
 template<class Ty>
-vector3<Ty>& operator -= (vector3<Ty> &pt, Ty val) noexcept {
+constexpr vector3<Ty>& operator -= (vector3<Ty> &pt, Ty val) noexcept {
     pt.x -= val;
     pt.y -= val;
     pt.z -= val;
@@ -94,7 +94,7 @@ vector3<Ty>& operator -= (vector3<Ty> &pt, Ty val) noexcept {
 }
 
 template<class Ty>
-vector3<Ty>& operator *= (vector3<Ty> &pt, Ty val) noexcept {
+constexpr vector3<Ty>& operator *= (vector3<Ty> &pt, Ty val) noexcept {
     pt.x *= val;
     pt.y *= val;
     pt.z *= val;
@@ -102,7 +102,7 @@ vector3<Ty>& operator *= (vector3<Ty> &pt, Ty val) noexcept {
 }
 
 template<class Ty>
-vector3<Ty>& operator /= (vector3<Ty> &pt, Ty val) noexcept {
+constexpr vector3<Ty>& operator /= (vector3<Ty> &pt, Ty val) noexcept {
     pt.x /= val;
     pt.y /= val;
     pt.z /= val;
@@ -110,31 +110,31 @@ vector3<Ty>& operator /= (vector3<Ty> &pt, Ty val) noexcept {
 }
 
 template<class Ty>
-vector3<Ty> operator + (vector3<Ty> v1, vector3<Ty> v2) noexcept {
+constexpr vector3<Ty> operator + (vector3<Ty> v1, vector3<Ty> v2) noexcept {
     return {v1.x + v2.x, v1.y + v2.y, v1.z + v2.z};
 }
 
 template<class Ty>
-vector3<Ty> operator + (vector3<Ty> pt, Ty val) noexcept {
+constexpr vector3<Ty> operator + (vector3<Ty> pt, Ty val) noexcept {
     return {pt.x + val, pt.y + val, pt.z + val};
 }
 
 template<class Ty>
-vector3<Ty> operator - (vector3<Ty> v1, vector3<Ty> v2) noexcept {
+constexpr vector3<Ty> operator - (vector3<Ty> v1, vector3<Ty> v2) noexcept {
     return {v1.x - v2.x, v1.y - v2.y, v1.z - v2.z};
 }
 
 template<class Ty>
-vector3<Ty> operator - (vector3<Ty> pt, Ty val) noexcept {
+constexpr vector3<Ty> operator - (vector3<Ty> pt, Ty val) noexcept {
     return {pt.x - val, pt.y - val, pt.z - val};
 }
 
 template<class Ty>
-vector3<Ty> operator * (vector3<Ty> pt, Ty val) noexcept {
+constexpr vector3<Ty> operator * (vector3<Ty> pt, Ty val) noexcept {
     return {pt.x * val, pt.y * val, pt.z * val};
 }
 template<class Ty>
-vector3<Ty> operator / (vector3<Ty> pt, Ty val) noexcept {
+constexpr vector3<Ty> operator / (vector3<Ty> pt, Ty val) noexcept {
     return {pt.x / val, pt.y / val, pt.z / val};
 }
 
@@ -142,14 +142,14 @@ vector3<Ty> operator / (vector3<Ty> pt, Ty val) noexcept {
 
 
 template<class Ty>
-Ty dot(vector3<Ty> v1, vector3<Ty> v2) noexcept {
+constexpr Ty dot(vector3<Ty> v1, vector3<Ty> v2) noexcept {
     static_assert(std::is_floating_point<Ty>::value, "Template parameters require floating point type.");
     return v1.x * v2.x + v1.y * v2.y + v1.z * v2.z;
 }
 
 
 template<class Ty>
-vector3<Ty> cross(vector3<Ty> v1, vector3<Ty> v2) noexcept {
+constexpr vector3<Ty> cross(vector3<Ty> v1, vector3<Ty> v2) noexcept {
     static_assert(std::is_floating_point<Ty>::value, "Template parameters require floating point type.");
     return {v1.y * v2.z - v1.z * v2.y, v1.z * v2.x - v1.x * v2.z, v1.x * v2.y - v1.y * v2.x};
 }
@@ -1,13 +1,22 @@
 #ifndef GDV_VECTOR4_H_
 #define GDV_VECTOR4_H_
 
+#include <cstddef>
 #include <type_traits>
 #include <gdv/math/vector3.h>
 
 namespace gdv {
 
+/**
+* @brief vector4とmatrix4x4のアライメント
+* @details floatはSIMDレジスタに直接ロードできるよう16バイト境界に揃えます
+**/
 template <class Ty>
-class alignas(alignof(Ty)) vector4 {
+constexpr size_t simd_alignment = std::is_same<Ty, float>::value ? 16 : alignof(Ty);
+
+
+template <class Ty>
+class alignas(simd_alignment<Ty>) vector4 {
     static_assert(std::is_integral<Ty>::value || std::is_floating_point<Ty>::value, "invalid template parameter.");
 
 public:
@@ -35,7 +44,7 @@ public:
 
 
 
-    vector4<Ty>& operator = (const vector4<Ty> &v) noexcept {
+    constexpr vector4<Ty>& operator = (const vector4<Ty> &v) noexcept {
         x = v.x;
         y = v.y;
         z = v.z;
@@ -44,7 +53,7 @@ public:
     }
 
 
-    vector4<Ty>& operator = (const vector3<Ty> &v) noexcept {
+    constexpr vector4<Ty>& operator = (const vector3<Ty> &v) noexcept {
         x = v.x;
         y = v.y;
         z = v.z;
@@ -8,6 +8,7 @@
 #include <type_traits>
 #include <gdv/math/matrix4x4.h>
 #include <gdv/math/vector2.h>
+#include <gdv/math/rect.h>
 
 namespace gdv {
 
@@ -27,7 +28,7 @@ public:
     * @return none
     * @exception none
     **/
-    viewport() noexcept :
+    constexpr viewport() noexcept :
         x{}, y{}, w{}, h{} {}
 
 
@@ -41,7 +42,7 @@ public:
     * @return none
     * @exception none
     **/
-    viewport(Ty x, Ty y, Ty w, Ty h) noexcept :
+    constexpr viewport(Ty x, Ty y, Ty w, Ty h) noexcept :
         x{x}, y{y}, w{w}, h{h} {}
 
 
@@ -53,7 +54,7 @@ public:
     * @return none
     * @exception none
     **/
-    viewport(vector2<Ty> pt, Ty w, Ty h) noexcept :
+    constexpr viewport(vector2<Ty> pt, Ty w, Ty h) noexcept :
         x{pt.x}, y{pt.y}, w{w}, h{h} {}
 
 
@@ -63,11 +64,11 @@ public:
     * @return none
     * @exception none
     **/
-    viewport(rect<Ty> r) noexcept :
-        x{r.left + r.Width() / static_cast<Ty>(2)},
-        y{r.bottom + r.Height() / static_cast<Ty>(2)},
-        x{r.Width()},
-        x{r.Height()} {}
+    constexpr viewport(rect<Ty> r) noexcept :
+        x{r.left + r.width() / static_cast<Ty>(2)},
+        y{r.top + r.height() / static_cast<Ty>(2)},
+        w{r.width()},
+        h{r.height()} {}
     
 
 
@@ -77,7 +78,7 @@ public:
     * @return none
     * @exception none
     **/
-    viewport(const viewport<Ty> &v) noexcept :
+    constexpr viewport(const viewport<Ty> &v) noexcept :
         x{v.x}, y{v.y}, w{v.w}, h{v.h} {} 
 
 
@@ -88,7 +89,7 @@ public:
     * @return 自身の参照
     * @exception none
     **/
-    viewport<Ty> operator = (const viewport<Ty> &v) noexcept {
+    constexpr viewport<Ty> operator = (const viewport<Ty> &v) noexcept {
         x = v.x;
         y = v.y;
         w = v.w;
@@ -104,28 +105,28 @@ public:
     * @return ビューポートの左端
     * @exception none
     **/
-    Ty left()    const noexcept {return x - w / static_cast<Ty>(2);}
+    constexpr Ty left()    const noexcept {return x - w / static_cast<Ty>(2);}
 
     /**
     * @brief ビューポートの右端を取得します
     * @return ビューポートの端
     * @exception none
     **/
-    Ty right()   const noexcept {return x + w / static_cast<Ty>(2);}
+    constexpr Ty right()   const noexcept {return x + w / static_cast<Ty>(2);}
 
     /**
     * @brief ビューポートの下端を取得します
     * @return ビューポートの下端
     * @exception none
     **/
-    Ty bottom()  const noexcept {return y - h / static_cast<Ty>(2);}
+    constexpr Ty bottom()  const noexcept {return y - h / static_cast<Ty>(2);}
 
     /**
     * @brief ビューポートの上端を取得します
     * @return ビューポートの上端
     * @exception none
     **/
-    Ty top()     const noexcept {return y + h / static_cast<Ty>(2);}
+    constexpr Ty top()     const noexcept {return y + h / static_cast<Ty>(2);}
 
 
 
@@ -140,10 +141,10 @@ public:
 namespace column_major {
 
 template <class Ty>
-matrix4x4<Ty> to_matrix(viewport<Ty> v) {
-    static constexpr Ty _0 = static_cast<Ty>(0);
-    static constexpr Ty _1 = static_cast<Ty>(1);
-    static constexpr Ty _2 = static_cast<Ty>(2);
+constexpr matrix4x4<Ty> to_matrix(viewport<Ty> v) noexcept {
+    constexpr Ty _0 = static_cast<Ty>(0);
+    constexpr Ty _1 = static_cast<Ty>(1);
+    constexpr Ty _2 = static_cast<Ty>(2);
     return {
         v.w / _2, _0, _0, v.x + v.w / _2,
         _0, v.h / _2, _0, v.y + v.h / _2,
@@ -158,10 +159,10 @@ matrix4x4<Ty> to_matrix(viewport<Ty> v) {
 namespace row_major {
 
 template <class Ty>
-matrix4x4<Ty> to_matrix(viewport<Ty> v) {
-    static constexpr Ty _0 = static_cast<Ty>(0);
-    static constexpr Ty _1 = static_cast<Ty>(1);
-    static constexpr Ty _2 = static_cast<Ty>(2);
+constexpr matrix4x4<Ty> to_matrix(viewport<Ty> v) noexcept {
+    constexpr Ty _0 = static_cast<Ty>(0);
+    constexpr Ty _1 = static_cast<Ty>(1);
+    constexpr Ty _2 = static_cast<Ty>(2);
     return {
         v.w / _2, _0, _0, _0,
         _0, v.h / _2, _0, _0,
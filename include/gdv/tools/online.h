@@ -1,12 +1,88 @@
 #ifndef GDV_ONLINE_H_
 #define GDV_ONLINE_H_
 
+#include <algorithm>
 #include <type_traits>
+#include <utility>
 #include <cmath>
 
 namespace gdv {
 namespace online {
 
+namespace detail {
+
+// 独立したレーンに分けてループ間の依存をなくし、ベクトル化できるようにします
+constexpr size_t lanes = 8;
+
+// 一括入力はブロックごとに集計してから結合し、ブロック内の和の丸め誤差を抑えます
+constexpr size_t block = 4096;
+
+
+template <class Ty>
+Ty reduce_sum(const Ty *x, size_t n) noexcept {
+    Ty acc[lanes] = {};
+    size_t i = 0;
+    for (; i + lanes <= n; i += lanes) {
+        for (size_t j = 0; j < lanes; ++j) { acc[j] += x[i + j]; }
+    }
+    for (; i < n; ++i) { acc[0] += x[i]; }
+    Ty sum{};
+    for (size_t j = 0; j < lanes; ++j) { sum += acc[j]; }
+    return sum;
+}
+
+
+template <class Ty>
+Ty reduce_squared_deviation(const Ty *x, size_t n, Ty mean) noexcept {
+    Ty acc[lanes] = {};
+    size_t i = 0;
+    for (; i + lanes <= n; i += lanes) {
+        for (size_t j = 0; j < lanes; ++j) {
+            Ty d = x[i + j] - mean;
+            acc[j] += d * d;
+        }
+    }
+    for (; i < n; ++i) {
+        Ty d = x[i] - mean;
+        acc[0] += d * d;
+    }
+    Ty sum{};
+    for (size_t j = 0; j < lanes; ++j) { sum += acc[j]; }
+    return sum;
+}
+
+
+template <class Ty>
+Ty reduce_max(const Ty *x, size_t n, Ty init) noexcept {
+    Ty acc[lanes];
+    for (size_t j = 0; j < lanes; ++j) { acc[j] = init; }
+    size_t i = 0;
+    for (; i + lanes <= n; i += lanes) {
+        for (size_t j = 0; j < lanes; ++j) { acc[j] = acc[j] < x[i + j] ? x[i + j] : acc[j]; }
+    }
+    for (; i < n; ++i) { acc[0] = acc[0] < x[i] ? x[i] : acc[0]; }
+    for (size_t j = 1; j < lanes; ++j) { acc[0] = acc[0] < acc[j] ? acc[j] : acc[0]; }
+    return acc[0];
+}
+
+
+template <class Ty>
+Ty reduce_min(const Ty *x, size_t n, Ty init) noexcept {
+    Ty acc[lanes];
+    for (size_t j = 0; j < lanes; ++j) { acc[j] = init; }
+    size_t i = 0;
+    for (; i + lanes <= n; i += lanes) {
+        for (size_t j = 0; j < lanes; ++j) { acc[j] = x[i + j] < acc[j] ? x[i + j] : acc[j]; }
+    }
+    for (; i < n; ++i) { acc[0] = x[i] < acc[0] ? x[i] : acc[0]; }
+    for (size_t j = 1; j < lanes; ++j) { acc[0] = acc[j] < acc[0] ? acc[j] : acc[0]; }
+    return acc[0];
+}
+
+} // namespace detail
+
+
+
 template <class Ty>
 class max {
 public:
@@ -19,8 +95,9 @@ public:
     max(const max &m) noexcept :
         max_{m.max_} {}
 
-    max<Ty> operator = (const max &m) noexcept {
+    max<Ty>& operator = (const max &m) noexcept {
         max_ = m.max_;
+        return *this;
     }
 
 public:
@@ -34,6 +111,11 @@ public:
         return max_;
     }
 
+    Ty add(const Ty *x, size_t n) noexcept {
+        max_ = detail::reduce_max(x, n, max_);
+        return max_;
+    }
+
     Ty value() const noexcept {return max_;}
 
     void clear() noexcept {
@@ -64,8 +146,9 @@ public:
     min(const min &m) noexcept :
         min_{m.min_} {}
 
-    min<Ty> operator = (const min &m) noexcept {
+    min<Ty>& operator = (const min &m) noexcept {
         min_ = m.min_;
+        return *this;
     }
 
 public:
@@ -79,6 +162,11 @@ public:
         return min_;
     }
 
+    Ty add(const Ty *x, size_t n) noexcept {
+        min_ = detail::reduce_min(x, n, min_);
+        return min_;
+    }
+
     Ty value() const noexcept {return min_;}
 
     void clear() noexcept {
@@ -114,6 +202,11 @@ public:
         count_{} {}
 
 
+    average(Ty avrg, size_t count) noexcept : 
+        average_{avrg},
+        count_{count} {}
+
+
     average(const average &avrg) noexcept : 
         average_{avrg.average_},
         count_{avrg.count_} {}
@@ -122,6 +215,7 @@ public:
     average<Ty>& operator = (const average &avrg) noexcept {
         average_ = avrg.average_;
         count_ = avrg.count_;
+        return *this;
     }
 
 
@@ -139,6 +233,15 @@ public:
     }
 
 
+    Ty add(const Ty *x, size_t n) noexcept {
+        for (size_t i = 0; i < n; i += detail::block) {
+            size_t m = std::min(detail::block, n - i);
+            add(average{detail::reduce_sum(x + i, m) / static_cast<Ty>(m), m});
+        }
+        return average_;
+    }
+
+
     Ty value() const noexcept {return average_;}
 
 
@@ -168,36 +271,416 @@ class dispersion {
 
 public:
     dispersion() noexcept :
-        dispersion_{},
+        m2_{},
         average_{},
         count_{} {}
 
 
+    dispersion(Ty disp, Ty avrg, size_t count) noexcept :
+        m2_{disp * static_cast<Ty>(count)},
+        average_{avrg},
+        count_{count} {}
+
+
     dispersion(const dispersion& x) noexcept :
-        dispersion_{x.dispersion_},
+        m2_{x.m2_},
         average_{x.average_},
         count_{x.count_} {}
 
 
+    dispersion<Ty>& operator = (const dispersion &x) noexcept {
+        m2_ = x.m2_;
+        average_ = x.average_;
+        count_ = x.count_;
+        return *this;
+    }
+
+
 public:
+    // Welfordの逐次更新
     Ty add(Ty x) noexcept {
-        Ty average_old = std::pow(average_, 2);
-        average_ += (x - average_) / static_cast<Ty>(count_ + 1);
-        Ty average_new = std::pow(average_, 2);
-        dispersion_ += ((static_cast<Ty>(count_) * average_old - dispersion_ + std::pow(x, 2)) / static_cast<Ty>(count_ + 1)) - average_new;
-        ++count_;
-        return dispersion_;
+        Ty delta = x - average_;
+        average_ += delta / static_cast<Ty>(++count_);
+        m2_ += delta * (x - average_);
+        return value();
     }
 
 
-
+    // Chanらの結合式
     Ty add(dispersion x) noexcept {
-        Ty average_me = std::pow(average_, 2);
-        Ty average_dst = std::pow(x.average_, 2);
-        average_ += (x.average_ - average_) * static_cast<Ty>(x.count_) / static_cast<Ty>(count_ + x.count_);
-        dispersion_ += (static_cast<Ty>(count_) * average_me + static_cast<Ty>(x.count_) * (x.dispersion_ - dispersion_ + average_dst)) / static_cast<Ty>(count_ + x.count_) - std::pow(average_, 2);
+        if (x.count_ == 0) { return value(); }
+        Ty na = static_cast<Ty>(count_);
+        Ty nb = static_cast<Ty>(x.count_);
+        Ty n = na + nb;
+        Ty delta = x.average_ - average_;
+        average_ += delta * nb / n;
+        m2_ += x.m2_ + delta * delta * na * nb / n;
         count_ += x.count_;
-        return dispersion_;
+        return value();
+    }
+
+
+    // ブロックごとに2パスで計算し、上の結合式で結合します
+    Ty add(const Ty *x, size_t n) noexcept {
+        for (size_t i = 0; i < n; i += detail::block) {
+            size_t m = std::min(detail::block, n - i);
+            Ty mean = detail::reduce_sum(x + i, m) / static_cast<Ty>(m);
+            Ty m2 = detail::reduce_squared_deviation(x + i, m, mean);
+            add(dispersion{m2 / static_cast<Ty>(m), mean, m});
+        }
+        return value();
+    }
+
+
+    Ty value() const noexcept {
+        return count_ ? m2_ / static_cast<Ty>(count_) : static_cast<Ty>(0);
+    }
+
+
+    Ty unbiased() const noexcept {
+        return count_ > 1 ? m2_ / static_cast<Ty>(count_ - 1) : static_cast<Ty>(0);
+    }
+
+
+    Ty average() const noexcept {return average_;}
+
+
+    size_t size() const noexcept {return count_;}
+
+
+    void clear() noexcept {
+        count_ = 0;
+        average_ = static_cast<Ty>(0);
+        m2_ = static_cast<Ty>(0);
+    }
+
+    operator Ty() noexcept {return value();}
+
+private:
+    Ty      m2_;
+    Ty      average_;
+    size_t  count_;
+};
+
+
+
+
+/**
+* @class moments
+* @brief 平均、分散、歪度、尖度 (超過) を1パスで計算します (Welford/Pebay)
+**/
+template <class Ty>
+class moments {
+    static_assert(std::is_floating_point<Ty>::value, "template parameter Ty must be floating point.");
+
+public:
+    moments() noexcept :
+        m2_{},
+        m3_{},
+        m4_{},
+        average_{},
+        count_{} {}
+
+
+public:
+    Ty add(Ty x) noexcept {
+        Ty n1 = static_cast<Ty>(count_);
+        Ty n = static_cast<Ty>(++count_);
+        Ty delta = x - average_;
+        Ty delta_n = delta / n;
+        Ty delta_n2 = delta_n * delta_n;
+        Ty term = delta * delta_n * n1;
+        average_ += delta_n;
+        m4_ += term * delta_n2 * (n * n - static_cast<Ty>(3) * n + static_cast<Ty>(3))
+             + static_cast<Ty>(6) * delta_n2 * m2_
+             - static_cast<Ty>(4) * delta_n * m3_;
+        m3_ += term * delta_n * (n - static_cast<Ty>(2)) - static_cast<Ty>(3) * delta_n * m2_;
+        m2_ += term;
+        return average_;
+    }
+
+
+    Ty add(moments x) noexcept {
+        if (x.count_ == 0) { return average_; }
+        Ty na = static_cast<Ty>(count_);
+        Ty nb = static_cast<Ty>(x.count_);
+        Ty n = na + nb;
+        Ty delta = x.average_ - average_;
+        Ty delta2 = delta * delta;
+        Ty m2 = m2_ + x.m2_ + delta2 * na * nb / n;
+        Ty m3 = m3_ + x.m3_
+              + delta2 * delta * na * nb * (na - nb) / (n * n)
+              + static_cast<Ty>(3) * delta * (na * x.m2_ - nb * m2_) / n;
+        Ty m4 = m4_ + x.m4_
+              + delta2 * delta2 * na * nb * (na * na - na * nb + nb * nb) / (n * n * n)
+              + static_cast<Ty>(6) * delta2 * (na * na * x.m2_ + nb * nb * m2_) / (n * n)
+              + static_cast<Ty>(4) * delta * (na * x.m3_ - nb * m3_) / n;
+        average_ += delta * nb / n;
+        m2_ = m2;
+        m3_ = m3;
+        m4_ = m4;
+        count_ += x.count_;
+        return average_;
+    }
+
+
+    Ty value() const noexcept {return average_;}
+
+
+    Ty average() const noexcept {return average_;}
+
+
+    Ty variance() const noexcept {
+        return count_ ? m2_ / static_cast<Ty>(count_) : static_cast<Ty>(0);
+    }
+
+
+    Ty skewness() const noexcept {
+        if (m2_ == static_cast<Ty>(0)) { return static_cast<Ty>(0); }
+        return std::sqrt(static_cast<Ty>(count_)) * m3_ / (m2_ * std::sqrt(m2_));
+    }
+
+
+    Ty kurtosis() const noexcept {
+        if (m2_ == static_cast<Ty>(0)) { return static_cast<Ty>(0); }
+        return static_cast<Ty>(count_) * m4_ / (m2_ * m2_) - static_cast<Ty>(3);
+    }
+
+
+    size_t size() const noexcept {return count_;}
+
+
+    void clear() noexcept {
+        count_ = 0;
+        average_ = static_cast<Ty>(0);
+        m2_ = static_cast<Ty>(0);
+        m3_ = static_cast<Ty>(0);
+        m4_ = static_cast<Ty>(0);
+    }
+
+    operator Ty() noexcept {return average_;}
+
+private:
+    Ty      m2_;
+    Ty      m3_;
+    Ty      m4_;
+    Ty      average_;
+    size_t  count_;
+};
+
+
+
+
+/**
+* @class covariance
+* @brief 組で与えられる2系列の共分散と相関係数を計算します
+**/
+template <class Ty>
+class covariance {
+    static_assert(std::is_floating_point<Ty>::value, "template parameter Ty must be floating point.");
+
+public:
+    covariance() noexcept :
+        c_{},
+        m2x_{},
+        m2y_{},
+        average_x_{},
+        average_y_{},
+        count_{} {}
+
+
+public:
+    Ty add(Ty x, Ty y) noexcept {
+        Ty n = static_cast<Ty>(++count_);
+        Ty dx = x - average_x_;
+        Ty dy = y - average_y_;
+        average_x_ += dx / n;
+        average_y_ += dy / n;
+        Ty ey = y - average_y_;
+        c_ += dx * ey;
+        m2x_ += dx * (x - average_x_);
+        m2y_ += dy * ey;
+        return value();
+    }
+
+
+    Ty add(std::pair<Ty, Ty> xy) noexcept {
+        return add(xy.first, xy.second);
+    }
+
+
+    Ty add(covariance x) noexcept {
+        if (x.count_ == 0) { return value(); }
+        Ty na = static_cast<Ty>(count_);
+        Ty nb = static_cast<Ty>(x.count_);
+        Ty n = na + nb;
+        Ty dx = x.average_x_ - average_x_;
+        Ty dy = x.average_y_ - average_y_;
+        Ty w = na * nb / n;
+        c_ += x.c_ + dx * dy * w;
+        m2x_ += x.m2x_ + dx * dx * w;
+        m2y_ += x.m2y_ + dy * dy * w;
+        average_x_ += dx * nb / n;
+        average_y_ += dy * nb / n;
+        count_ += x.count_;
+        return value();
+    }
+
+
+    Ty value() const noexcept {
+        return count_ ? c_ / static_cast<Ty>(count_) : static_cast<Ty>(0);
+    }
+
+
+    Ty correlation() const noexcept {
+        Ty d = std::sqrt(m2x_ * m2y_);
+        return d == static_cast<Ty>(0) ? static_cast<Ty>(0) : c_ / d;
+    }
+
+
+    Ty average_x() const noexcept {return average_x_;}
+
+
+    Ty average_y() const noexcept {return average_y_;}
+
+
+    size_t size() const noexcept {return count_;}
+
+
+    void clear() noexcept {
+        count_ = 0;
+        average_x_ = static_cast<Ty>(0);
+        average_y_ = static_cast<Ty>(0);
+        c_ = static_cast<Ty>(0);
+        m2x_ = static_cast<Ty>(0);
+        m2y_ = static_cast<Ty>(0);
+    }
+
+    operator Ty() noexcept {return value();}
+
+private:
+    Ty      c_;
+    Ty      m2x_;
+    Ty      m2y_;
+    Ty      average_x_;
+    Ty      average_y_;
+    size_t  count_;
+};
+
+
+
+
+/**
+* @class ew_average
+* @brief 指数加重移動平均です
+* @details tauは時定数です。add(x)は各サンプルを1時間単位として扱い、
+*          add(x, time)は経過時間に応じて減衰するため、サンプルの間隔は不規則でも構いません
+*          時刻は最初のサンプルで初期化されます。time() 以下の時刻のサンプル (同じ時刻や順序の逆転) は
+*          時刻を進めず、捨てずにadd(x)と同じ1サンプル分の重みで加えます
+**/
+template <class Ty>
+class ew_average {
+    static_assert(std::is_floating_point<Ty>::value, "template parameter Ty must be floating point.");
+
+public:
+    ew_average() noexcept :
+        ew_average(static_cast<Ty>(1)) {}
+
+
+    explicit ew_average(Ty tau) noexcept :
+        average_{},
+        time_{},
+        tau_{tau},
+        alpha_{static_cast<Ty>(1) - std::exp(-static_cast<Ty>(1) / tau)},
+        count_{} {}
+
+
+public:
+    Ty add(Ty x) noexcept {
+        return update(x, count_ ? alpha_ : static_cast<Ty>(1));
+    }
+
+
+    Ty add(Ty x, Ty time) noexcept {
+        Ty alpha = count_ ? weight(time) : static_cast<Ty>(1);
+        time_ = count_ ? std::max(time, time_) : time;
+        return update(x, alpha);
+    }
+
+
+    Ty value() const noexcept {return average_;}
+
+
+    Ty time() const noexcept {return time_;}
+
+
+    size_t size() const noexcept {return count_;}
+
+
+    void clear() noexcept {
+        count_ = 0;
+        average_ = static_cast<Ty>(0);
+        time_ = static_cast<Ty>(0);
+    }
+
+
+    operator Ty() noexcept {return average_;}
+
+private:
+    Ty weight(Ty time) const noexcept {
+        Ty dt = time - time_;
+        return dt > static_cast<Ty>(0) ? static_cast<Ty>(1) - std::exp(-dt / tau_) : alpha_;
+    }
+
+    Ty update(Ty x, Ty alpha) noexcept {
+        average_ += alpha * (x - average_);
+        ++count_;
+        return average_;
+    }
+
+private:
+    Ty      average_;
+    Ty      time_;
+    Ty      tau_;
+    Ty      alpha_;
+    size_t  count_;
+};
+
+
+
+
+/**
+* @class ew_dispersion
+* @brief 指数加重移動分散です (減衰の規則はew_averageと同じです)
+**/
+template <class Ty>
+class ew_dispersion {
+    static_assert(std::is_floating_point<Ty>::value, "template parameter Ty must be floating point.");
+
+public:
+    ew_dispersion() noexcept :
+        ew_dispersion(static_cast<Ty>(1)) {}
+
+
+    explicit ew_dispersion(Ty tau) noexcept :
+        dispersion_{},
+        average_{},
+        time_{},
+        tau_{tau},
+        alpha_{static_cast<Ty>(1) - std::exp(-static_cast<Ty>(1) / tau)},
+        count_{} {}
+
+
+public:
+    Ty add(Ty x) noexcept {
+        return update(x, count_ ? alpha_ : static_cast<Ty>(1));
+    }
+
+
+    Ty add(Ty x, Ty time) noexcept {
+        Ty alpha = count_ ? weight(time) : static_cast<Ty>(1);
+        time_ = count_ ? std::max(time, time_) : time;
+        return update(x, alpha);
     }
 
 
@@ -207,6 +690,9 @@ public:
     Ty average() const noexcept {return average_;}
 
 
+    Ty time() const noexcept {return time_;}
+
+
     size_t size() const noexcept {return count_;}
 
 
@@ -214,13 +700,34 @@ public:
         count_ = 0;
         average_ = static_cast<Ty>(0);
         dispersion_ = static_cast<Ty>(0);
+        time_ = static_cast<Ty>(0);
     }
 
+
     operator Ty() noexcept {return dispersion_;}
 
+private:
+    Ty weight(Ty time) const noexcept {
+        Ty dt = time - time_;
+        return dt > static_cast<Ty>(0) ? static_cast<Ty>(1) - std::exp(-dt / tau_) : alpha_;
+    }
+
+    // West (1979) の逐次更新式
+    Ty update(Ty x, Ty alpha) noexcept {
+        Ty delta = x - average_;
+        Ty increment = alpha * delta;
+        average_ += increment;
+        dispersion_ = (static_cast<Ty>(1) - alpha) * (dispersion_ + delta * increment);
+        ++count_;
+        return dispersion_;
+    }
+
 private:
     Ty      dispersion_;
     Ty      average_;
+    Ty      time_;
+    Ty      tau_;
+    Ty      alpha_;
     size_t  count_;
 };
 
@@ -287,6 +794,49 @@ dispersion<Ty>& operator << (dispersion<Ty> &x, dispersion<Ty> y) noexcept {
 }
 
 
+template <class Ty>
+moments<Ty>& operator << (moments<Ty> &x, Ty y) noexcept {
+    x.add(y);
+    return x;
+}
+
+
+template <class Ty>
+moments<Ty>& operator << (moments<Ty> &x, moments<Ty> y) noexcept {
+    x.add(y);
+    return x;
+}
+
+
+template <class Ty>
+covariance<Ty>& operator << (covariance<Ty> &x, std::pair<Ty, Ty> y) noexcept {
+    x.add(y);
+    return x;
+}
+
+
+template <class Ty>
+covariance<Ty>& operator << (covariance<Ty> &x, covariance<Ty> y) noexcept {
+    x.add(y);
+    return x;
+}
+
+
+
+template <class Ty>
+ew_average<Ty>& operator << (ew_average<Ty> &x, Ty y) noexcept {
+    x.add(y);
+    return x;
+}
+
+
+template <class Ty>
+ew_dispersion<Ty>& operator << (ew_dispersion<Ty> &x, Ty y) noexcept {
+    x.add(y);
+    return x;
+}
+
+
 
 } // namespace online
 } // namespace gdv
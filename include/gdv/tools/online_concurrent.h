@@ -0,0 +1,263 @@
+/**
+* @file online_concurrent.h
+* @brief 複数のスレッドから同時に使えるオンライン集計クラスの宣言
+**/
+#ifndef GDV_ONLINE_CONCURRENT_H_
+#define GDV_ONLINE_CONCURRENT_H_
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <type_traits>
+#include <gdv/tools/online.h>
+
+namespace gdv {
+namespace online {
+
+namespace detail {
+
+constexpr size_t cache_line_size = 64;
+
+
+/**
+* @brief 呼び出したスレッドを識別する小さな整数を返します
+* @details 番号は最初の呼び出し時に順番に割り当てられるため、スレッドはシャードに均等に分散します
+**/
+inline size_t thread_slot() noexcept {
+    static std::atomic<size_t> next{0};
+    thread_local size_t slot = next.fetch_add(1, std::memory_order_relaxed);
+    return slot;
+}
+
+
+/**
+* @brief スレッドごとのシャードのスピンロックです (スレッドの数がシャードの数を超えた場合のみ競合します)
+**/
+inline void spin_lock(std::atomic<bool> &busy) noexcept {
+    while (busy.exchange(true, std::memory_order_acquire)) {
+        while (busy.load(std::memory_order_relaxed)) {std::this_thread::yield();}
+    }
+}
+
+
+inline void spin_unlock(std::atomic<bool> &busy) noexcept {
+    busy.store(false, std::memory_order_release);
+}
+
+
+template <class Ty>
+Ty atomic_update(std::atomic<Ty> &a, Ty x, bool(*replace)(Ty, Ty)) noexcept {
+    Ty now = a.load(std::memory_order_relaxed);
+    while (replace(x, now)) {
+        if (a.compare_exchange_weak(now, x, std::memory_order_relaxed)) { return x; }
+    }
+    return now;
+}
+
+} // namespace detail
+
+
+
+
+/**
+* @class concurrent_max
+* @brief ロックフリーの最大値です (最大値が増える場合のみCASを行います)
+**/
+template <class Ty>
+class concurrent_max {
+    static_assert(std::is_trivially_copyable<Ty>::value, "template parameter Ty must be trivially copyable.");
+
+public:
+    concurrent_max() noexcept :
+        max_{} {}
+
+    concurrent_max(Ty x) noexcept :
+        max_{x} {}
+
+    concurrent_max(const concurrent_max&) = delete;
+    concurrent_max& operator = (const concurrent_max&) = delete;
+
+public:
+    Ty add(Ty x) noexcept {
+        return detail::atomic_update<Ty>(max_, x, [](Ty a, Ty b) noexcept {return b < a;});
+    }
+
+    Ty add(max<Ty> x) noexcept {
+        return add(x.value());
+    }
+
+    Ty value() const noexcept {return max_.load(std::memory_order_relaxed);}
+
+    void clear() noexcept {
+        max_.store(static_cast<Ty>(0), std::memory_order_relaxed);
+    }
+
+    void reset(Ty x) noexcept {
+        max_.store(x, std::memory_order_relaxed);
+    }
+
+    operator Ty() const noexcept {return value();}
+
+private:
+    alignas(detail::cache_line_size) std::atomic<Ty> max_;
+};
+
+
+
+
+/**
+* @class concurrent_min
+* @brief ロックフリーの最小値です (最小値が減る場合のみCASを行います)
+**/
+template <class Ty>
+class concurrent_min {
+    static_assert(std::is_trivially_copyable<Ty>::value, "template parameter Ty must be trivially copyable.");
+
+public:
+    concurrent_min() noexcept :
+        min_{} {}
+
+    concurrent_min(Ty x) noexcept :
+        min_{x} {}
+
+    concurrent_min(const concurrent_min&) = delete;
+    concurrent_min& operator = (const concurrent_min&) = delete;
+
+public:
+    Ty add(Ty x) noexcept {
+        return detail::atomic_update<Ty>(min_, x, [](Ty a, Ty b) noexcept {return a < b;});
+    }
+
+    Ty add(min<Ty> x) noexcept {
+        return add(x.value());
+    }
+
+    Ty value() const noexcept {return min_.load(std::memory_order_relaxed);}
+
+    void clear() noexcept {
+        min_.store(static_cast<Ty>(0), std::memory_order_relaxed);
+    }
+
+    void reset(Ty x) noexcept {
+        min_.store(x, std::memory_order_relaxed);
+    }
+
+    operator Ty() const noexcept {return value();}
+
+private:
+    alignas(detail::cache_line_size) std::atomic<Ty> min_;
+};
+
+
+
+
+/**
+* @class sharded
+* @brief スレッドごとのAccumulatorのシャードに書き込み、読み出し時に結合します
+* @details 各スレッドはキャッシュラインに揃えた1つのシャードに固定されるため、
+*          シャードの数が書き込むスレッドの数以上であればシャードのロックは競合しません
+*          Accumulatorにはadd(Ty)、add(Accumulator)、size()、clear()が必要です
+**/
+template <class Accumulator>
+class sharded {
+public:
+    using accumulator_type = Accumulator;
+    using value_type = decltype(std::declval<const Accumulator&>().value());
+
+public:
+    sharded() :
+        sharded(std::thread::hardware_concurrency()) {}
+
+    explicit sharded(size_t shards) :
+        size_{shards ? shards : 1},
+        shards_{new shard[shards ? shards : 1]} {}
+
+    sharded(const sharded&) = delete;
+    sharded& operator = (const sharded&) = delete;
+
+public:
+    template <class Ty>
+    void add(Ty x) noexcept {
+        shard &s = shards_[detail::thread_slot() % size_];
+        lock(s);
+        s.acc.add(x);
+        unlock(s);
+    }
+
+    Accumulator value() const noexcept {
+        Accumulator result{};
+        for (size_t i = 0; i < size_; ++i) {
+            shard &s = shards_[i];
+            lock(s);
+            Accumulator acc = s.acc;
+            unlock(s);
+            if (acc.size() == 0) { continue; }
+            result.add(acc);
+        }
+        return result;
+    }
+
+    size_t size() const noexcept {return value().size();}
+
+    size_t shards() const noexcept {return size_;}
+
+    void clear() noexcept {
+        for (size_t i = 0; i < size_; ++i) {
+            shard &s = shards_[i];
+            lock(s);
+            s.acc.clear();
+            unlock(s);
+        }
+    }
+
+    operator value_type() const noexcept {return value().value();}
+
+private:
+    struct alignas(detail::cache_line_size) shard {
+        std::atomic<bool> busy{false};
+        Accumulator acc{};
+    };
+
+    static void lock(shard &s) noexcept {detail::spin_lock(s.busy);}
+
+    static void unlock(shard &s) noexcept {detail::spin_unlock(s.busy);}
+
+private:
+    size_t size_;
+    std::unique_ptr<shard[]> shards_;
+};
+
+
+template <class Ty>
+using concurrent_average = sharded<average<Ty>>;
+
+template <class Ty>
+using concurrent_dispersion = sharded<dispersion<Ty>>;
+
+
+
+
+template <class Ty>
+concurrent_max<Ty>& operator << (concurrent_max<Ty> &x, Ty y) noexcept {
+    x.add(y);
+    return x;
+}
+
+
+template <class Ty>
+concurrent_min<Ty>& operator << (concurrent_min<Ty> &x, Ty y) noexcept {
+    x.add(y);
+    return x;
+}
+
+
+template <class Accumulator, class Ty>
+sharded<Accumulator>& operator << (sharded<Accumulator> &x, Ty y) noexcept {
+    x.add(y);
+    return x;
+}
+
+} // namespace online
+} // namespace gdv
+
+#endif
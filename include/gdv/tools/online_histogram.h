@@ -0,0 +1,404 @@
+/**
+* @file online_histogram.h
+* @brief レイテンシ分布のための固定メモリの対数線形 (HDR形式) ヒストグラムの宣言
+**/
+#ifndef GDV_ONLINE_HISTOGRAM_H_
+#define GDV_ONLINE_HISTOGRAM_H_
+
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <memory>
+#include <thread>
+#include <type_traits>
+#include <stdint.h>
+#include <gdv/tools/online_concurrent.h>
+
+namespace gdv {
+namespace online {
+
+template <class Ty>
+class atomic_histogram;
+
+namespace detail {
+
+inline uint32_t msb(uint64_t x) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+    return 63u - static_cast<uint32_t>(__builtin_clzll(x));
+#else
+    uint32_t n = 0;
+    while (x >>= 1) { ++n; }
+    return n;
+#endif
+}
+
+
+/**
+* @class log_linear
+* @brief 値とバケットを相互に変換します
+* @details 2^precision未満の値はそのまま格納し、それ以上は2のべき乗ごとに2^(precision - 1)個の
+*          線形なバケットに分割するため、相対誤差は2^(1 - precision)以下になります
+**/
+class log_linear {
+public:
+    explicit log_linear(uint32_t precision) noexcept :
+        precision_{precision < 2 ? 2 : (precision > 16 ? 16 : precision)},
+        half_{uint64_t{1} << (precision_ - 1)} {}
+
+public:
+    size_t index(uint64_t x) const noexcept {
+        if (x < (half_ << 1)) { return static_cast<size_t>(x); }
+        uint32_t shift = msb(x) - (precision_ - 1);
+        return static_cast<size_t>(shift * half_ + (x >> shift));
+    }
+
+    uint64_t lowest(size_t i) const noexcept {
+        if (i < (half_ << 1)) { return i; }
+        uint64_t shift = i / half_ - 1;
+        return (i - shift * half_) << shift;
+    }
+
+    uint64_t highest(size_t i) const noexcept {
+        if (i < (half_ << 1)) { return i; }
+        uint64_t shift = i / half_ - 1;
+        return lowest(i) + ((uint64_t{1} << shift) - 1);
+    }
+
+    size_t size() const noexcept {return static_cast<size_t>((66 - precision_) * half_);}
+
+    uint32_t precision() const noexcept {return precision_;}
+
+private:
+    uint32_t precision_;
+    uint64_t half_;
+};
+
+} // namespace detail
+
+
+
+
+/**
+* @class histogram
+* @brief 符号なし整数のサンプル (ナノ秒等) をO(1)で記録し、バケットを走査して分位数を求めます
+* @details メモリはコンストラクタで1度だけ確保します。precisionが7の場合は約30KBで、相対誤差は1.6%以下です
+**/
+template <class Ty = uint64_t>
+class histogram {
+    static_assert(std::is_integral<Ty>::value, "template parameter Ty must be integral.");
+
+public:
+    explicit histogram(uint32_t precision = 7) :
+        buckets_{precision},
+        counts_{new uint64_t[buckets_.size()]()},
+        count_{},
+        min_{std::numeric_limits<uint64_t>::max()},
+        max_{} {}
+
+    histogram(const histogram &h) :
+        buckets_{h.buckets_},
+        counts_{new uint64_t[buckets_.size()]},
+        count_{h.count_},
+        min_{h.min_},
+        max_{h.max_} {
+        std::copy(h.counts_.get(), h.counts_.get() + buckets_.size(), counts_.get());
+    }
+
+    histogram& operator = (const histogram &h) {
+        if (this == &h) { return *this; }
+        if (buckets_.size() != h.buckets_.size()) {
+            counts_.reset(new uint64_t[h.buckets_.size()]);
+        }
+        buckets_ = h.buckets_;
+        std::copy(h.counts_.get(), h.counts_.get() + buckets_.size(), counts_.get());
+        count_ = h.count_;
+        min_ = h.min_;
+        max_ = h.max_;
+        return *this;
+    }
+
+public:
+    void add(Ty x) noexcept {
+        add(x, 1);
+    }
+
+    void add(Ty x, uint64_t n) noexcept {
+        uint64_t v = x < Ty{} ? 0 : static_cast<uint64_t>(x);
+        counts_[buckets_.index(v)] += n;
+        count_ += n;
+        min_ = v < min_ ? v : min_;
+        max_ = max_ < v ? v : max_;
+    }
+
+    void add(const histogram &h) noexcept {
+        if (h.count_ == 0) { return; }
+        if (buckets_.precision() == h.buckets_.precision()) {
+            for (size_t i = 0; i < buckets_.size(); ++i) { counts_[i] += h.counts_[i]; }
+            count_ += h.count_;
+        } else {
+            // 下限の値でバケットを割り当て直します (min_、max_は下でhから更新します)
+            for (size_t i = 0; i < h.buckets_.size(); ++i) {
+                if (h.counts_[i]) { counts_[buckets_.index(h.buckets_.lowest(i))] += h.counts_[i]; }
+            }
+            count_ += h.count_;
+        }
+        min_ = h.min_ < min_ ? h.min_ : min_;
+        max_ = max_ < h.max_ ? h.max_ : max_;
+    }
+
+    /**
+    * @brief サンプルの割合qがそれ以下となる値を返します
+    * @param[in] q 分位 ([0, 1])
+    **/
+    Ty quantile(double q) const noexcept {
+        if (count_ == 0) { return Ty{}; }
+        q = q < 0.0 ? 0.0 : (q > 1.0 ? 1.0 : q);
+        uint64_t rank = static_cast<uint64_t>(q * static_cast<double>(count_ - 1)) + 1;
+        uint64_t seen = 0;
+        for (size_t i = 0; i < buckets_.size(); ++i) {
+            seen += counts_[i];
+            if (seen >= rank) {
+                uint64_t v = buckets_.highest(i);
+                v = v < min_ ? min_ : (max_ < v ? max_ : v);
+                return static_cast<Ty>(v);
+            }
+        }
+        return static_cast<Ty>(max_);
+    }
+
+    Ty percentile(double p) const noexcept {return quantile(p / 100.0);}
+
+    double average() const noexcept {
+        if (count_ == 0) { return 0.0; }
+        double sum = 0.0;
+        for (size_t i = 0; i < buckets_.size(); ++i) {
+            if (counts_[i] == 0) { continue; }
+            double mid = 0.5 * (static_cast<double>(buckets_.lowest(i)) + static_cast<double>(buckets_.highest(i)));
+            sum += mid * static_cast<double>(counts_[i]);
+        }
+        return sum / static_cast<double>(count_);
+    }
+
+    Ty min() const noexcept {return count_ ? static_cast<Ty>(min_) : Ty{};}
+
+    Ty max() const noexcept {return static_cast<Ty>(max_);}
+
+    size_t size() const noexcept {return static_cast<size_t>(count_);}
+
+    uint32_t precision() const noexcept {return buckets_.precision();}
+
+    size_t buckets() const noexcept {return buckets_.size();}
+
+    uint64_t count(size_t bucket) const noexcept {return counts_[bucket];}
+
+    void clear() noexcept {
+        std::fill(counts_.get(), counts_.get() + buckets_.size(), uint64_t{});
+        count_ = 0;
+        min_ = std::numeric_limits<uint64_t>::max();
+        max_ = 0;
+    }
+
+private:
+    friend class atomic_histogram<Ty>;
+
+    detail::log_linear buckets_;
+    std::unique_ptr<uint64_t[]> counts_;
+    uint64_t count_;
+    uint64_t min_;
+    uint64_t max_;
+};
+
+
+
+
+/**
+* @class atomic_histogram
+* @brief 任意の数のスレッドからロックなしで記録できるヒストグラムです
+* @details 記録はバケットのカウンタへのrelaxedなfetch_addです。snapshot()はカウンタを通常のhistogramに複写します
+*          全スレッドが同じカウンタとmin/maxに書き込むため、頻度の高いバケットのキャッシュラインがコア間を往復します
+*          メモリの少ない代替であり、ホットパスではconcurrent_histogramを使ってください
+**/
+template <class Ty = uint64_t>
+class atomic_histogram {
+    static_assert(std::is_integral<Ty>::value, "template parameter Ty must be integral.");
+
+public:
+    explicit atomic_histogram(uint32_t precision = 7) :
+        buckets_{precision},
+        counts_{new std::atomic<uint64_t>[buckets_.size()]},
+        min_{std::numeric_limits<uint64_t>::max()},
+        max_{} {
+        for (size_t i = 0; i < buckets_.size(); ++i) { counts_[i].store(0, std::memory_order_relaxed); }
+    }
+
+    atomic_histogram(const atomic_histogram&) = delete;
+    atomic_histogram& operator = (const atomic_histogram&) = delete;
+
+public:
+    void add(Ty x) noexcept {
+        add(x, 1);
+    }
+
+    void add(Ty x, uint64_t n) noexcept {
+        uint64_t v = x < Ty{} ? 0 : static_cast<uint64_t>(x);
+        counts_[buckets_.index(v)].fetch_add(n, std::memory_order_relaxed);
+        update(v, v);
+    }
+
+    void add(const histogram<Ty> &h) noexcept {
+        if (h.count_ == 0) { return; }
+        for (size_t i = 0; i < h.buckets_.size(); ++i) {
+            if (h.counts_[i] == 0) { continue; }
+            size_t j = buckets_.precision() == h.buckets_.precision() ? i : buckets_.index(h.buckets_.lowest(i));
+            counts_[j].fetch_add(h.counts_[i], std::memory_order_relaxed);
+        }
+        update(h.min_, h.max_);
+    }
+
+    histogram<Ty> snapshot() const {
+        histogram<Ty> h{buckets_.precision()};
+        for (size_t i = 0; i < buckets_.size(); ++i) {
+            h.counts_[i] = counts_[i].load(std::memory_order_relaxed);
+            h.count_ += h.counts_[i];
+        }
+        h.min_ = min_.load(std::memory_order_relaxed);
+        h.max_ = max_.load(std::memory_order_relaxed);
+        return h;
+    }
+
+    void clear() noexcept {
+        for (size_t i = 0; i < buckets_.size(); ++i) { counts_[i].store(0, std::memory_order_relaxed); }
+        min_.store(std::numeric_limits<uint64_t>::max(), std::memory_order_relaxed);
+        max_.store(0, std::memory_order_relaxed);
+    }
+
+private:
+    void update(uint64_t lo, uint64_t hi) noexcept {
+        uint64_t m = min_.load(std::memory_order_relaxed);
+        while (lo < m && !min_.compare_exchange_weak(m, lo, std::memory_order_relaxed)) {}
+        m = max_.load(std::memory_order_relaxed);
+        while (m < hi && !max_.compare_exchange_weak(m, hi, std::memory_order_relaxed)) {}
+    }
+
+private:
+    detail::log_linear buckets_;
+    std::unique_ptr<std::atomic<uint64_t>[]> counts_;
+    std::atomic<uint64_t> min_;
+    std::atomic<uint64_t> max_;
+};
+
+
+
+
+/**
+* @class concurrent_histogram
+* @brief スレッドごとのヒストグラムのシャードに記録し、読み出し時に結合します
+* @details sharded<>と同様に各スレッドはキャッシュラインに揃えた自分のシャードに記録するため、
+*          シャードの数が書き込むスレッドの数以上であれば記録時に共有のキャッシュラインに触れません
+*          メモリはhistogramのshards倍です
+**/
+template <class Ty = uint64_t>
+class concurrent_histogram {
+    static_assert(std::is_integral<Ty>::value, "template parameter Ty must be integral.");
+
+public:
+    explicit concurrent_histogram(uint32_t precision = 7) :
+        concurrent_histogram(precision, std::thread::hardware_concurrency()) {}
+
+    concurrent_histogram(uint32_t precision, size_t shards) :
+        size_{shards ? shards : 1},
+        shards_{new shard[shards ? shards : 1]} {
+        for (size_t i = 0; i < size_; ++i) { shards_[i].hist = histogram<Ty>{precision}; }
+    }
+
+    concurrent_histogram(const concurrent_histogram&) = delete;
+    concurrent_histogram& operator = (const concurrent_histogram&) = delete;
+
+public:
+    void add(Ty x) noexcept {
+        add(x, 1);
+    }
+
+    void add(Ty x, uint64_t n) noexcept {
+        shard &s = local();
+        detail::spin_lock(s.busy);
+        s.hist.add(x, n);
+        detail::spin_unlock(s.busy);
+    }
+
+    void add(const histogram<Ty> &h) noexcept {
+        shard &s = local();
+        detail::spin_lock(s.busy);
+        s.hist.add(h);
+        detail::spin_unlock(s.busy);
+    }
+
+    histogram<Ty> snapshot() const {
+        histogram<Ty> h{shards_[0].hist.precision()};
+        for (size_t i = 0; i < size_; ++i) {
+            shard &s = shards_[i];
+            detail::spin_lock(s.busy);
+            h.add(s.hist);
+            detail::spin_unlock(s.busy);
+        }
+        return h;
+    }
+
+    size_t shards() const noexcept {return size_;}
+
+    void clear() noexcept {
+        for (size_t i = 0; i < size_; ++i) {
+            shard &s = shards_[i];
+            detail::spin_lock(s.busy);
+            s.hist.clear();
+            detail::spin_unlock(s.busy);
+        }
+    }
+
+private:
+    struct alignas(detail::cache_line_size) shard {
+        std::atomic<bool> busy{false};
+        histogram<Ty> hist{};
+    };
+
+    shard& local() const noexcept {return shards_[detail::thread_slot() % size_];}
+
+private:
+    size_t size_;
+    std::unique_ptr<shard[]> shards_;
+};
+
+
+
+
+template <class Ty>
+histogram<Ty>& operator << (histogram<Ty> &x, Ty y) noexcept {
+    x.add(y);
+    return x;
+}
+
+
+template <class Ty>
+histogram<Ty>& operator << (histogram<Ty> &x, const histogram<Ty> &y) noexcept {
+    x.add(y);
+    return x;
+}
+
+
+template <class Ty>
+atomic_histogram<Ty>& operator << (atomic_histogram<Ty> &x, Ty y) noexcept {
+    x.add(y);
+    return x;
+}
+
+
+template <class Ty>
+concurrent_histogram<Ty>& operator << (concurrent_histogram<Ty> &x, Ty y) noexcept {
+    x.add(y);
+    return x;
+}
+
+} // namespace online
+} // namespace gdv
+
+#endif
@@ -0,0 +1,422 @@
+/**
+* @file online_sketch.h
+* @brief 異なり数 (HyperLogLog) と頻度 (Count-Min、Space-Saving) を近似するスケッチの宣言
+**/
+#ifndef GDV_ONLINE_SKETCH_H_
+#define GDV_ONLINE_SKETCH_H_
+
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include <cmath>
+#include <stdint.h>
+#include <gdv/tools/online_histogram.h>
+
+namespace gdv {
+namespace online {
+
+namespace detail {
+
+// splitmix64の最終化関数です (多くの実装でstd::hashは整数に対して恒等関数のため)
+inline uint64_t mix64(uint64_t x) noexcept {
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ull;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebull;
+    x ^= x >> 31;
+    return x;
+}
+
+} // namespace detail
+
+
+
+
+/**
+* @class hyper_log_log
+* @brief 2^precisionバイトで異なり数を推定します (標準誤差 1.04 / sqrt(2^precision))
+**/
+template <class Key, class Hash = std::hash<Key>>
+class hyper_log_log {
+public:
+    explicit hyper_log_log(uint32_t precision = 14) :
+        precision_{precision < 4 ? 4 : (precision > 18 ? 18 : precision)},
+        registers_{new uint8_t[size_t{1} << precision_]()},
+        hash_{} {}
+
+    hyper_log_log(const hyper_log_log &h) :
+        precision_{h.precision_},
+        registers_{new uint8_t[h.size()]},
+        hash_{h.hash_} {
+        std::copy(h.registers_.get(), h.registers_.get() + h.size(), registers_.get());
+    }
+
+    hyper_log_log& operator = (const hyper_log_log &h) {
+        if (this == &h) { return *this; }
+        if (precision_ != h.precision_) {
+            registers_.reset(new uint8_t[h.size()]);
+            precision_ = h.precision_;
+        }
+        std::copy(h.registers_.get(), h.registers_.get() + h.size(), registers_.get());
+        hash_ = h.hash_;
+        return *this;
+    }
+
+public:
+    void add(const Key &key) noexcept {
+        add_hash(detail::mix64(static_cast<uint64_t>(hash_(key))));
+    }
+
+    void add_hash(uint64_t h) noexcept {
+        size_t i = static_cast<size_t>(h >> (64 - precision_));
+        uint64_t w = (h << precision_) | (uint64_t{1} << (precision_ - 1));
+        uint8_t rank = static_cast<uint8_t>(64 - detail::msb(w));
+        registers_[i] = registers_[i] < rank ? rank : registers_[i];
+    }
+
+    // レジスタごとの最大値です (バイト単位の単純なループのためベクトル化されます)
+    // precisionが異なる場合は*thisを変更せずにfalseを返します
+    bool add(const hyper_log_log &h) noexcept {
+        if (precision_ != h.precision_) { return false; }
+        uint8_t *r = registers_.get();
+        const uint8_t *s = h.registers_.get();
+        for (size_t i = 0; i < size(); ++i) { r[i] = r[i] < s[i] ? s[i] : r[i]; }
+        return true;
+    }
+
+    double value() const noexcept {
+        const double m = static_cast<double>(size());
+        double sum = 0.0;
+        size_t zeros = 0;
+        for (size_t i = 0; i < size(); ++i) {
+            sum += std::ldexp(1.0, -static_cast<int>(registers_[i]));
+            zeros += registers_[i] == 0;
+        }
+        double e = alpha(m) * m * m / sum;
+        if (e <= 2.5 * m && zeros) {
+            e = m * std::log(m / static_cast<double>(zeros));
+        }
+        return e;
+    }
+
+    size_t size() const noexcept {return size_t{1} << precision_;}
+
+    uint32_t precision() const noexcept {return precision_;}
+
+    void clear() noexcept {
+        std::fill(registers_.get(), registers_.get() + size(), uint8_t{});
+    }
+
+    operator double() const noexcept {return value();}
+
+private:
+    static double alpha(double m) noexcept {
+        if (m <= 16.0) { return 0.673; }
+        if (m <= 32.0) { return 0.697; }
+        if (m <= 64.0) { return 0.709; }
+        return 0.7213 / (1.0 + 1.079 / m);
+    }
+
+private:
+    uint32_t precision_;
+    std::unique_ptr<uint8_t[]> registers_;
+    Hash hash_;
+};
+
+
+
+
+/**
+* @class count_min
+* @brief 過小に数えることのない頻度の推定です
+* @details width x depth個のカウンタを行ごとに格納します。width = e / epsilon、depth = ln(1 / delta) とすると、
+*          確率 1 - delta で過大な分は epsilon * size() 未満になります
+**/
+template <class Key, class Hash = std::hash<Key>>
+class count_min {
+public:
+    explicit count_min(size_t width = 2048, size_t depth = 4) :
+        width_{width ? width : 1},
+        depth_{depth ? depth : 1},
+        counters_{new uint64_t[width_ * depth_]()},
+        count_{},
+        hash_{} {}
+
+    count_min(const count_min &c) :
+        width_{c.width_},
+        depth_{c.depth_},
+        counters_{new uint64_t[c.width_ * c.depth_]},
+        count_{c.count_},
+        hash_{c.hash_} {
+        std::copy(c.counters_.get(), c.counters_.get() + width_ * depth_, counters_.get());
+    }
+
+    count_min& operator = (const count_min &c) {
+        if (this == &c) { return *this; }
+        if (width_ * depth_ != c.width_ * c.depth_) {
+            counters_.reset(new uint64_t[c.width_ * c.depth_]);
+        }
+        width_ = c.width_;
+        depth_ = c.depth_;
+        std::copy(c.counters_.get(), c.counters_.get() + width_ * depth_, counters_.get());
+        count_ = c.count_;
+        hash_ = c.hash_;
+        return *this;
+    }
+
+public:
+    uint64_t add(const Key &key, uint64_t n = 1) noexcept {
+        uint64_t h = detail::mix64(static_cast<uint64_t>(hash_(key)));
+        uint64_t estimate = ~uint64_t{};
+        for (size_t d = 0; d < depth_; ++d) {
+            uint64_t &c = counters_[d * width_ + column(h, d)];
+            c += n;
+            estimate = c < estimate ? c : estimate;
+        }
+        count_ += n;
+        return estimate;
+    }
+
+    // widthまたはdepthが異なる場合は*thisを変更せずにfalseを返します
+    bool add(const count_min &c) noexcept {
+        if (width_ != c.width_ || depth_ != c.depth_) { return false; }
+        uint64_t *r = counters_.get();
+        const uint64_t *s = c.counters_.get();
+        for (size_t i = 0; i < width_ * depth_; ++i) { r[i] += s[i]; }
+        count_ += c.count_;
+        return true;
+    }
+
+    uint64_t value(const Key &key) const noexcept {
+        uint64_t h = detail::mix64(static_cast<uint64_t>(hash_(key)));
+        uint64_t estimate = ~uint64_t{};
+        for (size_t d = 0; d < depth_; ++d) {
+            uint64_t c = counters_[d * width_ + column(h, d)];
+            estimate = c < estimate ? c : estimate;
+        }
+        return estimate;
+    }
+
+    uint64_t size() const noexcept {return count_;}
+
+    size_t width() const noexcept {return width_;}
+
+    size_t depth() const noexcept {return depth_;}
+
+    void clear() noexcept {
+        std::fill(counters_.get(), counters_.get() + width_ * depth_, uint64_t{});
+        count_ = 0;
+    }
+
+private:
+    // Kirsch-Mitzenmacherの二重ハッシュです (1つの64bitハッシュから全ての行の位置を求めます)
+    size_t column(uint64_t h, size_t d) const noexcept {
+        uint64_t h1 = h & 0xffffffffull;
+        uint64_t h2 = h >> 32;
+        return static_cast<size_t>((h1 + d * h2) % width_);
+    }
+
+private:
+    size_t width_;
+    size_t depth_;
+    std::unique_ptr<uint64_t[]> counters_;
+    uint64_t count_;
+    Hash hash_;
+};
+
+
+
+
+/**
+* @class space_saving
+* @brief 最大capacity個のキーを監視して頻度の高い上位k個を求めます
+* @details 監視中のカウンタは最小ヒープで保持し、新しいキーは最小のカウンタを置き換えてその個数を誤差の上限として引き継ぎます
+*          1サンプルあたりO(log capacity)です
+**/
+template <class Key, class Hash = std::hash<Key>>
+class space_saving {
+public:
+    struct entry {
+        Key      key;
+        uint64_t count;
+        uint64_t error;
+    };
+
+public:
+    explicit space_saving(size_t capacity = 64) :
+        capacity_{capacity ? capacity : 1},
+        heap_{},
+        index_{} {
+        heap_.reserve(capacity_);
+        index_.reserve(capacity_);
+    }
+
+public:
+    void add(const Key &key, uint64_t n = 1) {
+        auto it = index_.find(key);
+        if (it != index_.end()) {
+            heap_[it->second].count += n;
+            down(it->second);
+            return;
+        }
+        if (heap_.size() < capacity_) {
+            heap_.push_back({key, n, 0});
+            index_.emplace(key, heap_.size() - 1);
+            up(heap_.size() - 1);
+            return;
+        }
+        entry &e = heap_.front();
+        index_.erase(e.key);
+        e.error = e.count;
+        e.count += n;
+        e.key = key;
+        index_.emplace(key, 0);
+        down(0);
+    }
+
+    // 監視されていないキーの個数は相手の最小値以下のため、片方にしかないキーには
+    // 相手の最小値を個数と誤差の両方に加えてから上位capacity個を残します
+    void add(const space_saving &s) {
+        const uint64_t ma = min_count();
+        const uint64_t mb = s.min_count();
+        std::vector<entry> merged;
+        merged.reserve(heap_.size() + s.heap_.size());
+        for (const entry &e : heap_) { merged.push_back({e.key, e.count + mb, e.error + mb}); }
+        for (const entry &e : s.heap_) {
+            auto it = index_.find(e.key);
+            if (it == index_.end()) {
+                merged.push_back({e.key, e.count + ma, e.error + ma});
+                continue;
+            }
+            entry &m = merged[it->second];
+            m.count = m.count - mb + e.count;
+            m.error = m.error - mb + e.error;
+        }
+
+        auto greater = [](const entry &a, const entry &b) {return b.count < a.count;};
+        if (merged.size() > capacity_) {
+            std::nth_element(merged.begin(), merged.begin() + (capacity_ - 1), merged.end(), greater);
+            merged.resize(capacity_);
+        }
+        std::make_heap(merged.begin(), merged.end(), greater);
+        heap_ = std::move(merged);
+        index_.clear();
+        for (size_t i = 0; i < heap_.size(); ++i) { index_.emplace(heap_[i].key, i); }
+    }
+
+    uint64_t value(const Key &key) const noexcept {
+        auto it = index_.find(key);
+        return it == index_.end() ? 0 : heap_[it->second].count;
+    }
+
+    std::vector<entry> top(size_t k) const {
+        std::vector<entry> result{heap_};
+        k = std::min(k, result.size());
+        std::partial_sort(result.begin(), result.begin() + k, result.end(),
+            [](const entry &a, const entry &b) {return b.count < a.count;});
+        result.resize(k);
+        return result;
+    }
+
+    size_t size() const noexcept {return heap_.size();}
+
+    size_t capacity() const noexcept {return capacity_;}
+
+    void clear() noexcept {
+        heap_.clear();
+        index_.clear();
+    }
+
+private:
+    // 監視されていないキーの個数の上限 (満杯でなければ0)
+    uint64_t min_count() const noexcept {
+        return heap_.size() < capacity_ ? 0 : heap_.front().count;
+    }
+
+    void swap(size_t i, size_t j) {
+        std::swap(heap_[i], heap_[j]);
+        index_[heap_[i].key] = i;
+        index_[heap_[j].key] = j;
+    }
+
+    void up(size_t i) {
+        while (i > 0) {
+            size_t p = (i - 1) / 2;
+            if (!(heap_[i].count < heap_[p].count)) { break; }
+            swap(i, p);
+            i = p;
+        }
+    }
+
+    void down(size_t i) {
+        for (;;) {
+            size_t l = 2 * i + 1;
+            size_t r = l + 1;
+            size_t m = i;
+            if (l < heap_.size() && heap_[l].count < heap_[m].count) { m = l; }
+            if (r < heap_.size() && heap_[r].count < heap_[m].count) { m = r; }
+            if (m == i) { break; }
+            swap(i, m);
+            i = m;
+        }
+    }
+
+private:
+    size_t capacity_;
+    std::vector<entry> heap_;
+    std::unordered_map<Key, size_t, Hash> index_;
+};
+
+
+
+
+template <class Key, class Hash>
+hyper_log_log<Key, Hash>& operator << (hyper_log_log<Key, Hash> &x, const Key &y) noexcept {
+    x.add(y);
+    return x;
+}
+
+
+// precisionが異なる場合は何もしません (結果が必要な場合はadd()を使ってください)
+template <class Key, class Hash>
+hyper_log_log<Key, Hash>& operator << (hyper_log_log<Key, Hash> &x, const hyper_log_log<Key, Hash> &y) noexcept {
+    x.add(y);
+    return x;
+}
+
+
+template <class Key, class Hash>
+count_min<Key, Hash>& operator << (count_min<Key, Hash> &x, const Key &y) noexcept {
+    x.add(y);
+    return x;
+}
+
+
+// widthまたはdepthが異なる場合は何もしません (結果が必要な場合はadd()を使ってください)
+template <class Key, class Hash>
+count_min<Key, Hash>& operator << (count_min<Key, Hash> &x, const count_min<Key, Hash> &y) noexcept {
+    x.add(y);
+    return x;
+}
+
+
+template <class Key, class Hash>
+space_saving<Key, Hash>& operator << (space_saving<Key, Hash> &x, const Key &y) {
+    x.add(y);
+    return x;
+}
+
+
+template <class Key, class Hash>
+space_saving<Key, Hash>& operator << (space_saving<Key, Hash> &x, const space_saving<Key, Hash> &y) {
+    x.add(y);
+    return x;
+}
+
+} // namespace online
+} // namespace gdv
+
+#endif
@@ -0,0 +1,457 @@
+/**
+* @file online_window.h
+* @brief 直近N個、または直近T時間のサンプルを対象とするスライディングウィンドウ集計クラスの宣言
+**/
+#ifndef GDV_ONLINE_WINDOW_H_
+#define GDV_ONLINE_WINDOW_H_
+
+#include <algorithm>
+#include <limits>
+#include <memory>
+#include <type_traits>
+#include <cmath>
+
+namespace gdv {
+namespace online {
+
+namespace detail {
+
+/**
+* @class ring
+* @brief 固定容量のリングバッファです (メモリの確保はコンストラクタのみで行います)
+**/
+template <class Ty>
+class ring {
+public:
+    explicit ring(size_t capacity) :
+        data_{new Ty[capacity ? capacity : 1]},
+        capacity_{capacity ? capacity : 1},
+        head_{},
+        size_{} {}
+
+    ring(const ring &r) :
+        ring(r.capacity_) {
+        *this = r;
+    }
+
+    ring& operator = (const ring &r) {
+        if (this == &r) { return *this; }
+        if (capacity_ != r.capacity_) {
+            data_.reset(new Ty[r.capacity_]);
+            capacity_ = r.capacity_;
+        }
+        head_ = 0;
+        size_ = r.size_;
+        for (size_t i = 0; i < size_; ++i) { data_[i] = r[i]; }
+        return *this;
+    }
+
+public:
+    void push_back(const Ty &x) noexcept {
+        size_t i = head_ + size_;
+        data_[i < capacity_ ? i : i - capacity_] = x;
+        ++size_;
+    }
+
+    void pop_front() noexcept {
+        if (++head_ == capacity_) { head_ = 0; }
+        --size_;
+    }
+
+    void pop_back() noexcept {--size_;}
+
+    Ty& front() noexcept {return data_[head_];}
+    const Ty& front() const noexcept {return data_[head_];}
+
+    Ty& back() noexcept {return (*this)[size_ - 1];}
+    const Ty& back() const noexcept {return (*this)[size_ - 1];}
+
+    Ty& operator[](size_t i) noexcept {
+        i += head_;
+        return data_[i < capacity_ ? i : i - capacity_];
+    }
+
+    const Ty& operator[](size_t i) const noexcept {
+        i += head_;
+        return data_[i < capacity_ ? i : i - capacity_];
+    }
+
+    size_t size() const noexcept {return size_;}
+    size_t capacity() const noexcept {return capacity_;}
+    bool empty() const noexcept {return size_ == 0;}
+    bool full() const noexcept {return size_ == capacity_;}
+
+    void clear() noexcept {
+        head_ = 0;
+        size_ = 0;
+    }
+
+private:
+    std::unique_ptr<Ty[]> data_;
+    size_t capacity_;
+    size_t head_;
+    size_t size_;
+};
+
+
+
+template <class Ty>
+struct sample {
+    Ty      value;
+    double  time;
+    size_t  index;
+};
+
+
+inline double endless() noexcept {return std::numeric_limits<double>::infinity();}
+
+
+
+/**
+* @class monotonic
+* @brief moving_maxとmoving_minで共有する単調キューです
+* @details Compare(a, b)は、aがウィンドウ内にある間bが答えになり得ない場合にtrueを返します
+**/
+template <class Ty, class Compare>
+class monotonic {
+    static_assert(std::is_integral<Ty>::value || std::is_floating_point<Ty>::value, "invalid template parameter.");
+
+public:
+    monotonic(size_t size, double span) :
+        deque_{size},
+        span_{span},
+        count_{} {}
+
+public:
+    Ty add(Ty x, double time) noexcept {
+        while (!deque_.empty() && Compare{}(x, deque_.back().value)) { deque_.pop_back(); }
+        while (!deque_.empty() && deque_.front().index + deque_.capacity() <= count_) { deque_.pop_front(); }
+        deque_.push_back({x, time, count_++});
+        expire(time);
+        return value();
+    }
+
+    void expire(double time) noexcept {
+        while (!deque_.empty() && deque_.front().time < time - span_) { deque_.pop_front(); }
+    }
+
+    Ty value() const noexcept {return deque_.empty() ? Ty{} : deque_.front().value;}
+
+    bool empty() const noexcept {return deque_.empty();}
+
+    size_t capacity() const noexcept {return deque_.capacity();}
+
+    void clear() noexcept {
+        deque_.clear();
+        count_ = 0;
+    }
+
+private:
+    ring<sample<Ty>> deque_;
+    double span_;
+    size_t count_;
+};
+
+
+template <class Ty>
+struct keep_max {
+    bool operator()(Ty x, Ty y) const noexcept {return !(x < y);}
+};
+
+template <class Ty>
+struct keep_min {
+    bool operator()(Ty x, Ty y) const noexcept {return !(y < x);}
+};
+
+} // namespace detail
+
+
+
+
+/**
+* @class moving_max
+* @brief 直近size個のサンプルの最大値です (1サンプルあたり償却O(1))
+**/
+template <class Ty>
+class moving_max {
+public:
+    explicit moving_max(size_t size) :
+        window_{size, detail::endless()} {}
+
+    moving_max(size_t size, double span) :
+        window_{size, span} {}
+
+public:
+    Ty add(Ty x) noexcept {return window_.add(x, 0.0);}
+
+    Ty add(Ty x, double time) noexcept {return window_.add(x, time);}
+
+    void expire(double time) noexcept {window_.expire(time);}
+
+    Ty value() const noexcept {return window_.value();}
+
+    size_t capacity() const noexcept {return window_.capacity();}
+
+    void clear() noexcept {window_.clear();}
+
+    operator Ty() const noexcept {return value();}
+
+private:
+    detail::monotonic<Ty, detail::keep_max<Ty>> window_;
+};
+
+
+
+
+/**
+* @class moving_min
+* @brief 直近size個のサンプルの最小値です (1サンプルあたり償却O(1))
+**/
+template <class Ty>
+class moving_min {
+public:
+    explicit moving_min(size_t size) :
+        window_{size, detail::endless()} {}
+
+    moving_min(size_t size, double span) :
+        window_{size, span} {}
+
+public:
+    Ty add(Ty x) noexcept {return window_.add(x, 0.0);}
+
+    Ty add(Ty x, double time) noexcept {return window_.add(x, time);}
+
+    void expire(double time) noexcept {window_.expire(time);}
+
+    Ty value() const noexcept {return window_.value();}
+
+    size_t capacity() const noexcept {return window_.capacity();}
+
+    void clear() noexcept {window_.clear();}
+
+    operator Ty() const noexcept {return value();}
+
+private:
+    detail::monotonic<Ty, detail::keep_min<Ty>> window_;
+};
+
+
+
+
+/**
+* @class moving_average
+* @brief ウィンドウ内のサンプルの平均値です
+* @details 平均値は逐次更新し、capacity回の削除ごとにバッファから計算し直すため丸め誤差が蓄積しません
+*          1サンプルあたり償却O(1)です
+**/
+template <class Ty>
+class moving_average {
+    static_assert(std::is_floating_point<Ty>::value, "template parameter Ty must be floating point.");
+
+public:
+    explicit moving_average(size_t size) :
+        samples_{size},
+        span_{detail::endless()},
+        average_{},
+        removed_{} {}
+
+    moving_average(size_t size, double span) :
+        samples_{size},
+        span_{span},
+        average_{},
+        removed_{} {}
+
+public:
+    Ty add(Ty x) noexcept {return add(x, 0.0);}
+
+    Ty add(Ty x, double time) noexcept {
+        if (samples_.full()) { remove(); }
+        samples_.push_back({x, time, 0});
+        average_ += (x - average_) / static_cast<Ty>(samples_.size());
+        expire(time);
+        return average_;
+    }
+
+    void expire(double time) noexcept {
+        while (!samples_.empty() && samples_.front().time < time - span_) { remove(); }
+    }
+
+    Ty value() const noexcept {return average_;}
+
+    size_t size() const noexcept {return samples_.size();}
+
+    size_t capacity() const noexcept {return samples_.capacity();}
+
+    void clear() noexcept {
+        samples_.clear();
+        average_ = static_cast<Ty>(0);
+        removed_ = 0;
+    }
+
+    operator Ty() const noexcept {return average_;}
+
+private:
+    void remove() noexcept {
+        Ty x = samples_.front().value;
+        samples_.pop_front();
+        if (samples_.empty()) {
+            average_ = static_cast<Ty>(0);
+            return;
+        }
+        average_ -= (x - average_) / static_cast<Ty>(samples_.size());
+        if (++removed_ >= samples_.capacity()) { recompute(); }
+    }
+
+    void recompute() noexcept {
+        Ty sum = static_cast<Ty>(0);
+        for (size_t i = 0; i < samples_.size(); ++i) { sum += samples_[i].value; }
+        average_ = sum / static_cast<Ty>(samples_.size());
+        removed_ = 0;
+    }
+
+private:
+    detail::ring<detail::sample<Ty>> samples_;
+    double  span_;
+    Ty      average_;
+    size_t  removed_;
+};
+
+
+
+
+/**
+* @class moving_dispersion
+* @brief ウィンドウ内のサンプルの母分散です (削除に対応したWelford法)
+* @details 平均値とM2はcapacity回の削除ごとにバッファから2パスで計算し直すため丸め誤差が蓄積しません
+*          計算し直すまでの間、M2は0未満にならないよう切り詰めます
+**/
+template <class Ty>
+class moving_dispersion {
+    static_assert(std::is_floating_point<Ty>::value, "template parameter Ty must be floating point.");
+
+public:
+    explicit moving_dispersion(size_t size) :
+        samples_{size},
+        span_{detail::endless()},
+        m2_{},
+        average_{},
+        removed_{} {}
+
+    moving_dispersion(size_t size, double span) :
+        samples_{size},
+        span_{span},
+        m2_{},
+        average_{},
+        removed_{} {}
+
+public:
+    Ty add(Ty x) noexcept {return add(x, 0.0);}
+
+    Ty add(Ty x, double time) noexcept {
+        if (samples_.full()) { remove(); }
+        samples_.push_back({x, time, 0});
+        Ty delta = x - average_;
+        average_ += delta / static_cast<Ty>(samples_.size());
+        m2_ += delta * (x - average_);
+        expire(time);
+        return value();
+    }
+
+    void expire(double time) noexcept {
+        while (!samples_.empty() && samples_.front().time < time - span_) { remove(); }
+    }
+
+    Ty value() const noexcept {
+        return samples_.empty() ? static_cast<Ty>(0) : m2_ / static_cast<Ty>(samples_.size());
+    }
+
+    Ty average() const noexcept {return average_;}
+
+    size_t size() const noexcept {return samples_.size();}
+
+    size_t capacity() const noexcept {return samples_.capacity();}
+
+    void clear() noexcept {
+        samples_.clear();
+        average_ = static_cast<Ty>(0);
+        m2_ = static_cast<Ty>(0);
+        removed_ = 0;
+    }
+
+    operator Ty() const noexcept {return value();}
+
+private:
+    void remove() noexcept {
+        Ty x = samples_.front().value;
+        samples_.pop_front();
+        if (samples_.empty()) {
+            average_ = static_cast<Ty>(0);
+            m2_ = static_cast<Ty>(0);
+            return;
+        }
+        Ty delta = x - average_;
+        average_ -= delta / static_cast<Ty>(samples_.size());
+        m2_ = std::max(m2_ - delta * (x - average_), static_cast<Ty>(0));
+        if (++removed_ >= samples_.capacity()) { recompute(); }
+    }
+
+    void recompute() noexcept {
+        const Ty n = static_cast<Ty>(samples_.size());
+        Ty sum = static_cast<Ty>(0);
+        for (size_t i = 0; i < samples_.size(); ++i) { sum += samples_[i].value; }
+        average_ = sum / n;
+        Ty m2 = static_cast<Ty>(0);
+        for (size_t i = 0; i < samples_.size(); ++i) {
+            Ty d = samples_[i].value - average_;
+            m2 += d * d;
+        }
+        m2_ = m2;
+        removed_ = 0;
+    }
+
+private:
+    detail::ring<detail::sample<Ty>> samples_;
+    double  span_;
+    Ty      m2_;
+    Ty      average_;
+    size_t  removed_;
+};
+
+
+
+
+
+
+
+
+template <class Ty>
+moving_max<Ty>& operator << (moving_max<Ty> &x, Ty y) noexcept {
+    x.add(y);
+    return x;
+}
+
+
+template <class Ty>
+moving_min<Ty>& operator << (moving_min<Ty> &x, Ty y) noexcept {
+    x.add(y);
+    return x;
+}
+
+
+template <class Ty>
+moving_average<Ty>& operator << (moving_average<Ty> &x, Ty y) noexcept {
+    x.add(y);
+    return x;
+}
+
+
+template <class Ty>
+moving_dispersion<Ty>& operator << (moving_dispersion<Ty> &x, Ty y) noexcept {
+    x.add(y);
+    return x;
+}
+
+} // namespace online
+} // namespace gdv
+
+#endif
@@ -0,0 +1,62 @@
+/**
+* @file parallel.h
+* @brief 一括処理の関数で使う最小限のfork/joinの補助関数の宣言
+**/
+#ifndef GDV_PARALLEL_H_
+#define GDV_PARALLEL_H_
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+namespace gdv {
+namespace detail {
+
+// スコープを抜けるときに起動済みのスレッドをjoinします
+// std::threadのコンストラクタや呼び出し元スレッドのfが例外を投げても、joinable なスレッドを破棄しません
+struct thread_joiner {
+    std::vector<std::thread> &pool;
+
+    ~thread_joiner() {
+        for (std::thread &t : pool) {
+            if (t.joinable()) { t.join(); }
+        }
+    }
+};
+
+} // namespace detail
+
+
+/**
+* @brief [0, n) を連続した区間に分割し、それぞれについてf(first, last)を呼び出します
+* @param[in] n       要素の数
+* @param[in] threads スレッド数 (0でhardware_concurrency、1で呼び出し元のスレッドのみ)
+* @param[in] grain   1スレッドに割り当てる最小の要素数 (区間の大きさもこの倍数に丸めます)
+* @details 最初の区間は呼び出し元のスレッドで処理し、残りのスレッドをjoinします
+*          スレッドの起動で例外が発生した場合は、起動済みのスレッドをjoinしてから例外を伝播します
+**/
+template <class Function>
+void parallel_for(size_t n, size_t threads, Function f, size_t grain = 1024) {
+    if (threads == 0) { threads = std::max<size_t>(std::thread::hardware_concurrency(), 1); }
+    grain = std::max<size_t>(grain, 1);
+    threads = std::min(threads, (n + grain - 1) / grain);
+    if (threads <= 1) {
+        f(size_t{0}, n);
+        return;
+    }
+
+    size_t chunk = (n + threads - 1) / threads;
+    chunk = (chunk + grain - 1) / grain * grain;
+
+    std::vector<std::thread> pool;
+    pool.reserve(threads - 1);
+    detail::thread_joiner joiner{pool};
+    for (size_t first = chunk; first < n; first += chunk) {
+        pool.emplace_back(f, first, std::min(first + chunk, n));
+    }
+    f(size_t{0}, std::min(chunk, n));
+}
+
+} // namespace gdv
+
+#endif
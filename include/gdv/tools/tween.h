@@ -3,6 +3,7 @@
 
 #include <cmath>
 #include <gdv/constant.h>
+#include <gdv/math/fast_math.h>
 #include <gdv/math/vector2.h>
 #include <gdv/math/vector3.h>
 #include <gdv/math/vector4.h>
@@ -11,6 +12,8 @@ namespace gdv {
 
 namespace tween {
 
+// sine, exp, elasticの各関数は、テンプレート引数 Math に fast_math を指定すると近似関数で計算します
+
 template <class Ty>
 Ty linear(Ty begin, Ty end, Ty ratio) noexcept {
     return (end - begin) * ratio + begin;
@@ -142,27 +145,27 @@ Ty out_in_quint(Ty begin, Ty end, Ty ratio) noexcept {
 
 
 
-template <class Ty>
+template <class Ty, class Math = std_math>
 Ty in_sine(Ty begin, Ty end, Ty ratio) noexcept {
-    return (begin - end) * cos(pi<Ty> * ratio) + end;
+    return (begin - end) * Math::cos(pi<Ty> * ratio) + end;
 }
 
-template <class Ty>
+template <class Ty, class Math = std_math>
 Ty out_sine(Ty begin, Ty end, Ty ratio) noexcept {
-    return (end - begin) * sin(pi<Ty> * ratio) + begin;
+    return (end - begin) * Math::sin(pi<Ty> * ratio) + begin;
 }
 
-template <class Ty>
+template <class Ty, class Math = std_math>
 Ty in_out_sine(Ty begin, Ty end, Ty ratio) noexcept {
-    return (begin - end) / static_cast<Ty>(2) * (cos(pi<Ty> * ratio) - static_cast<Ty>(1)) + begin;
+    return (begin - end) / static_cast<Ty>(2) * (Math::cos(pi<Ty> * ratio) - static_cast<Ty>(1)) + begin;
 }
 
-template <class Ty>
+template <class Ty, class Math = std_math>
 Ty out_in_sine(Ty begin, Ty end, Ty ratio) noexcept {
     if (ratio < static_cast<Ty>(0.5)) {
-        return out_sine(begin, end, ratio * static_cast<Ty>(2)) * static_cast<Ty>(0.5);
+        return out_sine<Ty, Math>(begin, end, ratio * static_cast<Ty>(2)) * static_cast<Ty>(0.5);
     }
-    return (in_sine(begin, end, ratio * static_cast<Ty>(2)) + (end - begin)) * static_cast<Ty>(0.5);
+    return (in_sine<Ty, Math>(begin, end, ratio * static_cast<Ty>(2)) + (end - begin)) * static_cast<Ty>(0.5);
 }
 
 
@@ -170,30 +173,30 @@ Ty out_in_sine(Ty begin, Ty end, Ty ratio) noexcept {
 
 
 
-template <class Ty>
+template <class Ty, class Math = std_math>
 Ty in_exp(Ty begin, Ty end, Ty ratio) noexcept {
-    return (end - begin) * std::pow(static_cast<Ty>(2), static_cast<Ty>(10) * (ratio - 1)) + begin;
+    return (end - begin) * Math::exp2(static_cast<Ty>(10) * (ratio - 1)) + begin;
 }
 
-template <class Ty>
+template <class Ty, class Math = std_math>
 Ty out_exp(Ty begin, Ty end, Ty ratio) noexcept {
-    return (end - begin) * (static_cast<Ty>(1) - std::pow(static_cast<Ty>(2), static_cast<Ty>(-10) * ratio)) + begin;
+    return (end - begin) * (static_cast<Ty>(1) - Math::exp2(static_cast<Ty>(-10) * ratio)) + begin;
 }
 
-template <class Ty>
+template <class Ty, class Math = std_math>
 Ty in_out_exp(Ty begin, Ty end, Ty ratio) noexcept {
     if (ratio < static_cast<Ty>(0.5)) {
-        return in_exp(begin, end, ratio * static_cast<Ty>(2)) * static_cast<Ty>(0.5);
+        return in_exp<Ty, Math>(begin, end, ratio * static_cast<Ty>(2)) * static_cast<Ty>(0.5);
     }
-    return (out_exp(begin, end, ratio * static_cast<Ty>(2)) + (end - begin)) * static_cast<Ty>(0.5);
+    return (out_exp<Ty, Math>(begin, end, ratio * static_cast<Ty>(2)) + (end - begin)) * static_cast<Ty>(0.5);
 }
 
-template <class Ty>
+template <class Ty, class Math = std_math>
 Ty out_in_exp(Ty begin, Ty end, Ty ratio) noexcept {
     if (ratio < static_cast<Ty>(0.5)) {
-        return out_exp(begin, end, ratio * static_cast<Ty>(2)) * static_cast<Ty>(0.5);
+        return out_exp<Ty, Math>(begin, end, ratio * static_cast<Ty>(2)) * static_cast<Ty>(0.5);
     }
-    return (in_exp(begin, end, ratio * static_cast<Ty>(2)) + (end - begin)) * static_cast<Ty>(0.5);
+    return (in_exp<Ty, Math>(begin, end, ratio * static_cast<Ty>(2)) + (end - begin)) * static_cast<Ty>(0.5);
 }
 
 
@@ -263,30 +266,30 @@ Ty out_in_back(Ty begin, Ty end, Ty ratio, Ty overshoot) noexcept {
 
 
 
-template <class Ty>
+template <class Ty, class Math = std_math>
 Ty in_elastic(Ty begin, Ty end, Ty ratio) noexcept {
-    return (end - begin) * sin(static_cast<Ty>(13) * pi<Ty> * ratio) * pow(static_cast<Ty>(2), static_cast<Ty>(10) * (ratio - static_cast<Ty>(1))) + begin;
+    return (end - begin) * Math::sin(static_cast<Ty>(13) * pi<Ty> * ratio) * Math::exp2(static_cast<Ty>(10) * (ratio - static_cast<Ty>(1))) + begin;
 }
 
-template <class Ty>
+template <class Ty, class Math = std_math>
 float out_elastic(Ty begin, Ty end, Ty ratio) noexcept {
-    return (end - begin) * sin(static_cast<Ty>(13) * pi<Ty> * ratio) * pow(static_cast<Ty>(2), static_cast<Ty>(-10) * ratio) + begin;
+    return (end - begin) * Math::sin(static_cast<Ty>(13) * pi<Ty> * ratio) * Math::exp2(static_cast<Ty>(-10) * ratio) + begin;
 }
 
-template <class Ty>
+template <class Ty, class Math = std_math>
 float in_out_elastic(Ty begin, Ty end, Ty ratio) noexcept {
     if (ratio < static_cast<Ty>(0.5)) {
-        return in_elastic(begin, end, ratio * static_cast<Ty>(2)) * static_cast<Ty>(0.5);
+        return in_elastic<Ty, Math>(begin, end, ratio * static_cast<Ty>(2)) * static_cast<Ty>(0.5);
     }
-    return (out_elastic(begin, end, ratio * static_cast<Ty>(2)) + (end - begin)) * static_cast<Ty>(0.5);
+    return (out_elastic<Ty, Math>(begin, end, ratio * static_cast<Ty>(2)) + (end - begin)) * static_cast<Ty>(0.5);
 }
 
-template <class Ty>
+template <class Ty, class Math = std_math>
 float out_in_elastic(Ty begin, Ty end, Ty ratio) noexcept {
     if (ratio < static_cast<Ty>(0.5)) {
-        return out_elastic(begin, end, ratio * static_cast<Ty>(2)) * static_cast<Ty>(0.5);
+        return out_elastic<Ty, Math>(begin, end, ratio * static_cast<Ty>(2)) * static_cast<Ty>(0.5);
     }
-    return (in_elastic(begin, end, ratio * static_cast<Ty>(2)) + (end - begin)) * static_cast<Ty>(0.5);
+    return (in_elastic<Ty, Math>(begin, end, ratio * static_cast<Ty>(2)) + (end - begin)) * static_cast<Ty>(0.5);
 }
 
 
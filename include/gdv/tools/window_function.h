@@ -3,29 +3,31 @@
 
 #include <cmath>
 #include <gdv/constant.h>
+#include <gdv/math/fast_math.h>
 
 namespace gdv {
 
+// 三角関数等を使う窓関数は、テンプレート引数 Math に fast_math を指定すると近似関数で計算します
 
-template <class Ty>
+template <class Ty, class Math = std_math>
 Ty hann(Ty x) {
     static constexpr Ty half = static_cast<Ty>(0.5);
-    return half - half * std::cos(static_cast<Ty>(2) * pi<Ty> * x);
+    return half - half * Math::cos(static_cast<Ty>(2) * pi<Ty> * x);
 }
 
 
-template <class Ty>
+template <class Ty, class Math = std_math>
 Ty hamming(Ty x) {
-    return static_cast<Ty>(0.54) - static_cast<Ty>(0.46) * std::cos(static_cast<Ty>(2) * pi<Ty> * x);
+    return static_cast<Ty>(0.54) - static_cast<Ty>(0.46) * Math::cos(static_cast<Ty>(2) * pi<Ty> * x);
 }
 
 
 
-template <class Ty>
+template <class Ty, class Math = std_math>
 Ty blackman(Ty x) {
     return static_cast<Ty>(0.42) 
-        - static_cast<Ty>(0.5) * std::cos(static_cast<Ty>(2) * pi<Ty> * x) 
-        + static_cast<Ty>(0.08) * std::cos(static_cast<Ty>(4) * pi<Ty> * x);
+        - static_cast<Ty>(0.5) * Math::cos(static_cast<Ty>(2) * pi<Ty> * x) 
+        + static_cast<Ty>(0.08) * Math::cos(static_cast<Ty>(4) * pi<Ty> * x);
 }
 
 
@@ -35,56 +37,56 @@ Ty bartlett(Ty x) {
 }
 
 
-template <class Ty>
+template <class Ty, class Math = std_math>
 Ty gauss(Ty x, Ty deviation) {
-    return std::exp(-(x * x) / (deviation * deviation));
+    return Math::exp(-(x * x) / (deviation * deviation));
 }
 
 
-template <class Ty>
+template <class Ty, class Math = std_math>
 Ty bartlett_hann(Ty x) {
     return static_cast<Ty>(0.64)
         - static_cast<Ty>(0.48) * std::abs(x - static_cast<Ty>(0.5))
-        - static_cast<Ty>(0.38) * std::cos(static_cast<Ty>(2) * pi<Ty> * x);
+        - static_cast<Ty>(0.38) * Math::cos(static_cast<Ty>(2) * pi<Ty> * x);
 }
 
 
-template <class Ty>
+template <class Ty, class Math = std_math>
 Ty nuttall(Ty x) {
     return static_cast<Ty>(0.355768) 
-        + static_cast<Ty>(0.487396) * std::cos(static_cast<Ty>(4) * pi<Ty> * x)
-        - static_cast<Ty>(0.012604) * std::cos(static_cast<Ty>(6) * pi<Ty> * x);
+        + static_cast<Ty>(0.487396) * Math::cos(static_cast<Ty>(4) * pi<Ty> * x)
+        - static_cast<Ty>(0.012604) * Math::cos(static_cast<Ty>(6) * pi<Ty> * x);
 }
 
 
 
-template <class Ty>
+template <class Ty, class Math = std_math>
 Ty blackman_harris(Ty x) {
     return static_cast<Ty>(0.35875) 
-        - static_cast<Ty>(0.48829) * std::cos(static_cast<Ty>(2) * pi<Ty> * x)
-        + static_cast<Ty>(0.14128) * std::cos(static_cast<Ty>(4) * pi<Ty> * x)
-        - static_cast<Ty>(0.01168) * std::cos(static_cast<Ty>(6) * pi<Ty> * x);
+        - static_cast<Ty>(0.48829) * Math::cos(static_cast<Ty>(2) * pi<Ty> * x)
+        + static_cast<Ty>(0.14128) * Math::cos(static_cast<Ty>(4) * pi<Ty> * x)
+        - static_cast<Ty>(0.01168) * Math::cos(static_cast<Ty>(6) * pi<Ty> * x);
 }
 
 
 
-template <class Ty>
+template <class Ty, class Math = std_math>
 Ty blackman_nuttall(Ty x) {
     return static_cast<Ty>(0.3635819) 
-        - static_cast<Ty>(0.4891775) * std::cos(static_cast<Ty>(2) * pi<Ty> * x)
-        + static_cast<Ty>(0.1365995) * std::cos(static_cast<Ty>(4) * pi<Ty> * x)
-        - static_cast<Ty>(0.0106411) * std::cos(static_cast<Ty>(6) * pi<Ty> * x);
+        - static_cast<Ty>(0.4891775) * Math::cos(static_cast<Ty>(2) * pi<Ty> * x)
+        + static_cast<Ty>(0.1365995) * Math::cos(static_cast<Ty>(4) * pi<Ty> * x)
+        - static_cast<Ty>(0.0106411) * Math::cos(static_cast<Ty>(6) * pi<Ty> * x);
 }
 
 
 
-template <class Ty>
+template <class Ty, class Math = std_math>
 Ty flat_top(Ty x) {
     return static_cast<Ty>(1) 
-        - static_cast<Ty>(1.93)  * std::cos(static_cast<Ty>(2) * pi<Ty> * x)
-        + static_cast<Ty>(1.29)  * std::cos(static_cast<Ty>(4) * pi<Ty> * x)
-        - static_cast<Ty>(0.388) * std::cos(static_cast<Ty>(6) * pi<Ty> * x)
-        + static_cast<Ty>(0.032) * std::cos(static_cast<Ty>(8) * pi<Ty> * x);
+        - static_cast<Ty>(1.93)  * Math::cos(static_cast<Ty>(2) * pi<Ty> * x)
+        + static_cast<Ty>(1.29)  * Math::cos(static_cast<Ty>(4) * pi<Ty> * x)
+        - static_cast<Ty>(0.388) * Math::cos(static_cast<Ty>(6) * pi<Ty> * x)
+        + static_cast<Ty>(0.032) * Math::cos(static_cast<Ty>(8) * pi<Ty> * x);
 }
 
 
@@ -97,30 +99,30 @@ Ty parzen(Ty x) {
 }
 
 
-template <class Ty>
+template <class Ty, class Math = std_math>
 Ty akaike(Ty x) {
     return static_cast<Ty>(0.625) 
-        + static_cast<Ty>(0.5) * std::cos(static_cast<Ty>(2) * pi<Ty> * x)
-        - static_cast<Ty>(0.125) * std::cos(static_cast<Ty>(4) * pi<Ty> * x);
+        + static_cast<Ty>(0.5) * Math::cos(static_cast<Ty>(2) * pi<Ty> * x)
+        - static_cast<Ty>(0.125) * Math::cos(static_cast<Ty>(4) * pi<Ty> * x);
 }
 
 
-template <class Ty>
+template <class Ty, class Math = std_math>
 Ty sine(Ty x) {
-    return std::sin(pi<Ty> * x);
+    return Math::sin(pi<Ty> * x);
 }
 
 
-template <class Ty>
+template <class Ty, class Math = std_math>
 Ty vorbis(Ty x) {
-    return std::sin(pi<Ty> / static_cast<Ty>(2) * std::pow(std::sin(pi<Ty> * x), 2));
+    return Math::sin(pi<Ty> / static_cast<Ty>(2) * std::pow(Math::sin(pi<Ty> * x), 2));
 }
 
 
 
-template <class Ty>
+template <class Ty, class Math = std_math>
 Ty lanczos(Ty x, Ty n) {
-    return (std::sin(pi<Ty> * x) / (pi<Ty> * x)) * (std::sin(pi<Ty> * (x / n)) / (pi<Ty> * (x / n)));
+    return (Math::sin(pi<Ty> * x) / (pi<Ty> * x)) * (Math::sin(pi<Ty> * (x / n)) / (pi<Ty> * (x / n)));
 }
 
 